@@ -0,0 +1,158 @@
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "rsa/container.hpp"
+#include "rsa/hash.hpp"
+#include "rsa/random.hpp"
+#include "rsa/rsa.hpp"
+
+// Benchmark of the hot paths, also the training workload of the PGO build (see README)
+// "rsa-bench [scale]" repeats every workload 'scale' times, 1 by default
+
+namespace {
+    // Keys of the sizes the benchmark covers: a toy key, a ~40 bit and a ~62 bit modulus
+    struct KeyPair {
+        Key::Public publicKey {};
+        Key::Private privateKey {};
+    };
+
+    KeyPair makeKeys(long long int p, long long int q) {
+        const long long int e { 65537 };
+        const long long int d { *Utility::Math::modInverse(e, (p - 1) * (q - 1)) };
+        return KeyPair { Key::Public { p * q, e }, Key::Private { p, q, d } };
+    }
+
+    template <typename Work>
+    void measure(const std::string& name, size_t operations, Work&& work) {
+        const auto start { std::chrono::steady_clock::now() };
+        work();
+        const double seconds { std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() };
+        std::cout << name << ": " << seconds * 1e9 / static_cast<double>(operations) << " ns per operation\n";
+    }
+}
+
+int main(int argc, char* argv[]) {
+    const size_t scale { argc > 1 ? static_cast<size_t>(std::stoul(argv[1])) : 1 };
+    std::mt19937_64 random { 1 };
+    volatile long long int sink {};
+
+    const std::vector<KeyPair> keys { makeKeys(1021, 1019), makeKeys(1000003, 1000033), makeKeys(2147483647, 2147483629) };
+
+    for (const KeyPair& pair : keys) {
+        const Key::CRT crtKey { *Generate::crt(pair.privateKey) };
+        const std::string label { "n=" + std::to_string(pair.publicKey.n) };
+
+        std::vector<long long int> messages(20000 * scale);
+        for (long long int& m : messages)
+            m = static_cast<long long int>(random() % static_cast<unsigned long long int>(pair.publicKey.n));
+
+        std::vector<long long int> ciphertexts(messages.size());
+        measure("encode " + label, messages.size(), [&] {
+            for (size_t i { 0 }; i < messages.size(); ++i)
+                ciphertexts[i] = encode(pair.publicKey, messages[i]);
+        });
+        measure("decode " + label, messages.size(), [&] {
+            for (const long long int c : ciphertexts)
+                sink = sink + decode(pair.publicKey, pair.privateKey, c);
+        });
+        measure("decode (CRT) " + label, messages.size(), [&] {
+            for (const long long int c : ciphertexts)
+                sink = sink + decode(crtKey, c);
+        });
+    }
+
+    for (size_t windowBits { 1 }; windowBits <= 6; ++windowBits) {
+        const size_t operations { 20000 * scale };
+        measure("modPower window " + std::to_string(windowBits), operations, [&] {
+            for (size_t i { 0 }; i < operations; ++i) {
+                const long long int modulus { static_cast<long long int>(random() >> 2) | 1 };
+                sink = sink + Utility::Math::modPower(static_cast<long long int>(random() >> 2), static_cast<long long int>(random() >> 2), modulus, windowBits);
+            }
+        });
+    }
+
+    // Random bytes in the sizes padding asks for: 32 byte OAEP seeds and PSS salts
+    {
+        const size_t operations { 200000 * scale };
+        unsigned char seed[32];
+        measure("random 32 bytes", operations, [&] {
+            for (size_t i { 0 }; i < operations; ++i) {
+                Utility::Random::fill(seed, sizeof(seed));
+                sink = sink + seed[0];
+            }
+        });
+    }
+
+    // Random 31 bit primes of every kind
+    for (const auto& [name, kind] : { std::pair { "ordinary", Generate::PrimeKind::Ordinary }, std::pair { "safe", Generate::PrimeKind::Safe }, std::pair { "strong", Generate::PrimeKind::Strong } }) {
+        const size_t operations { 200 * scale };
+        measure(std::string { name } + " prime 31 bits", operations, [&] {
+            for (size_t i { 0 }; i < operations; ++i)
+                sink = sink + *Generate::randomPrime(31, kind);
+        });
+    }
+
+    // Padded encryption and signatures with a 2048 bit key
+    {
+        const Generate::WideKeyPair wide { *Generate::randomWideKeyPair(2048) };
+        const Key::Wide::CRT crtKey { *Generate::crt(wide.privateKey) };
+        const Utility::Bytes message(32, 0x5a);
+        const size_t operations { 200 * scale };
+
+        for (const auto& [name, scheme] : { std::pair { "OAEP", Padding::Scheme::OAEP }, std::pair { "PKCS1", Padding::Scheme::PKCS1 } }) {
+            std::vector<Utility::Bytes> ciphertexts(operations);
+            measure(std::string { "encrypt " } + name + " 2048 bits", operations, [&] {
+                for (Utility::Bytes& ciphertext : ciphertexts)
+                    ciphertext = *encrypt(wide.publicKey, message, scheme);
+            });
+            measure(std::string { "decrypt " } + name + " 2048 bits", operations, [&] {
+                for (const Utility::Bytes& ciphertext : ciphertexts)
+                    if (decrypt(crtKey, ciphertext, scheme) != message)
+                        std::exit(1);
+            });
+        }
+
+        const Utility::Bytes digest { Hash::sha256(message) };
+        for (const auto& [name, scheme] : { std::pair { "PKCS1", Padding::Signature::Scheme::PKCS1 }, std::pair { "PSS", Padding::Signature::Scheme::PSS } }) {
+            std::vector<Utility::Bytes> signatures(operations);
+            measure(std::string { "sign " } + name + " 2048 bits", operations, [&] {
+                for (Utility::Bytes& signature : signatures)
+                    signature = *sign(crtKey, digest, scheme);
+            });
+            measure(std::string { "verify " } + name + " 2048 bits", operations, [&] {
+                for (const Utility::Bytes& signature : signatures)
+                    if (!verify(wide.publicKey, digest, signature, scheme))
+                        std::exit(1);
+            });
+        }
+    }
+
+    // Container round trip in memory, 4 MiB per repetition
+    const KeyPair& containerKeys { keys[1] };
+    std::string plaintext(4 << 20, '\0');
+    for (char& byte : plaintext)
+        byte = static_cast<char>(random());
+
+    for (size_t i { 0 }; i < scale; ++i) {
+        std::stringstream encrypted {};
+        measure("container write (per byte)", plaintext.size(), [&] {
+            std::istringstream in { plaintext };
+            Container::write(containerKeys.publicKey, in, encrypted);
+        });
+
+        std::ostringstream decrypted {};
+        measure("container read (per byte)", plaintext.size(), [&] {
+            encrypted.seekg(0);
+            if (!Container::read(containerKeys.publicKey, containerKeys.privateKey, encrypted, decrypted) || decrypted.str() != plaintext)
+                std::exit(1);
+        });
+    }
+
+    return 0;
+}
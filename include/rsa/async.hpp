@@ -0,0 +1,246 @@
+#ifndef RSA_ASYNC_HPP
+#define RSA_ASYNC_HPP
+
+#include <atomic>
+#include <coroutine>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <future>
+#include <mutex>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "rsa/concurrency.hpp"
+#include "rsa/convert.hpp"
+#include "rsa/key.hpp"
+#include "rsa/padding.hpp"
+
+// Awaitable operations for coroutine code: awaiting never blocks the calling thread, the work runs on the worker pool
+// and the coroutine resumes there when its result is ready. Operations awaited around the same time are gathered
+// into one batch, so a thousand coroutines each awaiting one decode cost a few pool tasks, not a thousand
+
+namespace Async {
+    // Lazily started coroutine returning a T, it runs when awaited (or passed to wait()) and resumes its awaiter when done
+    template <typename T>
+    class Task {
+    public:
+        struct promise_type {
+            std::optional<T> value {};
+            std::exception_ptr error {};
+            std::coroutine_handle<> continuation {};
+
+            Task get_return_object() {
+                return Task { std::coroutine_handle<promise_type>::from_promise(*this) };
+            }
+
+            std::suspend_always initial_suspend() noexcept { return {}; }
+
+            auto final_suspend() noexcept {
+                struct Resume {
+                    bool await_ready() noexcept { return false; }
+                    std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> handle) noexcept {
+                        const std::coroutine_handle<> continuation { handle.promise().continuation };
+                        return continuation ? continuation : std::noop_coroutine();
+                    }
+                    void await_resume() noexcept {}
+                };
+                return Resume {};
+            }
+
+            void return_value(T result) { value = std::move(result); }
+            void unhandled_exception() { error = std::current_exception(); }
+        };
+
+        Task(Task&& other) noexcept
+            : coroutine { std::exchange(other.coroutine, {}) } {
+        }
+
+        Task& operator=(Task&& other) noexcept {
+            if (this != &other) {
+                if (coroutine)
+                    coroutine.destroy();
+                coroutine = std::exchange(other.coroutine, {});
+            }
+            return *this;
+        }
+
+        ~Task() {
+            if (coroutine)
+                coroutine.destroy();
+        }
+
+        auto operator co_await() && noexcept {
+            struct Awaiter {
+                std::coroutine_handle<promise_type> coroutine;
+
+                bool await_ready() noexcept { return false; }
+                std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept {
+                    coroutine.promise().continuation = awaiting;
+                    return coroutine;
+                }
+                T await_resume() {
+                    if (coroutine.promise().error)
+                        std::rethrow_exception(coroutine.promise().error);
+                    return std::move(*coroutine.promise().value);
+                }
+            };
+            return Awaiter { coroutine };
+        }
+
+    private:
+        explicit Task(std::coroutine_handle<promise_type> handle)
+            : coroutine { handle } {
+        }
+
+        std::coroutine_handle<promise_type> coroutine {};
+    };
+
+    namespace Detail {
+        // Eagerly started coroutine nobody awaits, it frees itself when it ends
+        struct Detached {
+            struct promise_type {
+                Detached get_return_object() { return {}; }
+                std::suspend_never initial_suspend() noexcept { return {}; }
+                std::suspend_never final_suspend() noexcept { return {}; }
+                void return_void() {}
+                void unhandled_exception() { std::terminate(); }
+            };
+        };
+
+        // 'result' is taken by value so it lives in the coroutine frame, the caller only keeps the future
+        template <typename T>
+        Detached complete(Task<T> task, std::promise<T> result) {
+            try {
+                result.set_value(co_await std::move(task));
+            }
+            catch (...) {
+                result.set_exception(std::current_exception());
+            }
+        }
+    }
+
+    // Runs 'task' and blocks the calling thread until it is done. For tests and the edges of a program, not for coroutine code
+    template <typename T>
+    T wait(Task<T> task) {
+        std::promise<T> result {};
+        std::future<T> future { result.get_future() };
+        Detail::complete(std::move(task), std::move(result));
+        return future.get();
+    }
+
+    // Starts all the tasks together and blocks until every one of them is done, results come back in the same order
+    template <typename T>
+    std::vector<T> waitAll(std::vector<Task<T>> tasks) {
+        std::vector<std::future<T>> futures {};
+        futures.reserve(tasks.size());
+        for (Task<T>& task : tasks) {
+            std::promise<T> result {};
+            futures.push_back(result.get_future());
+            Detail::complete(std::move(task), std::move(result));
+        }
+
+        std::vector<T> results {};
+        results.reserve(futures.size());
+        for (std::future<T>& future : futures)
+            results.push_back(future.get());
+        return results;
+    }
+
+    // One awaited operation. It lives in the awaiting coroutine's frame while it is suspended, so queueing it allocates nothing
+    struct Pending {
+        enum class Kind { Encode, Decode, Sign };
+
+        Kind kind {};
+        const Key::Public* publicKey {};
+        const Key::CRT* crtKey {};
+        const Key::Wide::CRT* signingKey {};
+        long long int input {};
+        long long int result {};
+        const Utility::Bytes* digest {};
+        Padding::Signature::Scheme scheme {};
+        std::optional<Utility::Bytes> signature {};
+        std::exception_ptr error {};        // Thrown by the operation, rethrown in the awaiting coroutine
+        std::coroutine_handle<> handle {};
+    };
+
+    // Gathers awaited operations and runs them in batches on a worker pool
+    // The first operation added to an empty batch schedules a flush; everything added before that flush runs joins the batch
+    // An operation that throws (std::bad_alloc) hands its exception to the awaiting coroutine, never to the pool thread
+    class Batcher {
+    public:
+        explicit Batcher(Concurrency::WorkerPool& pool = Concurrency::defaultPool(), std::size_t maxBatch = 256);
+
+        Batcher(const Batcher&) = delete;
+        Batcher& operator=(const Batcher&) = delete;
+
+        void add(Pending& operation);
+
+        // Operations run so far and the batches they were run in
+        struct Statistics {
+            unsigned long long int operations {};
+            unsigned long long int batches {};
+        };
+
+        Statistics statistics() const;
+
+    private:
+        static void run(Pending& operation) noexcept;
+
+        void flush();
+
+        Concurrency::WorkerPool& pool;
+        const std::size_t maxBatch;
+        std::mutex mutex {};
+        std::deque<Pending*> pending {};
+        std::vector<Pending*> batch {};     // Taken by the one running flush, its capacity is reserved up front
+        bool isScheduled { false };
+        std::atomic<unsigned long long int> operations {};
+        std::atomic<unsigned long long int> batches {};
+    };
+
+    // Batcher on the shared worker pool, with the batch size of the tuning profile
+    Batcher& defaultBatcher();
+
+    // What asyncEncode() and friends return: co_await it to get the result
+    template <typename Result>
+    class Operation {
+    public:
+        Operation(Pending operation, Batcher& batcher)
+            : operation { std::move(operation) }, batcher { batcher } {
+        }
+
+        bool await_ready() const noexcept { return false; }
+
+        void await_suspend(std::coroutine_handle<> handle) {
+            operation.handle = handle;
+            batcher.add(operation);
+        }
+
+        Result await_resume() {
+            if (operation.error)
+                std::rethrow_exception(operation.error);
+            if constexpr (std::is_same_v<Result, std::optional<Utility::Bytes>>)
+                return std::move(operation.signature);
+            else
+                return operation.result;
+        }
+
+    private:
+        Pending operation;
+        Batcher& batcher;
+    };
+
+    // The keys and the digest are used after the coroutine suspends, they must live until the co_await is over
+    // (temporaries in the co_await expression do)
+    Operation<long long int> asyncEncode(const Key::Public& publicKey, long long int m, Batcher& batcher = defaultBatcher());
+
+    Operation<long long int> asyncDecode(const Key::CRT& crtKey, long long int c, Batcher& batcher = defaultBatcher());
+
+    // Same result as sign(), signatures awaited together are gathered into batches like encodes and decodes
+    Operation<std::optional<Utility::Bytes>> asyncSign(const Key::Wide::CRT& crtKey, const Utility::Bytes& digest, Padding::Signature::Scheme scheme = Padding::Signature::Scheme::PKCS1, Batcher& batcher = defaultBatcher());
+}
+
+#endif
@@ -0,0 +1,86 @@
+#ifndef RSA_BIGNUM_HPP
+#define RSA_BIGNUM_HPP
+
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "rsa/convert.hpp"
+
+// Whole numbers of any size, for moduli longer than a long long int. The paddings of encrypt() and sign() need a modulus
+// of 11 to 66 bytes at least, a long long int holds 8
+namespace BigNum {
+    // Non-negative whole number, kept as little-endian 64 bit limbs without leading zero limbs (0 has no limbs at all)
+    class Integer {
+    public:
+        using Limb = std::uint64_t;
+
+        Integer() = default;
+        explicit Integer(unsigned long long int x);
+
+        // Reads big-endian bytes as a whole number (OS2IP)
+        static Integer fromBytes(const Utility::Bytes& bytes);
+
+        // Writes the number as exactly 'length' big-endian bytes, padding with zeros on the left (I2OSP)
+        // Nothing is returned if the number needs more than 'length' bytes
+        std::optional<Utility::Bytes> toBytes(std::size_t length) const;
+
+        // Nothing is returned if the number doesn't fit a long long int
+        std::optional<long long int> toInteger() const;
+
+        std::size_t bitLength() const;
+        std::size_t byteLength() const { return (bitLength() + 7) / 8; }
+
+        bool isZero() const { return limbs_.empty(); }
+        bool isOdd() const { return !limbs_.empty() && (limbs_[0] & 1) != 0; }
+        bool bit(std::size_t i) const { return i / 64 < limbs_.size() && ((limbs_[i / 64] >> (i % 64)) & 1) != 0; }
+        void setBit(std::size_t i);
+
+        const std::vector<Limb>& limbs() const { return limbs_; }
+
+        friend bool operator==(const Integer& a, const Integer& b) = default;
+        friend std::strong_ordering operator<=>(const Integer& a, const Integer& b);
+
+        friend Integer operator+(const Integer& a, const Integer& b);
+        // 'b' must not be bigger than 'a'
+        friend Integer operator-(const Integer& a, const Integer& b);
+        friend Integer operator*(const Integer& a, const Integer& b);
+        friend Integer operator<<(const Integer& x, std::size_t bits);
+        friend Integer operator>>(const Integer& x, std::size_t bits);
+
+    private:
+        // Drops the leading zero limbs
+        void trim();
+
+        std::vector<Limb> limbs_ {};
+    };
+
+    // Quotient and remainder of 'a' divided by 'b' (Knuth's algorithm D), 'b' must not be 0
+    std::pair<Integer, Integer> divide(const Integer& a, const Integer& b);
+
+    inline Integer operator/(const Integer& a, const Integer& b) { return divide(a, b).first; }
+    inline Integer operator%(const Integer& a, const Integer& b) { return divide(a, b).second; }
+
+    // Remainder of 'a' divided by a small 'b', for trial division. 'b' must not be 0
+    std::uint64_t remainder(const Integer& a, std::uint64_t b);
+
+    // Modular power, (x ^ exponent) % modulus. An odd modulus (every RSA modulus and prime) goes through Montgomery
+    // multiplication with 4 bit windows, so no exponentiation step divides. 'modulus' must not be 0
+    Integer modPower(const Integer& x, const Integer& exponent, const Integer& modulus);
+
+    // Modular inverse with the extended Euclidean algorithm, nothing is returned if 'a' and 'modulus' aren't coprimes
+    // or 'modulus' is below 2
+    std::optional<Integer> modInverse(const Integer& a, const Integer& modulus);
+
+    // Random number below 2 ^ bits, drawn with Utility::Random
+    Integer random(std::size_t bits);
+
+    // Trial division by the small primes, then 'rounds' Miller-Rabin rounds with random bases. A composite passes with
+    // a probability below 4 ^ -rounds, far less for the random candidates key generation tests
+    bool millerRabin(const Integer& x, std::size_t rounds);
+}
+
+#endif
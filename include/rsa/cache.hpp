@@ -0,0 +1,156 @@
+#ifndef RSA_CACHE_HPP
+#define RSA_CACHE_HPP
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "rsa/convert.hpp"
+#include "rsa/hash.hpp"
+#include "rsa/key.hpp"
+#include "rsa/padding.hpp"
+
+// Bounded caches for sign and verify results, so a repeated (key, digest) costs a hash lookup instead of a modular exponentiation
+// The cache is split into shards, each with its own lock, and evicts with the CLOCK approximation of LRU: a lookup only sets
+// an atomic "recently used" flag, so lookups share the shard lock and never wait for each other, only for inserts
+namespace Cache {
+    // Entries are found by the SHA-256 digest of everything the result depends on
+    using Id = std::array<unsigned char, Hash::SHA256::digestSize>;
+
+    struct Statistics {
+        unsigned long long int hits {};
+        unsigned long long int misses {};
+
+        double hitRatio() const {
+            return hits + misses == 0 ? 0.0 : static_cast<double>(hits) / static_cast<double>(hits + misses);
+        }
+    };
+
+    template <typename Value>
+    class LRU {
+    public:
+        // 'capacity' entries in total, divided between 'shardCount' shards
+        explicit LRU(std::size_t capacity, std::size_t shardCount = 16)
+            : shards(std::max<std::size_t>(1, shardCount)) {
+            const std::size_t shardCapacity { std::max<std::size_t>(1, (capacity + shards.size() - 1) / shards.size()) };
+            for (Shard& shard : shards) {
+                shard.capacity = shardCapacity;
+                shard.entries.reserve(shardCapacity);
+                shard.isReferenced = std::make_unique<std::atomic<bool>[]>(shardCapacity);
+            }
+        }
+
+        std::optional<Value> find(const Id& id) {
+            Shard& shard { shardOf(id) };
+            std::shared_lock lock { shard.mutex };
+
+            const auto found { shard.positions.find(id) };
+            if (found == shard.positions.end()) {
+                misses.fetch_add(1, std::memory_order_relaxed);
+                return std::nullopt;
+            }
+
+            shard.isReferenced[found->second].store(true, std::memory_order_relaxed);
+            hits.fetch_add(1, std::memory_order_relaxed);
+            return shard.entries[found->second].second;
+        }
+
+        void insert(const Id& id, Value value) {
+            Shard& shard { shardOf(id) };
+            std::unique_lock lock { shard.mutex };
+
+            if (const auto found { shard.positions.find(id) }; found != shard.positions.end()) {
+                shard.entries[found->second].second = std::move(value);
+                shard.isReferenced[found->second].store(true, std::memory_order_relaxed);
+                return;
+            }
+
+            if (shard.entries.size() < shard.capacity) {
+                shard.positions.emplace(id, shard.entries.size());
+                shard.entries.emplace_back(id, std::move(value));
+                return;
+            }
+
+            // CLOCK sweep: entries used since the last pass get a second chance, the first one that wasn't is replaced
+            while (shard.isReferenced[shard.hand].exchange(false, std::memory_order_relaxed))
+                shard.hand = (shard.hand + 1) % shard.capacity;
+
+            shard.positions.erase(shard.entries[shard.hand].first);
+            shard.entries[shard.hand] = { id, std::move(value) };
+            shard.positions.emplace(id, shard.hand);
+            shard.hand = (shard.hand + 1) % shard.capacity;
+        }
+
+        Statistics statistics() const {
+            return Statistics { hits.load(std::memory_order_relaxed), misses.load(std::memory_order_relaxed) };
+        }
+
+    private:
+        struct IdHash {
+            std::size_t operator()(const Id& id) const {
+                std::size_t value {};
+                std::memcpy(&value, id.data(), sizeof(value));
+                return value;
+            }
+        };
+
+        struct Shard {
+            std::shared_mutex mutex {};
+            std::unordered_map<Id, std::size_t, IdHash> positions {};
+            std::vector<std::pair<Id, Value>> entries {};
+            std::unique_ptr<std::atomic<bool>[]> isReferenced {};
+            std::size_t capacity {};
+            std::size_t hand {};
+        };
+
+        Shard& shardOf(const Id& id) {
+            // The map uses the first bytes of the id, the shard is picked with different ones
+            return shards[id[sizeof(std::size_t)] % shards.size()];
+        }
+
+        std::vector<Shard> shards;
+        std::atomic<unsigned long long int> hits {};
+        std::atomic<unsigned long long int> misses {};
+    };
+
+    // Builds an id out of any number of byte sequences, each one prefixed with its length so they can't run into each other
+    template <typename... Parts>
+    Id makeId(const Parts&... parts) {
+        Hash::SHA256 hash {};
+        for (const Utility::Bytes* part : { &parts... }) {
+            hash.update(Utility::Convert::toBytes(static_cast<long long int>(part->size()), 8));
+            hash.update(*part);
+        }
+
+        const Utility::Bytes digest { hash.finish() };
+        Id id {};
+        std::copy(digest.begin(), digest.end(), id.begin());
+        return id;
+    }
+
+    using Signatures = LRU<Utility::Bytes>;
+    using Verifications = LRU<bool>;
+
+    // Ids signCached() and verifyCached() store their results under
+    Id signatureId(const Key::Wide::Private& privateKey, const Utility::Bytes& digest, Padding::Signature::Scheme scheme);
+    Id verificationId(const Key::Wide::Public& publicKey, const Utility::Bytes& digest, const Utility::Bytes& signature, Padding::Signature::Scheme scheme);
+}
+
+
+// sign() with a signature cache in front, a digest already signed with this key returns the stored signature
+// Only deterministic PKCS#1 v1.5 signatures are cached, PSS ones are randomized and always signed afresh
+std::optional<Utility::Bytes> signCached(const Key::Wide::Private& privateKey, const Utility::Bytes& digest, Cache::Signatures& cache, Padding::Signature::Scheme scheme = Padding::Signature::Scheme::PKCS1);
+
+// verify() with a verification cache in front, keyed by the key, the digest and the signature
+bool verifyCached(const Key::Wide::Public& publicKey, const Utility::Bytes& digest, const Utility::Bytes& signature, Cache::Verifications& cache, Padding::Signature::Scheme scheme = Padding::Signature::Scheme::PKCS1);
+
+#endif
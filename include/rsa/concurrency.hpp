@@ -0,0 +1,420 @@
+#ifndef RSA_CONCURRENCY_HPP
+#define RSA_CONCURRENCY_HPP
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Concurrency building blocks shared by the batch modes
+namespace Concurrency {
+    // Size of a cache line, hot atomics are kept on their own line so producers and consumers don't invalidate each other's
+    constexpr std::size_t cacheLineSize { 64 };
+
+    // Bounded multi-producer multi-consumer queue without locks (Dmitry Vyukov's design)
+    // Every cell has a sequence number telling whether it is ready to be written or read for the current lap around the ring,
+    // so a producer and a consumer only ever contend on one compare-and-swap each
+    template <typename T>
+    class Queue {
+    public:
+        // 'capacity' is rounded up to a power of two
+        explicit Queue(std::size_t capacity) {
+            std::size_t size { 2 };
+            while (size < capacity)
+                size *= 2;
+
+            cells = std::make_unique<Cell[]>(size);
+            mask = size - 1;
+            for (std::size_t i { 0 }; i < size; ++i)
+                cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+
+        // Returns false when the queue is full, 'value' is left untouched then
+        bool tryEnqueue(T& value) {
+            std::size_t position { enqueuePosition.load(std::memory_order_relaxed) };
+            while (true) {
+                Cell& cell { cells[position & mask] };
+                const std::size_t sequence { cell.sequence.load(std::memory_order_acquire) };
+                const std::ptrdiff_t difference { static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(position) };
+
+                if (difference == 0) {
+                    if (enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                        cell.value = std::move(value);
+                        cell.sequence.store(position + 1, std::memory_order_release);
+                        return true;
+                    }
+                }
+                else if (difference < 0)
+                    return false;
+                else
+                    position = enqueuePosition.load(std::memory_order_relaxed);
+            }
+        }
+
+        // Returns false when the queue is empty
+        bool tryDequeue(T& value) {
+            std::size_t position { dequeuePosition.load(std::memory_order_relaxed) };
+            while (true) {
+                Cell& cell { cells[position & mask] };
+                const std::size_t sequence { cell.sequence.load(std::memory_order_acquire) };
+                const std::ptrdiff_t difference { static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(position + 1) };
+
+                if (difference == 0) {
+                    if (dequeuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                        value = std::move(cell.value);
+                        cell.sequence.store(position + mask + 1, std::memory_order_release);
+                        return true;
+                    }
+                }
+                else if (difference < 0)
+                    return false;
+                else
+                    position = dequeuePosition.load(std::memory_order_relaxed);
+            }
+        }
+
+        // Enqueues items from the front of 'values' until the queue is full, returns how many went in
+        std::size_t tryEnqueueBatch(T* values, std::size_t count) {
+            std::size_t done { 0 };
+            while (done < count && tryEnqueue(values[done]))
+                ++done;
+            return done;
+        }
+
+        // Dequeues up to 'count' items into 'values', returns how many came out
+        std::size_t tryDequeueBatch(T* values, std::size_t count) {
+            std::size_t done { 0 };
+            while (done < count && tryDequeue(values[done]))
+                ++done;
+            return done;
+        }
+
+        // Only a hint while other threads are using the queue
+        bool isEmpty() const {
+            return enqueuePosition.load(std::memory_order_relaxed) == dequeuePosition.load(std::memory_order_relaxed);
+        }
+
+    private:
+        struct alignas(cacheLineSize) Cell {
+            std::atomic<std::size_t> sequence {};
+            T value {};
+        };
+
+        std::unique_ptr<Cell[]> cells {};
+        std::size_t mask {};
+        alignas(cacheLineSize) std::atomic<std::size_t> enqueuePosition { 0 };
+        alignas(cacheLineSize) std::atomic<std::size_t> dequeuePosition { 0 };
+    };
+
+    // Lets idle threads sleep in the kernel instead of spinning. std::atomic::wait is a futex wait on Linux.
+    // A sleeper reads the epoch, checks for work once more, then waits for the epoch to move; wakers bump the epoch first,
+    // so work published between the check and the wait is never missed
+    class Parking {
+    public:
+        std::uint32_t prepare() const {
+            return epoch.load(std::memory_order_acquire);
+        }
+
+        void park(std::uint32_t seenEpoch) {
+            sleepers.fetch_add(1, std::memory_order_seq_cst);
+            epoch.wait(seenEpoch, std::memory_order_acquire);
+            sleepers.fetch_sub(1, std::memory_order_relaxed);
+        }
+
+        void wakeOne() {
+            epoch.fetch_add(1, std::memory_order_seq_cst);
+            if (sleepers.load(std::memory_order_seq_cst) > 0)
+                epoch.notify_one();
+        }
+
+        void wakeAll() {
+            epoch.fetch_add(1, std::memory_order_seq_cst);
+            if (sleepers.load(std::memory_order_seq_cst) > 0)
+                epoch.notify_all();
+        }
+
+    private:
+        alignas(cacheLineSize) std::atomic<std::uint32_t> epoch { 0 };
+        alignas(cacheLineSize) std::atomic<std::uint32_t> sleepers { 0 };
+    };
+
+    // Which CPUs belong to which NUMA node, restricted to the CPUs this process may run on
+    namespace Topology {
+        struct Layout {
+            std::vector<std::vector<int>> nodeCpus {};   // Indexed by node id, empty for nodes we can't use
+            std::vector<int> cpuNode {};                 // Indexed by CPU id
+        };
+
+        // Parses a kernel CPU list like "0-3,8-11"
+        std::vector<int> parseList(const std::string& list);
+
+        // Read once from /sys/devices/system/node. Machines without NUMA (or other systems) are a single node with every CPU on it
+        const Layout& layout();
+
+        std::size_t nodeCount();
+
+        // Node of the CPU the calling thread runs on right now. Cheap: sched_getcpu goes through the vDSO / rseq, not a real syscall
+        std::size_t currentNode();
+
+        // The CPU for worker 'worker': consecutive workers alternate between nodes so that a small pool still uses every socket
+        std::optional<int> cpuFor(std::size_t worker);
+
+        // Pins the calling thread to one CPU, returns false if that isn't possible here
+        bool pin(int cpu);
+    }
+
+    // One copy of a read-only value per NUMA node. Each copy is made by the first thread that asks for it on that node,
+    // so the kernel places its pages on that node (first touch) and the hot loop never reads across the interconnect
+    template <typename T>
+    class NodeLocal {
+    public:
+        explicit NodeLocal(T value)
+            : original { std::move(value) }, replicas(Topology::nodeCount()) {
+        }
+
+        const T& local() {
+            const std::size_t node { Topology::currentNode() };
+            if (node >= replicas.size())
+                return original;
+
+            if (const Replica* replica { replicas[node].load(std::memory_order_acquire) })
+                return replica->value;
+
+            std::lock_guard lock { mutex };
+            if (!replicas[node].load(std::memory_order_relaxed)) {
+                owned.push_back(std::make_unique<Replica>(Replica { original }));
+                replicas[node].store(owned.back().get(), std::memory_order_release);
+            }
+            return replicas[node].load(std::memory_order_relaxed)->value;
+        }
+
+    private:
+        // Own cache line each, so replicas never share a line with anything else
+        struct alignas(cacheLineSize) Replica {
+            T value;
+        };
+
+        const T original;
+        std::vector<std::atomic<const Replica*>> replicas;
+        std::mutex mutex {};
+        std::vector<std::unique_ptr<Replica>> owned {};
+    };
+
+    // Work classes of a pool. Interactive work (handshakes, single requests) goes ahead of bulk work (rotation, big batches)
+    enum class Priority { Interactive, Bulk };
+
+    // How a pool shares its threads between the two classes
+    struct Policy {
+        std::size_t reservedWorkers { 0 };      // Workers that only ever run interactive tasks, so a burst always finds a free core
+        std::size_t interactiveWeight { 8 };    // Interactive tasks a shared worker runs in a row before taking one waiting bulk task
+        std::size_t bulkGrain { 16 };           // Items per chunk in a bulk parallelFor, bulk tasks yield to interactive ones between items
+    };
+
+    // Fixed set of threads running tasks from lock-free queues, one per priority class, parked when there is nothing to do
+    // With 'isPinned' every worker is bound to one CPU (spread over the NUMA nodes) before it allocates anything. That is for
+    // applications that own the machine, a library pinning threads inside someone else's process fights its scheduler
+    // Shared workers use weighted-fair picking between the classes: bulk work fills idle capacity but never starves, and
+    // interactive work waits for at most one bulk item, since bulk tasks call yield() between items
+    class WorkerPool {
+    public:
+        using Task = std::function<void()>;
+
+        explicit WorkerPool(std::size_t threadCount = std::thread::hardware_concurrency(), std::size_t capacity = 4096, bool isPinned = false, Policy policy = {})
+            : interactiveTasks { capacity }, bulkTasks { capacity }, policy { policy } {
+            threadCount = std::max<std::size_t>(1, threadCount);
+            // At least one worker has to be left for bulk work
+            this->policy.reservedWorkers = std::min(policy.reservedWorkers, threadCount - 1);
+            this->policy.bulkGrain = std::max<std::size_t>(1, policy.bulkGrain);
+
+            for (std::size_t i { 0 }; i < threadCount; ++i)
+                threads.emplace_back([this, i, isPinned] {
+                    if (isPinned)
+                        if (const std::optional<int> cpu { Topology::cpuFor(i) })
+                            Topology::pin(*cpu);
+                    run(i < this->policy.reservedWorkers);
+                });
+        }
+
+        WorkerPool(const WorkerPool&) = delete;
+        WorkerPool& operator=(const WorkerPool&) = delete;
+
+        ~WorkerPool() {
+            isStopping.store(true, std::memory_order_release);
+            reservedParking.wakeAll();
+            parking.wakeAll();
+            for (std::thread& thread : threads)
+                thread.join();
+        }
+
+        std::size_t size() const { return threads.size(); }
+
+        // When the queue is full the caller runs queued tasks itself until there is room again
+        void submit(Task task, Priority priority = Priority::Interactive) {
+            while (!queueFor(priority).tryEnqueue(task))
+                if (!runOne(priority))
+                    std::this_thread::yield();
+            wake(priority, false);
+        }
+
+        // Enqueues all the tasks with a single wake-up for the whole batch
+        void submitBatch(Task* tasks, std::size_t count, Priority priority = Priority::Interactive) {
+            for (std::size_t done { 0 }; done < count;) {
+                done += queueFor(priority).tryEnqueueBatch(tasks + done, count - done);
+                wake(priority, true);
+                if (done < count && !runOne(priority))
+                    std::this_thread::yield();
+            }
+        }
+
+        void submitBatch(std::vector<Task>& batch, Priority priority = Priority::Interactive) {
+            submitBatch(batch.data(), batch.size(), priority);
+        }
+
+        // Runs body(i) for every i in [0, count) on the pool and returns once all of them are done
+        // The calling thread runs queued tasks while it waits, so this can be called from inside a task too. An interactive
+        // caller only helps with interactive tasks, it never gets stuck in someone else's bulk work
+        template <typename Body>
+        void parallelFor(std::size_t count, Body&& body, Priority priority = Priority::Interactive) {
+            if (count == 0)
+                return;
+
+            const bool isBulk { priority == Priority::Bulk };
+            const std::size_t chunkCount { isBulk ? std::min(count, std::max(4 * size(), (count + policy.bulkGrain - 1) / policy.bulkGrain))
+                                             : std::min(count, 4 * size()) };
+
+            // What the chunks share stays on this stack frame. A chunk task only holds a pointer to it and its index, small
+            // enough for std::function to keep without allocating, and the tasks are queued from a fixed array
+            struct Shared {
+                WorkerPool& pool;
+                std::remove_reference_t<Body>& body;
+                std::atomic<std::size_t> remaining;
+                const std::size_t count;
+                const std::size_t chunkCount;
+                const bool isBulk;
+
+                void run(std::size_t chunk) {
+                    for (std::size_t i { count * chunk / chunkCount }; i < count * (chunk + 1) / chunkCount; ++i) {
+                        body(i);
+                        if (isBulk)
+                            pool.yield();
+                    }
+                    if (remaining.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                        remaining.notify_all();
+                }
+            } shared { *this, body, chunkCount, count, chunkCount, isBulk };
+            std::atomic<std::size_t>& remaining { shared.remaining };
+
+            constexpr std::size_t groupSize { 64 };
+            std::array<Task, groupSize> group {};
+            for (std::size_t first { 0 }; first < chunkCount; first += groupSize) {
+                const std::size_t grouped { std::min(groupSize, chunkCount - first) };
+                for (std::size_t i { 0 }; i < grouped; ++i)
+                    group[i] = [state = &shared, chunk = first + i] { state->run(chunk); };
+                submitBatch(group.data(), grouped, priority);
+            }
+
+            for (std::size_t left { remaining.load(std::memory_order_acquire) }; left > 0; left = remaining.load(std::memory_order_acquire))
+                if (!runOne(priority))
+                    remaining.wait(left, std::memory_order_acquire);
+        }
+
+        // Called by long bulk work between small steps: runs the interactive tasks that are waiting, on this thread, right now
+        // Returns how many ran. Cheap when there are none, a single load
+        std::size_t yield() {
+            if (interactiveTasks.isEmpty())
+                return 0;
+
+            std::size_t ran { 0 };
+            for (Task task {}; ran < policy.interactiveWeight && interactiveTasks.tryDequeue(task); ++ran) {
+                task();
+                task = nullptr;
+            }
+            return ran;
+        }
+
+    private:
+        Queue<Task>& queueFor(Priority priority) {
+            return priority == Priority::Interactive ? interactiveTasks : bulkTasks;
+        }
+
+        // Interactive work may be picked up by a reserved worker or a shared one, whichever is asleep
+        void wake(Priority priority, bool isBatch) {
+            if (priority == Priority::Interactive && policy.reservedWorkers > 0) {
+                if (isBatch)
+                    reservedParking.wakeAll();
+                else
+                    reservedParking.wakeOne();
+            }
+            if (isBatch)
+                parking.wakeAll();
+            else
+                parking.wakeOne();
+        }
+
+        // Runs one queued task on the calling thread, returns false if there was none. With 'limit' Interactive
+        // only interactive tasks are taken
+        bool runOne(Priority limit) {
+            Task task {};
+            if (!interactiveTasks.tryDequeue(task) && (limit == Priority::Interactive || !bulkTasks.tryDequeue(task)))
+                return false;
+            task();
+            return true;
+        }
+
+        void run(bool isReserved) {
+            Parking& sleepOn { isReserved ? reservedParking : parking };
+            std::size_t streak { 0 };    // Interactive tasks run since the last bulk one
+
+            while (true) {
+                const std::uint32_t epoch { sleepOn.prepare() };
+                Task task {};
+
+                // Weighted fair: interactive first, but after 'interactiveWeight' of them a waiting bulk task gets its turn
+                const bool isBulkTurn { !isReserved && streak >= policy.interactiveWeight };
+                if (!isBulkTurn && interactiveTasks.tryDequeue(task))
+                    ++streak;
+                else if (!isReserved && bulkTasks.tryDequeue(task))
+                    streak = 0;
+                else if (isBulkTurn && interactiveTasks.tryDequeue(task))
+                    ++streak;
+
+                if (task) {
+                    task();
+                    continue;
+                }
+
+                streak = 0;
+                if (isStopping.load(std::memory_order_acquire))
+                    return;
+                sleepOn.park(epoch);
+            }
+        }
+
+        Queue<Task> interactiveTasks;
+        Queue<Task> bulkTasks;
+        Policy policy;
+        Parking reservedParking {};
+        Parking parking {};
+        std::atomic<bool> isStopping { false };
+        std::vector<std::thread> threads {};
+    };
+
+    // Pool shared by the batch functions, one thread per core. On machines with 4 cores or more one of them is kept for
+    // interactive work, so a handshake never queues behind a rotation job
+    WorkerPool& defaultPool();
+
+    // Makes defaultPool() pin its workers, off unless the application asks. Returns false if the pool already exists
+    bool pinDefaultPool();
+}
+
+#endif
@@ -0,0 +1,55 @@
+#ifndef RSA_CONTAINER_HPP
+#define RSA_CONTAINER_HPP
+
+#include <cstddef>
+#include <istream>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <utility>
+
+#include "rsa/key.hpp"
+
+// Seekable container for data encoded block by block with encode(), any block can be found in O(1) and decoded on its own
+namespace Container {
+    constexpr std::size_t defaultBlockSize { 4096 };
+    // Largest block size written or accepted, a header can't make a reader allocate more than this per block
+    constexpr std::size_t maxBlockSize { 1 << 20 };
+
+    // Encodes everything in 'in' into a container written to 'out'. 'out' must be seekable, the header is completed at the end
+    // Returns false if n is shorter than 2 bytes, 'blockSize' is 0 or above maxBlockSize, or 'out' failed
+    bool write(const Key::Public& publicKey, std::istream& in, std::ostream& out, std::size_t blockSize = defaultBlockSize);
+
+    // Decodes a whole container into 'out'. Returns false if the container is invalid or was made for a different key
+    bool read(const Key::Public& publicKey, const Key::Private& privateKey, std::istream& in, std::ostream& out);
+
+#if defined(__unix__)
+    // Decodes the plaintext bytes [begin, end) of a container file into 'outputFilename' using 'threadCount' threads
+    // The container is memory-mapped, the output is preallocated and mapped too, and every block is decoded straight
+    // into its place in the output, so threads never wait on each other. Omitting the range decodes everything
+    bool decryptFile(const Key::Public& publicKey, const Key::Private& privateKey, const std::string& inputFilename, const std::string& outputFilename,
+                     std::size_t threadCount = std::thread::hardware_concurrency(), std::optional<std::pair<unsigned long long int, unsigned long long int>> range = std::nullopt);
+
+    // decryptFile() on 'processCount' forked processes instead of threads. The CRT key sits once in a read-only shared page,
+    // blocks are claimed in chunks from a shared counter and decoded straight into the shared output mapping
+    bool decryptFileSharded(const Key::Public& publicKey, const Key::Private& privateKey, const std::string& inputFilename, const std::string& outputFilename,
+                            std::size_t processCount);
+#endif
+
+#if defined(__linux__)
+    // Bulk encoding of a whole file into a container through io_uring (or pread/pwrite threads where io_uring isn't allowed),
+    // for files bigger than the page cache. 'queueDepth' segments of 'segmentBlocks' blocks each are kept in flight.
+    // With 'useDirectIO' the aligned middle of every transfer bypasses the page cache (O_DIRECT, where the file system allows it),
+    // the unaligned edges go through it. The layout is known from the file size up front, so blocks are written straight
+    // to their final offsets and the header and index are added at the end
+    bool encryptFileAsync(const Key::Public& publicKey, const std::string& inputFilename, const std::string& outputFilename, std::size_t blockSize = defaultBlockSize,
+                          unsigned int queueDepth = 32, std::size_t segmentBlocks = 256, bool useDirectIO = true, std::size_t threadCount = std::thread::hardware_concurrency());
+
+    // Reverse of encryptFileAsync(), for any container. Returns false if the container is invalid or was made for a different key
+    bool decryptFileAsync(const Key::Public& publicKey, const Key::Private& privateKey, const std::string& inputFilename, const std::string& outputFilename,
+                          unsigned int queueDepth = 32, std::size_t segmentBlocks = 256, bool useDirectIO = true, std::size_t threadCount = std::thread::hardware_concurrency());
+#endif
+}
+
+#endif
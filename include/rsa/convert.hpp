@@ -0,0 +1,41 @@
+#ifndef RSA_CONVERT_HPP
+#define RSA_CONVERT_HPP
+
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace Utility {
+    // Sequence of raw bytes, used for messages, digests and padded blocks
+    using Bytes = std::vector<unsigned char>;
+
+    namespace Convert {
+        // Number of bytes needed to write the whole number 'x' (the "k" of the PKCS#1 standard when 'x' is the modulus n)
+        constexpr std::size_t byteLength(long long int x) {
+            std::size_t length { 0 };
+            for (unsigned long long int rest { static_cast<unsigned long long int>(x) }; rest > 0; rest >>= 8)
+                ++length;
+            return length;
+        }
+
+        // Number of bits needed to write the whole number 'x'
+        constexpr std::size_t bitLength(long long int x) {
+            std::size_t length { 0 };
+            for (unsigned long long int rest { static_cast<unsigned long long int>(x) }; rest > 0; rest >>= 1)
+                ++length;
+            return length;
+        }
+
+        // Reads a big-endian sequence of bytes as a whole number (OS2IP), nothing is returned if it doesn't fit a long long int
+        std::optional<long long int> toInteger(const Bytes& bytes);
+
+        // Writes the whole number 'x' as exactly 'length' big-endian bytes, padding with zeros on the left (I2OSP)
+        Bytes toBytes(long long int x, std::size_t length);
+
+        // Lowercase hexadecimal form of 'bytes', two digits per byte
+        std::string toHex(const Bytes& bytes);
+    }
+}
+
+#endif
@@ -0,0 +1,25 @@
+#ifndef RSA_FILE_HPP
+#define RSA_FILE_HPP
+
+#include <optional>
+#include <string>
+
+#include "rsa/key.hpp"
+
+namespace Utility {
+    namespace File {
+        // Save public and/or private keys to specific files
+        // Checks if the file exists. If it doesn't, it will create it. Save to the file the needed informations
+        // Returns false if the file couldn't be opened or written
+        bool saveTo(const std::string& filename, const Key::Public& key);
+        bool saveTo(const std::string& filename, const Key::Private& key);
+
+        // Load public and/or private keys from files written by saveTo()
+        // Nothing is returned if the file can't be opened, doesn't hold every number of the key, or a number is out of range
+        // (n below 2, e or d below 1, p or q below 2)
+        std::optional<Key::Public> loadPublic(const std::string& filename);
+        std::optional<Key::Private> loadPrivate(const std::string& filename);
+    }
+}
+
+#endif
@@ -0,0 +1,26 @@
+#ifndef RSA_FILTER_HPP
+#define RSA_FILTER_HPP
+
+#include <cstddef>
+#include <thread>
+
+#include "rsa/container.hpp"
+#include "rsa/key.hpp"
+
+#if defined(__unix__)
+// Filter mode for shell pipelines (tar | rsa encrypt | zstd): raw bytes come in on stdin and go out on stdout
+namespace Filter {
+    // Largest block size encrypt() writes and decrypt() accepts, a batch holds 256 blocks
+    constexpr std::size_t maxBlockSize { 1 << 16 };
+
+    // stdin (plaintext) -> stdout (frames). Fails if n is shorter than 2 bytes or 'blockSize' is 0 or above maxBlockSize
+    // 'isPinned' binds the worker threads to CPUs (see Concurrency::WorkerPool)
+    bool encrypt(const Key::Public& publicKey, std::size_t threadCount = std::thread::hardware_concurrency(), std::size_t blockSize = Container::defaultBlockSize, bool isPinned = false);
+
+    // stdin (frames) -> stdout (plaintext). Fails if the stream header doesn't fit the key or has a block size above
+    // maxBlockSize, if a frame is invalid, or if the end marker is missing
+    bool decrypt(const Key::Public& publicKey, const Key::Private& privateKey, std::size_t threadCount = std::thread::hardware_concurrency(), bool isPinned = false);
+}
+#endif
+
+#endif
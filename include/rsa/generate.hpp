@@ -0,0 +1,102 @@
+#ifndef RSA_GENERATE_HPP
+#define RSA_GENERATE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "rsa/key.hpp"
+
+namespace Generate {
+    // Based on two prime numbers 'p' and 'q', calculates a public key, having two numbers 'n' and 'e'
+    Key::Public publicKey(const long long int p, const long long int q);
+
+    Key::Private privateKey(const long long int p, const long long int q, const Key::Public& publicKey);
+
+    // Precomputes the values the CRT private path needs, so they are calculated once per key instead of once per operation
+    // Nothing is returned if p or q is below 2 or they aren't coprimes, q has no inverse modulo p then
+    std::optional<Key::CRT> crt(const Key::Private& privateKey);
+
+    struct KeyPair {
+        Key::Public publicKey {};
+        Key::Private privateKey {};
+    };
+
+    // Sizes of each prime of a seeded key. With 31 bits the modulus n still fits a long long int
+    constexpr std::size_t minPrimeBits { 9 };
+    constexpr std::size_t maxPrimeBits { 31 };
+
+    // Deterministic key generation for test fixtures: the same 'seed' and 'index' always give the same key pair, on any machine
+    // Both primes are drawn from a ChaCha20 stream keyed by SHA-256(seed), with 'index' as nonce, and checked with Miller-Rabin. e = 65537
+    // Nothing is returned if 'primeBits' is outside [minPrimeBits, maxPrimeBits]
+    std::optional<KeyPair> fromSeed(const std::string& seed, std::uint64_t index, std::size_t primeBits = maxPrimeBits);
+
+    // Key pairs 'first' .. 'first + count - 1' of 'seed', generated in parallel on the worker pool. Empty if 'primeBits' is unsupported
+    std::vector<KeyPair> keySetFromSeed(const std::string& seed, std::uint64_t first, std::size_t count, std::size_t primeBits = maxPrimeBits);
+
+    // SHA-256 (hexadecimal) of a key set, what a test suite can pin instead of storing the keys themselves
+    std::string keySetDigest(const std::vector<KeyPair>& keys);
+
+    // Keys 0 .. count - 1 of 'seed', cached in 'filename'. The file is used if it holds this very set and its keys match the
+    // digest written with them, otherwise the set is generated again and the file rewritten
+    // Nothing is returned if 'primeBits' is unsupported or the file can't be written
+    std::optional<std::vector<KeyPair>> cachedKeySet(const std::string& filename, const std::string& seed, std::size_t count, std::size_t primeBits = maxPrimeBits);
+
+    // Kinds of primes compliance profiles ask for
+    enum class PrimeKind {
+        Ordinary,
+        Safe,       // p = 2p' + 1 with p' prime
+        Strong,     // p - 1 has a large prime factor r, p + 1 a large prime factor s, and r - 1 a large prime factor t (Gordon)
+    };
+
+    // Smallest size randomPrime() accepts, so that p' of a safe prime isn't tiny
+    constexpr std::size_t minRandomPrimeBits { 16 };
+
+    // Smallest size of a strong prime: Gordon's t has bits / 2 - 6 bits, so t is at least 6 bits long and r a few more
+    constexpr std::size_t minStrongPrimeBits { 24 };
+
+    // A strong prime together with the helper primes Gordon's algorithm built it from: r | p - 1, s | p + 1 and t | r - 1
+    // s has bits / 2 - 2 bits and t bits / 2 - 6 bits, both with their top bit set
+    struct StrongPrime {
+        long long int p {};
+        long long int r {};
+        long long int s {};
+        long long int t {};
+    };
+
+    // Random strong prime of exactly 'bits' bits (both top bits set), searched on every thread of the worker pool
+    // Nothing is returned if 'bits' is outside [minStrongPrimeBits, maxPrimeBits]
+    std::optional<StrongPrime> randomStrongPrime(std::size_t bits);
+
+    // Random prime of exactly 'bits' bits (both top bits set), drawn with Utility::Random
+    // Safe primes are found by sieving windows of candidates against the small primes, p and (p - 1) / 2 together, strong
+    // primes by Gordon's algorithm (see randomStrongPrime()). Both are searched on every thread of the worker pool
+    // Nothing is returned if 'bits' is outside [minRandomPrimeBits, maxPrimeBits], or below minStrongPrimeBits for strong primes
+    std::optional<long long int> randomPrime(std::size_t bits, PrimeKind kind = PrimeKind::Ordinary);
+
+    // Random key pair from two 'primeBits' bit primes of the chosen kind, e = 65537. Nothing is returned for a size
+    // randomPrime() refuses
+    std::optional<KeyPair> randomKeyPair(std::size_t primeBits = maxPrimeBits, PrimeKind kind = PrimeKind::Ordinary);
+
+    struct WideKeyPair {
+        Key::Wide::Public publicKey {};
+        Key::Wide::Private privateKey {};
+    };
+
+    // Sizes of the modulus of a wide key pair, in bits
+    constexpr std::size_t minWideModulusBits { 1024 };
+    constexpr std::size_t maxWideModulusBits { 8192 };
+    constexpr std::size_t defaultWideModulusBits { 2048 };
+
+    // Random key pair with a 'modulusBits' bit modulus, from two primes of half that size (both top bits set), e = 65537
+    // Candidates are sieved against the small primes, then checked with Miller-Rabin
+    // Nothing is returned if 'modulusBits' is odd or outside [minWideModulusBits, maxWideModulusBits]
+    std::optional<WideKeyPair> randomWideKeyPair(std::size_t modulusBits = defaultWideModulusBits);
+
+    // crt() for wide keys. Nothing is returned if p or q is below 2 or they aren't coprimes
+    std::optional<Key::Wide::CRT> crt(const Key::Wide::Private& privateKey);
+}
+
+#endif
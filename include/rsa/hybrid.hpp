@@ -0,0 +1,34 @@
+#ifndef RSA_HYBRID_HPP
+#define RSA_HYBRID_HPP
+
+#include <cstddef>
+#include <istream>
+#include <ostream>
+
+#include "rsa/key.hpp"
+
+// Hybrid encryption for large payloads: RSA only wraps a random symmetric key once (RSA-KEM), the payload itself is
+// streamed through ChaCha20-Poly1305 in segments
+//
+// Stream layout:
+//   "RSAH" | version (1 byte) | k (1 byte) | encapsulated key (k bytes) | segment size (4 bytes, big-endian)
+//   then every segment: ciphertext (segment size bytes, fewer for the last one) | tag (16 bytes)
+// Segment 'i' uses nonce i and authenticates whether it is the last one, so segments can't be reordered, dropped or cut off
+namespace Hybrid {
+    constexpr std::size_t defaultSegmentSize { 1 << 16 };
+
+    // Largest segment size encrypt() writes and decrypt() accepts. The size comes from the stream header, before anything
+    // is authenticated, and decrypt() allocates two segments of it
+    constexpr std::size_t maxSegmentSize { 1 << 24 };
+
+    // Encrypts everything in 'in' into 'out' with a fresh symmetric key wrapped with the public key
+    // Returns false if n is below 2, 'segmentSize' is 0 or above maxSegmentSize, or 'out' failed
+    bool encrypt(const Key::Public& publicKey, std::istream& in, std::ostream& out, std::size_t segmentSize = defaultSegmentSize);
+
+    // Decrypts a stream made by encrypt(). Returns false if the header is invalid (a segment size above maxSegmentSize
+    // included), or as soon as something doesn't authenticate or writing to 'out' fails; segments before that one have
+    // already been written to 'out' and must be discarded by the caller
+    bool decrypt(const Key::Public& publicKey, const Key::Private& privateKey, std::istream& in, std::ostream& out);
+}
+
+#endif
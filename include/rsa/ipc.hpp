@@ -0,0 +1,63 @@
+#ifndef RSA_IPC_HPP
+#define RSA_IPC_HPP
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "rsa/key.hpp"
+#include "rsa/keystore.hpp"
+
+#if defined(__linux__)
+// Shared-memory transport between client processes and a server process doing the encode/decode work
+// Every connection is one shared-memory segment with two single-producer single-consumer rings (requests, responses).
+// Requests and responses are written in place in the shared slots, so no byte goes through the kernel; a side only makes
+// a syscall (futex) to sleep when its ring is empty or full, or to wake the other side if it is asleep
+namespace IPC {
+    enum class Operation : std::uint32_t { Encode, Decode };
+
+    // The shared segment of one connection, only the library knows its layout
+    struct Channel;
+
+    // Client end of a connection. It creates the shared segment under 'name' (a shm_open name like "/rsa-1234"),
+    // the server attaches to it with serve(name, ...). Closing the client ends the server loop and removes the segment
+    class Client {
+    public:
+        static std::optional<Client> create(const std::string& name);
+
+        Client(Client&& other) noexcept;
+        Client& operator=(Client&& other) noexcept;
+
+        ~Client();
+
+        // Runs one operation over many values, keeping the request ring full while collecting responses
+        // Result 'i' is empty if the server rejected value 'i' (not in [0, n), or an unknown operation). Nothing is returned
+        // if the connection closed on the way, if there are more than 2^32 - 1 values, or if the server sent a malformed
+        // response (a tag that wasn't asked for or was already answered)
+        std::optional<std::vector<std::optional<long long int>>> run(Operation operation, const std::vector<long long int>& values);
+
+        std::optional<long long int> encode(long long int m);
+
+        std::optional<long long int> decode(long long int c);
+
+    private:
+        Client(std::string name, Channel* channel);
+
+        void release();
+
+        std::string name {};
+        Channel* channel {};
+    };
+
+    // Server loop for the connection 'name': answers requests until the client closes it. Returns false if it can't attach
+    // Everything published since the last wake-up is handled in one go, so a busy connection costs no syscalls at all
+    // Every request reads the store's current keys, so a reload takes effect from the next request on
+    bool serve(const std::string& name, const KeyStore::Store& store);
+
+    // serve() with a fixed key pair, false as well if the private key is invalid
+    bool serve(const std::string& name, const Key::Public& publicKey, const Key::Private& privateKey);
+}
+#endif
+
+#endif
@@ -0,0 +1,51 @@
+#ifndef RSA_KEY_HPP
+#define RSA_KEY_HPP
+
+#include "rsa/bignum.hpp"
+
+// Holds public and private keys
+namespace Key {
+    struct Public {
+        long long int n{};
+        long long int e{};
+    };
+
+    struct Private {
+        long long int p{};
+        long long int q{};
+        long long int d{};
+    };
+
+    // Private key split for the Chinese Remainder Theorem: two half-size exponentiations mod p and mod q instead of one mod n
+    struct CRT {
+        long long int p{};
+        long long int q{};
+        long long int dP{};     // d mod (p - 1)
+        long long int dQ{};     // d mod (q - 1)
+        long long int qInv{};   // q^-1 mod p
+    };
+
+    // The same keys with a modulus of any size, what the paddings of encrypt() and sign() need
+    namespace Wide {
+        struct Public {
+            BigNum::Integer n{};
+            BigNum::Integer e{};
+        };
+
+        struct Private {
+            BigNum::Integer p{};
+            BigNum::Integer q{};
+            BigNum::Integer d{};
+        };
+
+        struct CRT {
+            BigNum::Integer p{};
+            BigNum::Integer q{};
+            BigNum::Integer dP{};
+            BigNum::Integer dQ{};
+            BigNum::Integer qInv{};
+        };
+    }
+}
+
+#endif
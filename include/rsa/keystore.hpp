@@ -0,0 +1,79 @@
+#ifndef RSA_KEYSTORE_HPP
+#define RSA_KEYSTORE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "rsa/key.hpp"
+
+// Hot key reload for long-running processes: the current key set is published through one atomic pointer that readers
+// load without locks, and a new key set replaces it with a single swap. Calls already running keep the key set they
+// started with; the old set is freed once no reader that could still see it is left (epoch-based reclamation)
+namespace KeyStore {
+    struct KeySet {
+        Key::Public publicKey {};
+        Key::Private privateKey {};
+        Key::CRT crtKey {};
+        unsigned long long int version {};
+    };
+
+    class Store {
+    public:
+        // Keeps the key set it was given alive while the reader exists, reading costs two stores and two loads, no lock
+        class Reader {
+        public:
+            explicit Reader(const std::atomic<const KeySet*>& current);
+
+            Reader(const Reader&) = delete;
+            Reader& operator=(const Reader&) = delete;
+
+            ~Reader();
+
+            const KeySet& operator*() const { return *keys; }
+            const KeySet* operator->() const { return keys; }
+
+        private:
+            const KeySet* keys {};
+        };
+
+        // Store holding the key pair as version 1, nothing is returned if the private key has no CRT form (see Generate::crt)
+        static std::unique_ptr<Store> create(const Key::Public& publicKey, const Key::Private& privateKey);
+
+        Store(const Store&) = delete;
+        Store& operator=(const Store&) = delete;
+
+        // No reader may be left when the store goes away
+        ~Store();
+
+        Reader read() const;
+
+        // Swaps in a new key pair, readers from now on see it. Returns the new version, nothing if the private key is invalid
+        std::optional<unsigned long long int> publish(const Key::Public& publicKey, const Key::Private& privateKey);
+
+        // Loads the key pair from the files main() writes and publishes it. The old keys stay if a file can't be read or the keys don't match
+        bool reload(const std::string& publicKeyFilename = "publickey.txt", const std::string& privateKeyFilename = "privatekey.txt");
+
+        // Frees the retired key sets no reader can see anymore, returns how many are still waiting
+        std::size_t reclaim();
+
+        long long int encode(long long int m) const;
+
+        long long int decode(long long int c) const;
+
+    private:
+        explicit Store(const KeySet* keys);
+
+        std::atomic<const KeySet*> current;
+        std::mutex writerMutex {};
+        std::mutex retiredMutex {};
+        std::vector<std::pair<const KeySet*, unsigned long long int>> retired {};
+    };
+}
+
+#endif
@@ -0,0 +1,97 @@
+#ifndef RSA_MATH_HPP
+#define RSA_MATH_HPP
+
+#include <array>
+#include <cstddef>
+#include <numeric>
+#include <optional>
+#include <vector>
+
+// long long ints and doubles are used due to the algorithms (typically) really big numbers
+
+namespace Utility {
+    namespace Math {
+        // Checks if a number 'x' is prime or not.
+        // If divided with every natural number 'i' between 1 and x, with those extremes not included (1 < i < x), nets a remainder of 0, it is not a prime number
+        // Otherwise, it is a prime number.
+        constexpr bool isPrime(long long int x) {
+            for (int i { 2 }; i < x; ++i)
+                if (x % i == 0)
+                    return false;
+            return true;
+        }
+
+        // Creates and returns a list containing all of the dividers of a number 'x'
+        // A number is a divider of x if, when x is divided with that number, the remainder is 0
+        constexpr std::vector<long long int> dividerList(long long int x) {
+            std::vector<long long int> x_dividerList {};
+            
+            x_dividerList.reserve(x); // Reserves enough capacity to hold the dividers
+
+            for (long long int i { 1 }; i <= x; ++i)
+                if (x % i == 0)
+                    x_dividerList.push_back(i);
+            
+            x_dividerList.shrink_to_fit(); // Shrinks the capacity to save on space
+
+            return x_dividerList;
+        }
+
+        // Checks if two numbers 'a' and 'b' are coprimes with eachother
+        // Two numbers are coprimes if their MCD, Maximum Common Divider/Massimo Comune Divisore is equal to 1
+        // This means both numbers highest divder they have in common is 1
+        // The MCD comes from Euclid's algorithm, listing every divider would need memory proportional to the numbers
+        constexpr bool areCoprimes(long long int a, long long int b) {
+            return std::gcd(a, b) == 1;
+        }
+
+        // Faster version of eulero's function. Makes sure 'n' is the product of 'p' and 'q', then uses those last two numbers to get the number of coprimes n has between 1 and 1 (1<fi(n)<n)
+        long long int phi(long long int n, long long int p, long long int q);
+
+        // Basic integer power, multiplies whole number 'x' with itself for a specific number of times, represented with 'exponent'
+        // If the exponent is 0, returns 1
+        long long int power(long long int x, long long int exponent);
+
+        // Multiplies 'a' and 'b' and returns the remainder of the product divided by 'modulus'
+        // The product is held in 128 bits, so two numbers smaller than the modulus never overflow
+        // Defined here so it inlines into callers outside the library too, it's the innermost operation of every exponentiation
+        inline long long int modMultiply(long long int a, long long int b, long long int modulus) {
+            return static_cast<long long int>((static_cast<unsigned __int128>(a) * static_cast<unsigned __int128>(b)) % static_cast<unsigned __int128>(modulus));
+        }
+
+        // Modular power, calculates (x ^ exponent) % modulus without ever holding the whole power 'x ^ exponent'
+        // With a window of 1 it's square-and-multiply: walks the bits of the exponent, squaring 'x' at every bit and multiplying
+        // it into the result when the bit is 1. Wider windows read the exponent 'windowBits' bits at a time from the top, with a
+        // table of x^0 .. x^(2^windowBits - 1): fewer multiplications for long exponents, at the cost of building the table.
+        // Where the balance lies depends on the CPU, see Tuning
+        long long int modPower(long long int x, long long int exponent, long long int modulus, std::size_t windowBits);
+
+        // modPower() with the window width of the current tuning profile, read on every call
+        long long int modPower(long long int x, long long int exponent, long long int modulus);
+
+        // Primes below 1024, for trial division before the costlier tests
+        constexpr std::array<int, 172> smallPrimes { [] {
+            std::array<int, 172> primes {};
+            std::size_t count { 0 };
+            for (int x { 2 }; count < primes.size(); ++x) {
+                bool isPrime { true };
+                for (std::size_t i { 0 }; i < count && primes[i] * primes[i] <= x && isPrime; ++i)
+                    isPrime = x % primes[i] != 0;
+                if (isPrime)
+                    primes[count++] = x;
+            }
+            return primes;
+        }() };
+
+        // Checks if 'x' is prime with trial division by small primes, then Miller-Rabin with a set of bases known to give the exact
+        // answer for every long long int. A few microseconds where isPrime() needs up to 'x' divisions
+        // Sieves that already crossed out the multiples of the primes below 1024 can skip the trial division
+        bool millerRabin(long long int x, bool isTrialDivisionNeeded = true);
+
+        // Modular inverse, finds the number 'y' such that (a * y) % modulus == 1, using the extended Euclidean algorithm
+        // Nothing is returned if 'a' and 'modulus' aren't coprimes (or 'modulus' isn't positive), there isn't an inverse then
+        std::optional<long long int> modInverse(long long int a, long long int modulus);
+    }
+}
+
+#endif
@@ -0,0 +1,46 @@
+#ifndef RSA_MERKLE_HPP
+#define RSA_MERKLE_HPP
+
+#include <cstddef>
+#include <optional>
+#include <vector>
+
+#include "rsa/convert.hpp"
+#include "rsa/key.hpp"
+#include "rsa/padding.hpp"
+
+// Merkle tree batch signing: a burst of messages is signed with one private key operation instead of one per message
+// The tree is built over the message digests and only its root is signed, every message gets the root signature
+// plus the sibling hashes on the way from its leaf to the root (its authentication path)
+namespace Merkle {
+    // Everything a verifier needs for one message of the batch
+    struct Proof {
+        Utility::Bytes rootSignature {};
+        std::size_t index {};                   // Position of the message in the batch
+        std::size_t leafCount {};               // Number of messages in the batch
+        std::vector<Utility::Bytes> path {};    // Sibling hashes from the leaf up to the root
+    };
+
+    // The tree itself, without any key. Leaves and inner nodes are hashed with different prefixes
+    Utility::Bytes leafHash(const Utility::Bytes& message);
+    Utility::Bytes nodeHash(const Utility::Bytes& left, const Utility::Bytes& right);
+
+    // Every level of the tree over 'messages', level 0 holds the leaves and the last level only the root
+    // An odd node at the end of a level is moved up unchanged. Empty for no messages
+    std::vector<std::vector<Utility::Bytes>> buildLevels(const std::vector<Utility::Bytes>& messages);
+
+    // Sibling hashes from leaf 'index' up to the root, a level where the node has no sibling adds nothing
+    std::vector<Utility::Bytes> authenticationPath(const std::vector<std::vector<Utility::Bytes>>& levels, std::size_t index);
+
+    // Root the proof leads to from 'message'. Nothing is returned if the path doesn't have the length the tree's shape asks for
+    std::optional<Utility::Bytes> rootFromPath(const Utility::Bytes& message, const Proof& proof);
+
+    // Signs a whole batch of messages with a single private key operation, proof 'i' belongs to message 'i'
+    // Nothing is returned if the root can't be signed with this key, see sign()
+    std::optional<std::vector<Proof>> signBatch(const Key::Wide::Private& privateKey, const std::vector<Utility::Bytes>& messages, Padding::Signature::Scheme scheme = Padding::Signature::Scheme::PKCS1);
+
+    // Recomputes the root from 'message' and its authentication path, then checks the root signature with the public key
+    bool verify(const Key::Wide::Public& publicKey, const Utility::Bytes& message, const Proof& proof, Padding::Signature::Scheme scheme = Padding::Signature::Scheme::PKCS1);
+}
+
+#endif
@@ -0,0 +1,105 @@
+#ifndef RSA_PADDING_HPP
+#define RSA_PADDING_HPP
+
+#include <array>
+#include <cstddef>
+#include <optional>
+
+#include "rsa/convert.hpp"
+#include "rsa/hash.hpp"
+
+// Message paddings from PKCS#1 (RFC 8017), a message is padded into a block as long as the modulus before it is encoded
+namespace Padding {
+    enum class Scheme {
+        OAEP,   // EME-OAEP with SHA-256 and MGF1-SHA-256
+        PKCS1,  // EME-PKCS1-v1_5
+    };
+
+    // Mask generation function MGF1 based on SHA-256, stretches 'seed' into 'length' pseudo-random bytes
+    Utility::Bytes mgf1(const unsigned char* seed, std::size_t seedLength, std::size_t length);
+
+    namespace OAEP {
+        constexpr std::size_t hashLength { Hash::SHA256::digestSize };
+
+        // Longest message that fits into a 'k' bytes block
+        constexpr std::size_t maxMessageLength(std::size_t k) {
+            return k < 2 * hashLength + 2 ? 0 : k - 2 * hashLength - 2;
+        }
+
+        // EM = 0x00 || maskedSeed || maskedDB, where DB = lHash || 0x00...0x00 || 0x01 || message
+        // Nothing is returned if 'k' is below 2 * hashLength + 2 or the message is longer than maxMessageLength(k)
+        std::optional<Utility::Bytes> encode(const Utility::Bytes& message, std::size_t k);
+
+        // Reverses encode(). Doesn't say what went wrong when the block is invalid, every failure looks the same to the caller
+        std::optional<Utility::Bytes> decode(Utility::Bytes encoded);
+    }
+
+    namespace PKCS1 {
+        constexpr std::size_t minimumPaddingLength { 8 };
+
+        // Longest message that fits into a 'k' bytes block
+        constexpr std::size_t maxMessageLength(std::size_t k) {
+            return k < minimumPaddingLength + 3 ? 0 : k - minimumPaddingLength - 3;
+        }
+
+        // EM = 0x00 || 0x02 || PS || 0x00 || message, where PS are at least 8 random non-zero bytes
+        // Nothing is returned if the message is longer than maxMessageLength(k)
+        std::optional<Utility::Bytes> encode(const Utility::Bytes& message, std::size_t k);
+
+        // Reverses encode(), nothing is returned when the block isn't a valid PKCS#1 v1.5 block
+        std::optional<Utility::Bytes> decode(const Utility::Bytes& encoded);
+    }
+
+    // Pads 'message' into a 'k' bytes block with the chosen scheme, nothing is returned if it doesn't fit
+    std::optional<Utility::Bytes> encode(const Utility::Bytes& message, std::size_t k, Scheme scheme);
+
+    std::optional<Utility::Bytes> decode(const Utility::Bytes& encoded, Scheme scheme);
+
+    // Longest message the chosen scheme can fit into a 'k' bytes block
+    constexpr std::size_t maxMessageLength(std::size_t k, Scheme scheme) {
+        return scheme == Scheme::OAEP ? OAEP::maxMessageLength(k) : PKCS1::maxMessageLength(k);
+    }
+
+    // Signature encodings (EMSA) from PKCS#1, turn a SHA-256 digest into a block that gets signed with the private key
+    namespace Signature {
+        enum class Scheme {
+            PKCS1,  // RSASSA-PKCS1-v1_5, deterministic
+            PSS,    // RSASSA-PSS with MGF1-SHA-256 and a 32 byte salt, randomized
+        };
+
+        namespace PKCS1 {
+            // DER encoding of the DigestInfo header for SHA-256, written in front of the digest
+            constexpr std::array<unsigned char, 19> sha256DigestInfo {
+                0x30, 0x31, 0x30, 0x0d, 0x06, 0x09, 0x60, 0x86, 0x48, 0x01, 0x65, 0x03, 0x04, 0x02, 0x01, 0x05, 0x00, 0x04, 0x20,
+            };
+
+            // EM = 0x00 || 0x01 || 0xff...0xff || 0x00 || DigestInfo || digest, at least 8 0xff bytes
+            // Nothing is returned if 'digest' isn't a SHA-256 digest or 'k' is too short for the encoding
+            std::optional<Utility::Bytes> encode(const Utility::Bytes& digest, std::size_t k);
+
+            // The encoding is deterministic, so verifying is rebuilding it and comparing
+            bool verify(const Utility::Bytes& digest, const Utility::Bytes& encoded);
+        }
+
+        namespace PSS {
+            constexpr std::size_t hashLength { Hash::SHA256::digestSize };
+            constexpr std::size_t saltLength { Hash::SHA256::digestSize };
+
+            // H = Hash(0x00 * 8 || digest || salt)
+            Utility::Bytes hashWithSalt(const Utility::Bytes& digest, const unsigned char* salt);
+
+            // EM = maskedDB || H || 0xbc, where DB = 0x00...0x00 || 0x01 || salt. 'emBits' is the bit length of the modulus minus 1
+            // Nothing is returned if 'digest' isn't a SHA-256 digest or 'emBits' is too short for the encoding
+            std::optional<Utility::Bytes> encode(const Utility::Bytes& digest, std::size_t emBits);
+
+            bool verify(const Utility::Bytes& digest, Utility::Bytes encoded, std::size_t emBits);
+        }
+
+        // Shortest modulus, in bytes, the encoding of 'scheme' can fit in, sign() fails for anything shorter
+        constexpr std::size_t minimumKeySize(Scheme scheme) {
+            return scheme == Scheme::PKCS1 ? PKCS1::sha256DigestInfo.size() + Hash::SHA256::digestSize + 11 : PSS::hashLength + PSS::saltLength + 2;
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,27 @@
+#ifndef RSA_RANDOM_HPP
+#define RSA_RANDOM_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+#include "rsa/convert.hpp"
+
+namespace Utility {
+    // Cryptographically secure random numbers from a ChaCha20 generator kept per thread, seeded and periodically reseeded
+    // by the kernel. No lock and no system call on the way, a forked child never repeats its parent's output
+    namespace Random {
+        // Fills 'length' bytes at 'bytes' with random bytes
+        void fill(unsigned char* bytes, std::size_t length);
+
+        // Overwrites every byte of 'bytes'
+        void fill(Bytes& bytes);
+
+        // Uniformly random 64 bit number
+        std::uint64_t next();
+
+        // Uniformly random number in [0, bound), 'bound' must not be 0
+        std::uint64_t below(std::uint64_t bound);
+    }
+}
+
+#endif
@@ -0,0 +1,33 @@
+#ifndef RSA_ROTATION_HPP
+#define RSA_ROTATION_HPP
+
+#include <cstddef>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "rsa/key.hpp"
+
+#if defined(__unix__)
+// Key rotation: every container of a store is decoded with the old private key and encoded again with the new public key.
+// Each block is decoded and encoded by the same worker right away, so its plaintext never leaves that worker's cache.
+// Progress is saved to a checkpoint file after every round, so a crashed job started again with the same arguments resumes
+// where it stopped. The input can be throttled to leave I/O bandwidth to the rest of the system
+namespace Rotation {
+    struct Job {
+        std::vector<std::pair<std::string, std::string>> files {};          // (old container, new container) pairs
+        std::string checkpointFilename {};
+        unsigned long long int bytesPerSecond { 0 };                        // 0 means no throttling
+        std::size_t threadCount { std::thread::hardware_concurrency() };    // Segments per round, run as bulk work on the shared pool
+        std::size_t segmentBlocks { 256 };                                  // Blocks per segment
+    };
+
+    // Runs (or resumes) a whole rotation job. The checkpoint file is removed once every file is done
+    // Returns false if a container is invalid or made for a different key, if the new modulus is shorter than 2 bytes,
+    // or if a file or the checkpoint can't be written; running the same job again resumes it
+    bool reencrypt(const Key::Public& oldPublicKey, const Key::Private& oldPrivateKey, const Key::Public& newPublicKey, const Job& job);
+}
+#endif
+
+#endif
@@ -0,0 +1,129 @@
+#ifndef RSA_RSA_H
+#define RSA_RSA_H
+
+/*
+ * C interface of librsa.so, for services written in other languages.
+ *
+ * Keys are opaque handles, freed with their rsa_*_free function. Every batch function reads from and writes into buffers
+ * owned by the caller, no other memory is handed out. rsa_encode_batch and rsa_decode_batch allocate nothing, on the
+ * calling thread or on the pool. Padded encryption and signatures still allocate internally: messages are copied, and
+ * padded blocks and the numbers of the modulus arithmetic live on the heap, so those batches can return
+ * RSA_ERROR_OUT_OF_MEMORY. Handles are immutable once created and can be shared between threads.
+ * Every function that can fail returns an rsa_status, RSA_OK on success. No exception ever crosses this interface, not
+ * even from the pool threads.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define RSA_ABI_VERSION 2
+
+typedef enum rsa_status {
+    RSA_OK = 0,
+    RSA_ERROR_INVALID_ARGUMENT = -1,    /* Null pointer, inconsistent key numbers, ... */
+    RSA_ERROR_IO = -2,                  /* A key file couldn't be read or parsed */
+    RSA_ERROR_INVALID_INPUT = -3,       /* A number isn't below the modulus, or a message is too long */
+    RSA_ERROR_KEY_TOO_SMALL = -4,       /* The modulus is too short for the requested padding or signature scheme */
+    RSA_ERROR_OUT_OF_MEMORY = -5,
+    RSA_ERROR_INTERNAL = -6,
+    RSA_ERROR_KEY_TOO_LARGE = -7        /* The modulus doesn't fit the 63 bit numbers of rsa_encode_batch / rsa_decode_batch */
+} rsa_status;
+
+typedef enum rsa_padding {
+    RSA_PADDING_OAEP = 0,               /* OAEP with SHA-256 and MGF1 */
+    RSA_PADDING_PKCS1 = 1               /* PKCS#1 v1.5 */
+} rsa_padding;
+
+typedef enum rsa_signature_scheme {
+    RSA_SIGNATURE_PKCS1 = 0,            /* RSASSA-PKCS1-v1_5 with SHA-256 */
+    RSA_SIGNATURE_PSS = 1               /* RSASSA-PSS with SHA-256 */
+} rsa_signature_scheme;
+
+#define RSA_DIGEST_SIZE 32              /* SHA-256 digests are what sign and verify take */
+
+typedef struct rsa_public_key rsa_public_key;
+typedef struct rsa_private_key rsa_private_key;
+
+/* RSA_ABI_VERSION of the loaded library */
+uint32_t rsa_abi_version(void);
+
+/* Short English description of a status */
+const char* rsa_status_string(rsa_status status);
+
+/*
+ * Keys, from numbers or from the files written by the rsa command ("n: ... e: ..." / "p: ... q: ... d: ...").
+ * Those are at most 63 bits long, too short for any padding or signature scheme: padded encryption and signatures need
+ * keys from rsa_*_create_from_bytes or rsa_key_pair_generate
+ */
+rsa_status rsa_public_key_create(int64_t n, int64_t e, rsa_public_key** key);
+rsa_status rsa_public_key_load(const char* filename, rsa_public_key** key);
+void rsa_public_key_free(rsa_public_key* key);
+
+/* Keys of any size, from big-endian numbers. The private key is checked like rsa_private_key_create, p and q with Miller-Rabin */
+rsa_status rsa_public_key_create_from_bytes(const uint8_t* n, size_t n_length, const uint8_t* e, size_t e_length, rsa_public_key** key);
+rsa_status rsa_private_key_create_from_bytes(const uint8_t* p, size_t p_length, const uint8_t* q, size_t q_length,
+                                             const uint8_t* d, size_t d_length, rsa_private_key** key);
+
+/* Random key pair with a modulus of 'modulus_bits' bits (even, 1024 to 8192) and e = 65537. Both handles are set on success */
+rsa_status rsa_key_pair_generate(size_t modulus_bits, rsa_public_key** public_key, rsa_private_key** private_key);
+
+/* Length in bytes of the modulus, which is the length of every ciphertext and signature */
+size_t rsa_public_key_size(const rsa_public_key* key);
+size_t rsa_private_key_size(const rsa_private_key* key);
+
+/*
+ * The CRT values are prepared once here, not on every operation. RSA_ERROR_INVALID_ARGUMENT if p and q aren't two
+ * distinct primes, if n = p * q doesn't fit 63 bits, or if d has no inverse modulo (p - 1) * (q - 1)
+ */
+rsa_status rsa_private_key_create(int64_t p, int64_t q, int64_t d, rsa_private_key** key);
+rsa_status rsa_private_key_load(const char* filename, rsa_private_key** key);
+void rsa_private_key_free(rsa_private_key* key);
+
+/*
+ * Textbook encode/decode of 'count' numbers, every number must be in [0, n). Input and output may be the same array
+ * RSA_ERROR_KEY_TOO_LARGE for a key whose modulus doesn't fit 63 bits
+ */
+rsa_status rsa_encode_batch(const rsa_public_key* key, const int64_t* messages, int64_t* ciphertexts, size_t count);
+rsa_status rsa_decode_batch(const rsa_private_key* key, const int64_t* ciphertexts, int64_t* messages, size_t count);
+
+/*
+ * Padded encryption of 'count' messages. Message i starts at messages + i * message_stride and is message_lengths[i]
+ * bytes long. Ciphertext i is written at ciphertexts + i * rsa_public_key_size(key)
+ */
+rsa_status rsa_encrypt_batch(const rsa_public_key* key, rsa_padding padding, const uint8_t* messages, size_t message_stride,
+                             const size_t* message_lengths, size_t count, uint8_t* ciphertexts);
+
+/*
+ * Reverse of rsa_encrypt_batch. Plaintext i is written at plaintexts + i * plaintext_stride, its length goes to
+ * plaintext_lengths[i] and valid[i] is 1, or 0 if ciphertext i or its padding is invalid (or doesn't fit the stride)
+ */
+rsa_status rsa_decrypt_batch(const rsa_private_key* key, rsa_padding padding, const uint8_t* ciphertexts, size_t count,
+                             uint8_t* plaintexts, size_t plaintext_stride, size_t* plaintext_lengths, uint8_t* valid);
+
+/* Signs 'count' SHA-256 digests (RSA_DIGEST_SIZE bytes each, back to back). Signature i goes to signatures + i * rsa_private_key_size(key) */
+rsa_status rsa_sign_batch(const rsa_private_key* key, rsa_signature_scheme scheme, const uint8_t* digests, size_t count, uint8_t* signatures);
+
+/* Checks 'count' signatures (k bytes each) against their digests, results[i] is 1 if signature i is valid, else 0 */
+rsa_status rsa_verify_batch(const rsa_public_key* key, rsa_signature_scheme scheme, const uint8_t* digests, const uint8_t* signatures,
+                            size_t count, uint8_t* results);
+
+/*
+ * Threads used by the batch functions. By default batches run on a shared pool with one thread per core.
+ * 0 runs every batch on the calling thread, any other count replaces the pool with one of that size. A nonzero 'pinned'
+ * pins its threads to one CPU each, otherwise they are left to the scheduler like those of the default pool.
+ * Waits for the batches already running to finish before swapping the pool
+ */
+rsa_status rsa_thread_pool_configure(size_t thread_count, int pinned);
+
+/* Threads the batch functions currently use, 0 when they run on the calling thread */
+size_t rsa_thread_pool_size(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,67 @@
+#ifndef RSA_RSA_HPP
+#define RSA_RSA_HPP
+
+#include <optional>
+#include <vector>
+
+#include "rsa/bignum.hpp"
+#include "rsa/convert.hpp"
+#include "rsa/file.hpp"
+#include "rsa/generate.hpp"
+#include "rsa/key.hpp"
+#include "rsa/math.hpp"
+#include "rsa/padding.hpp"
+
+// Encodes a message encoded into a whole number 'm' using a public key. The encoding results into an encoded whole number 'c'
+long long int encode(const Key::Public& publicKey, const long long int m);
+
+// Decodes a message that was encoded into a whole number 'c' utilizing both the public and private keys. This decoding will give back the original whole number 'm'.
+long long int decode(const Key::Public& publicKey, const Key::Private& privateKey, const long long int c);
+
+// Same result as decode(), but using the CRT form of the private key (Garner's recombination)
+// Two exponentiations with half-size moduli and exponents are much cheaper than one with the full 'n' and 'd'
+long long int decode(const Key::CRT& crtKey, const long long int c);
+
+// encode() and decode() for wide keys, 'm' and 'c' must be below the modulus
+BigNum::Integer encode(const Key::Wide::Public& publicKey, const BigNum::Integer& m);
+BigNum::Integer decode(const Key::Wide::CRT& crtKey, const BigNum::Integer& c);
+
+// Pads a message made of bytes with the chosen scheme and encodes the padded block using a public key
+// The ciphertext is as long as the modulus, 'k' bytes. Nothing is returned if the modulus is too short for the padding or
+// the message too long for it (see Padding::maxMessageLength). Paddings need wide keys: k is at least 11 bytes for PKCS1
+// and 66 for OAEP, a long long int modulus has 8 at most
+std::optional<Utility::Bytes> encrypt(const Key::Wide::Public& publicKey, const Utility::Bytes& message, Padding::Scheme scheme = Padding::Scheme::OAEP);
+
+// Decodes a ciphertext made by encrypt() and removes its padding. Nothing is returned if the ciphertext or its padding is invalid
+std::optional<Utility::Bytes> decrypt(const Key::Wide::CRT& crtKey, const Utility::Bytes& ciphertext, Padding::Scheme scheme = Padding::Scheme::OAEP);
+
+// Same as above, preparing the CRT values first
+std::optional<Utility::Bytes> decrypt(const Key::Wide::Private& privateKey, const Utility::Bytes& ciphertext, Padding::Scheme scheme = Padding::Scheme::OAEP);
+
+// Signs a SHA-256 digest with an already prepared CRT private key. The signature is as long as the modulus, 'k' bytes
+// Nothing is returned if 'digest' isn't a SHA-256 digest or the modulus is too short for the scheme
+// (Padding::Signature::minimumKeySize, 62 bytes for PKCS1 and 66 for PSS: signing needs wide keys)
+std::optional<Utility::Bytes> sign(const Key::Wide::CRT& crtKey, const Utility::Bytes& digest, Padding::Signature::Scheme scheme = Padding::Signature::Scheme::PKCS1);
+
+// Signs a SHA-256 digest with the private key, going through the CRT private path
+std::optional<Utility::Bytes> sign(const Key::Wide::Private& privateKey, const Utility::Bytes& digest, Padding::Signature::Scheme scheme = Padding::Signature::Scheme::PKCS1);
+
+// Checks a signature made by sign() against a SHA-256 digest, using only the public key
+// Verifying is a single encode(), with e = 65537 that's only 17 modular multiplications
+bool verify(const Key::Wide::Public& publicKey, const Utility::Bytes& digest, const Utility::Bytes& signature, Padding::Signature::Scheme scheme = Padding::Signature::Scheme::PKCS1);
+
+// Signs many digests with the same private key on the worker pool. The CRT values are prepared once for the whole batch
+// and copied once per NUMA node. Signature 'i' is empty when digest 'i' can't be signed, see sign()
+std::vector<std::optional<Utility::Bytes>> signBatch(const Key::Wide::Private& privateKey, const std::vector<Utility::Bytes>& digests, Padding::Signature::Scheme scheme = Padding::Signature::Scheme::PKCS1);
+
+// Hashes and signs many messages with the same private key, hashing them all together with Hash::sha256Batch
+std::vector<std::optional<Utility::Bytes>> signMessages(const Key::Wide::Private& privateKey, const std::vector<Utility::Bytes>& messages, Padding::Signature::Scheme scheme = Padding::Signature::Scheme::PKCS1);
+
+// Verifies many (digest, signature) pairs with the same public key on the worker pool, result 'i' tells if signature 'i' is valid
+// There is one result per digest, a digest without a signature is invalid
+std::vector<bool> verifyBatch(const Key::Wide::Public& publicKey, const std::vector<Utility::Bytes>& digests, const std::vector<Utility::Bytes>& signatures, Padding::Signature::Scheme scheme = Padding::Signature::Scheme::PKCS1);
+
+// Hashes many messages with Hash::sha256Batch and verifies their signatures with the same public key
+std::vector<bool> verifyMessages(const Key::Wide::Public& publicKey, const std::vector<Utility::Bytes>& messages, const std::vector<Utility::Bytes>& signatures, Padding::Signature::Scheme scheme = Padding::Signature::Scheme::PKCS1);
+
+#endif
@@ -0,0 +1,72 @@
+#ifndef RSA_TABLE_HPP
+#define RSA_TABLE_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include "rsa/convert.hpp"
+#include "rsa/key.hpp"
+
+// Precomputed encode and decode permutations for tiny moduli, every operation becomes one table lookup
+namespace Table {
+    constexpr long long int maxModulus { 1 << 20 };
+
+    // 'size' numbers stored with only as many bits as the biggest one needs, 20 bits per entry instead of 64 for n < 2^20
+    class PackedArray {
+    public:
+        PackedArray(std::size_t size, long long int maxValue)
+            : bits { std::max<std::size_t>(1, Utility::Convert::bitLength(maxValue)) }, words((size * bits + 63) / 64 + 1, 0) {}
+
+        long long int get(std::size_t i) const {
+            const std::size_t bit { i * bits };
+            const std::size_t word { bit / 64 };
+            const std::size_t shift { bit % 64 };
+
+            std::uint64_t value { words[word] >> shift };
+            if (shift + bits > 64)
+                value |= words[word + 1] << (64 - shift);
+            return static_cast<long long int>(value & mask());
+        }
+
+        // Entries sharing a 64 bit word must be set by the same thread. Ranges starting and ending on multiples of 64 entries never share words
+        void set(std::size_t i, long long int value) {
+            const std::size_t bit { i * bits };
+            const std::size_t word { bit / 64 };
+            const std::size_t shift { bit % 64 };
+            const std::uint64_t x { static_cast<std::uint64_t>(value) & mask() };
+
+            words[word] = (words[word] & ~(mask() << shift)) | (x << shift);
+            if (shift + bits > 64)
+                words[word + 1] = (words[word + 1] & ~(mask() >> (64 - shift))) | (x >> (64 - shift));
+        }
+
+        std::size_t memoryUsage() const { return words.size() * sizeof(std::uint64_t); }
+
+    private:
+        std::uint64_t mask() const { return bits == 64 ? ~std::uint64_t { 0 } : (std::uint64_t { 1 } << bits) - 1; }
+
+        std::size_t bits;
+        std::vector<std::uint64_t> words;
+    };
+
+    // The encode and decode permutations of one key pair
+    struct Tables {
+        long long int n {};
+        PackedArray encoded;
+        PackedArray decoded;
+    };
+
+    // Fills both tables on Concurrency::defaultPool() as bulk work, in ranges of whole 64 entry words so no two workers write the same word
+    // Nothing is returned when 'n' is too big for tables to make sense, or when the private key has no CRT form
+    std::optional<Tables> build(const Key::Public& publicKey, const Key::Private& privateKey);
+
+    // Table lookups, nothing is returned if the number isn't in [0, n)
+    std::optional<long long int> encode(const Tables& tables, long long int m);
+
+    std::optional<long long int> decode(const Tables& tables, long long int c);
+}
+
+#endif
@@ -0,0 +1,42 @@
+#ifndef RSA_TUNING_HPP
+#define RSA_TUNING_HPP
+
+#include <cstddef>
+#include <optional>
+#include <ostream>
+#include <string>
+
+// Per-host tuning: the settings whose best value depends on the CPU, read from a profile file written by "rsa autotune"
+// The library never reads a profile by itself, it runs with the defaults below until the application hands it one with use().
+// Missing settings in a profile file fall back to the defaults too
+namespace Tuning {
+    enum class HashBatch { Auto, Serial, Lanes };
+
+    struct Profile {
+        std::size_t windowBits { 1 };               // Window width of Utility::Math::modPower, 1 is plain square-and-multiply
+        HashBatch hashBatch { HashBatch::Auto };    // Hash::sha256Batch: one message at a time (SHA-NI) or SIMD lanes. Auto picks SHA-NI if present
+        std::size_t asyncBatchSize { 256 };         // Most operations Async::defaultBatcher() runs in one batch
+    };
+
+    constexpr std::size_t maxWindowBits { 6 };
+
+    // Where the rsa command keeps its profile: "tuning.txt" in the current directory, or the file named by RSA_TUNING_PROFILE
+    std::string profileFilename();
+
+    // Unknown settings are skipped, so older builds can read profiles written by newer ones. Nothing is returned if the file
+    // can't be opened or a known setting isn't a whole non-negative number (or serial, lanes, auto for hashBatch)
+    std::optional<Profile> load(const std::string& filename);
+
+    bool save(const std::string& filename, const Profile& profile);
+
+    // The profile in use, the defaults until use() is called. Cheap, but callers in loops read it once, not per iteration
+    Profile current();
+
+    // Makes 'profile' the one in use. Meant for startup: batchers already created keep their batch size
+    void use(const Profile& profile);
+
+    // Measures the candidates of every setting on this machine and returns the fastest ones. Timings go to 'log'
+    Profile autotune(std::ostream& log);
+}
+
+#endif
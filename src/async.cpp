@@ -0,0 +1,121 @@
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <new>
+#include <optional>
+#include <utility>
+
+#include "rsa/async.hpp"
+#include "rsa/concurrency.hpp"
+#include "rsa/convert.hpp"
+#include "rsa/key.hpp"
+#include "rsa/padding.hpp"
+#include "rsa/rsa.hpp"
+#include "rsa/tuning.hpp"
+
+namespace Async {
+    Batcher::Batcher(Concurrency::WorkerPool& pool, size_t maxBatch)
+        : pool { pool }, maxBatch { std::max<size_t>(1, maxBatch) } {
+        batch.reserve(this->maxBatch);
+    }
+
+    void Batcher::add(Pending& operation) {
+        {
+            std::lock_guard lock { mutex };
+            pending.push_back(&operation);
+            if (isScheduled)
+                return;
+            isScheduled = true;
+        }
+        pool.submit([this] { flush(); });
+    }
+
+    void Batcher::run(Pending& operation) noexcept {
+        try {
+            switch (operation.kind) {
+            case Pending::Kind::Encode:
+                operation.result = encode(*operation.publicKey, operation.input);
+                break;
+            case Pending::Kind::Decode:
+                operation.result = decode(*operation.crtKey, operation.input);
+                break;
+            case Pending::Kind::Sign:
+                operation.signature = sign(*operation.signingKey, *operation.digest, operation.scheme);
+                break;
+            }
+        }
+        catch (...) {
+            operation.error = std::current_exception();
+        }
+    }
+
+    void Batcher::flush() {
+        while (true) {
+            {
+                std::lock_guard lock { mutex };
+                if (pending.empty()) {
+                    isScheduled = false;
+                    return;
+                }
+                const size_t taken { std::min(maxBatch, pending.size()) };
+                batch.assign(pending.begin(), pending.begin() + static_cast<std::ptrdiff_t>(taken));
+                pending.erase(pending.begin(), pending.begin() + static_cast<std::ptrdiff_t>(taken));
+            }
+            operations.fetch_add(batch.size(), std::memory_order_relaxed);
+            batches.fetch_add(1, std::memory_order_relaxed);
+
+            // Big batches are spread over the pool, then every coroutine is resumed here, on this pool thread
+            // parallelFor allocates its chunk tasks, if that fails the batch runs here instead
+            bool isRun { false };
+            if (batch.size() > 1) {
+                try {
+                    pool.parallelFor(batch.size(), [&](size_t i) { run(*batch[i]); });
+                    isRun = true;
+                }
+                catch (const std::bad_alloc&) {
+                }
+            }
+            if (!isRun)
+                for (Pending* operation : batch)
+                    run(*operation);
+
+            for (Pending* operation : batch)
+                operation->handle.resume();
+        }
+    }
+
+    Batcher::Statistics Batcher::statistics() const {
+        return Statistics { operations.load(std::memory_order_relaxed), batches.load(std::memory_order_relaxed) };
+    }
+
+    Batcher& defaultBatcher() {
+        static Batcher batcher { Concurrency::defaultPool(), Tuning::current().asyncBatchSize };
+        return batcher;
+    }
+
+    Operation<long long int> asyncEncode(const Key::Public& publicKey, long long int m, Batcher& batcher) {
+        Pending operation {};
+        operation.kind = Pending::Kind::Encode;
+        operation.publicKey = &publicKey;
+        operation.input = m;
+        return { std::move(operation), batcher };
+    }
+
+    Operation<long long int> asyncDecode(const Key::CRT& crtKey, long long int c, Batcher& batcher) {
+        Pending operation {};
+        operation.kind = Pending::Kind::Decode;
+        operation.crtKey = &crtKey;
+        operation.input = c;
+        return { std::move(operation), batcher };
+    }
+
+    Operation<std::optional<Utility::Bytes>> asyncSign(const Key::Wide::CRT& crtKey, const Utility::Bytes& digest, Padding::Signature::Scheme scheme, Batcher& batcher) {
+        Pending operation {};
+        operation.kind = Pending::Kind::Sign;
+        operation.signingKey = &crtKey;
+        operation.digest = &digest;
+        operation.scheme = scheme;
+        return { std::move(operation), batcher };
+    }
+}
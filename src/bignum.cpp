@@ -0,0 +1,450 @@
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cassert>
+#include <climits>
+#include <cstdint>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "rsa/bignum.hpp"
+#include "rsa/convert.hpp"
+#include "rsa/math.hpp"
+#include "rsa/random.hpp"
+
+namespace BigNum {
+    namespace Detail {
+        using Limb = Integer::Limb;
+
+        Integer fromLimbs(const std::vector<Limb>& limbs) {
+            Utility::Bytes bytes(8 * limbs.size());
+            for (size_t i { 0 }; i < bytes.size(); ++i)
+                bytes[bytes.size() - 1 - i] = static_cast<unsigned char>(limbs[i / 8] >> (8 * (i % 8)));
+            return Integer::fromBytes(bytes);
+        }
+    }
+
+    Integer::Integer(unsigned long long int x) {
+        if (x != 0)
+            limbs_.push_back(x);
+    }
+
+    Integer Integer::fromBytes(const Utility::Bytes& bytes) {
+        Integer x {};
+        x.limbs_.assign((bytes.size() + 7) / 8, 0);
+        for (size_t i { 0 }; i < bytes.size(); ++i)
+            x.limbs_[i / 8] |= static_cast<Limb>(bytes[bytes.size() - 1 - i]) << (8 * (i % 8));
+        x.trim();
+        return x;
+    }
+
+    std::optional<Utility::Bytes> Integer::toBytes(size_t length) const {
+        const size_t used { byteLength() };
+        if (used > length)
+            return std::nullopt;
+
+        Utility::Bytes bytes(length, 0);
+        for (size_t i { 0 }; i < used; ++i)
+            bytes[length - 1 - i] = static_cast<unsigned char>(limbs_[i / 8] >> (8 * (i % 8)));
+        return bytes;
+    }
+
+    std::optional<long long int> Integer::toInteger() const {
+        if (limbs_.size() > 1 || (limbs_.size() == 1 && limbs_[0] > static_cast<Limb>(LLONG_MAX)))
+            return std::nullopt;
+        return limbs_.empty() ? 0 : static_cast<long long int>(limbs_[0]);
+    }
+
+    size_t Integer::bitLength() const {
+        return limbs_.empty() ? 0 : 64 * limbs_.size() - static_cast<size_t>(std::countl_zero(limbs_.back()));
+    }
+
+    void Integer::setBit(size_t i) {
+        if (i / 64 >= limbs_.size())
+            limbs_.resize(i / 64 + 1, 0);
+        limbs_[i / 64] |= Limb { 1 } << (i % 64);
+    }
+
+    void Integer::trim() {
+        while (!limbs_.empty() && limbs_.back() == 0)
+            limbs_.pop_back();
+    }
+
+    std::strong_ordering operator<=>(const Integer& a, const Integer& b) {
+        if (a.limbs_.size() != b.limbs_.size())
+            return a.limbs_.size() <=> b.limbs_.size();
+        for (size_t i { a.limbs_.size() }; i-- > 0;)
+            if (a.limbs_[i] != b.limbs_[i])
+                return a.limbs_[i] <=> b.limbs_[i];
+        return std::strong_ordering::equal;
+    }
+
+    Integer operator+(const Integer& a, const Integer& b) {
+        const std::vector<Integer::Limb>& longer { a.limbs_.size() >= b.limbs_.size() ? a.limbs_ : b.limbs_ };
+        const std::vector<Integer::Limb>& shorter { a.limbs_.size() >= b.limbs_.size() ? b.limbs_ : a.limbs_ };
+
+        Integer sum {};
+        sum.limbs_.resize(longer.size() + 1);
+        unsigned __int128 carry { 0 };
+        for (size_t i { 0 }; i < longer.size(); ++i) {
+            carry += static_cast<unsigned __int128>(longer[i]) + (i < shorter.size() ? shorter[i] : 0);
+            sum.limbs_[i] = static_cast<Integer::Limb>(carry);
+            carry >>= 64;
+        }
+        sum.limbs_.back() = static_cast<Integer::Limb>(carry);
+        sum.trim();
+        return sum;
+    }
+
+    Integer operator-(const Integer& a, const Integer& b) {
+        assert(b <= a && "ERROR: the difference of two BigNum::Integer can't be negative.");
+
+        Integer difference { a };
+        Integer::Limb borrow { 0 };
+        for (size_t i { 0 }; i < difference.limbs_.size(); ++i) {
+            const Integer::Limb subtrahend { i < b.limbs_.size() ? b.limbs_[i] : 0 };
+            const Integer::Limb limb { difference.limbs_[i] };
+            difference.limbs_[i] = limb - subtrahend - borrow;
+            borrow = limb < subtrahend || (limb == subtrahend && borrow != 0) ? 1 : 0;
+            if (borrow == 0 && i + 1 >= b.limbs_.size())
+                break;
+        }
+        difference.trim();
+        return difference;
+    }
+
+    Integer operator*(const Integer& a, const Integer& b) {
+        if (a.isZero() || b.isZero())
+            return Integer {};
+
+        Integer product {};
+        product.limbs_.assign(a.limbs_.size() + b.limbs_.size(), 0);
+        for (size_t i { 0 }; i < a.limbs_.size(); ++i) {
+            unsigned __int128 carry { 0 };
+            for (size_t j { 0 }; j < b.limbs_.size(); ++j) {
+                carry += static_cast<unsigned __int128>(a.limbs_[i]) * b.limbs_[j] + product.limbs_[i + j];
+                product.limbs_[i + j] = static_cast<Integer::Limb>(carry);
+                carry >>= 64;
+            }
+            product.limbs_[i + b.limbs_.size()] = static_cast<Integer::Limb>(carry);
+        }
+        product.trim();
+        return product;
+    }
+
+    Integer operator<<(const Integer& x, size_t bits) {
+        if (x.isZero())
+            return Integer {};
+
+        const size_t limbShift { bits / 64 }, bitShift { bits % 64 };
+        Integer shifted {};
+        shifted.limbs_.assign(x.limbs_.size() + limbShift + 1, 0);
+        for (size_t i { 0 }; i < x.limbs_.size(); ++i) {
+            shifted.limbs_[i + limbShift] |= x.limbs_[i] << bitShift;
+            if (bitShift != 0)
+                shifted.limbs_[i + limbShift + 1] = x.limbs_[i] >> (64 - bitShift);
+        }
+        shifted.trim();
+        return shifted;
+    }
+
+    Integer operator>>(const Integer& x, size_t bits) {
+        const size_t limbShift { bits / 64 }, bitShift { bits % 64 };
+        if (limbShift >= x.limbs_.size())
+            return Integer {};
+
+        Integer shifted {};
+        shifted.limbs_.assign(x.limbs_.size() - limbShift, 0);
+        for (size_t i { 0 }; i < shifted.limbs_.size(); ++i) {
+            shifted.limbs_[i] = x.limbs_[i + limbShift] >> bitShift;
+            if (bitShift != 0 && i + limbShift + 1 < x.limbs_.size())
+                shifted.limbs_[i] |= x.limbs_[i + limbShift + 1] << (64 - bitShift);
+        }
+        shifted.trim();
+        return shifted;
+    }
+
+    std::pair<Integer, Integer> divide(const Integer& a, const Integer& b) {
+        assert(!b.isZero() && "ERROR: division of a BigNum::Integer by 0.");
+        using Limb = Integer::Limb;
+
+        if (a < b)
+            return { Integer {}, a };
+
+        const std::vector<Limb>& divisor { b.limbs() };
+        if (divisor.size() == 1) {
+            std::vector<Limb> quotient(a.limbs().size());
+            unsigned __int128 rest { 0 };
+            for (size_t i { a.limbs().size() }; i-- > 0;) {
+                rest = (rest << 64) | a.limbs()[i];
+                quotient[i] = static_cast<Limb>(rest / divisor[0]);
+                rest %= divisor[0];
+            }
+
+            return { Detail::fromLimbs(quotient), Integer { static_cast<Limb>(rest) } };
+        }
+
+        // Both numbers are shifted so the top limb of the divisor has its top bit set, then every quotient limb is estimated
+        // from the top two limbs of the remainder and corrected at most twice
+        const int shift { std::countl_zero(divisor.back()) };
+        const std::vector<Limb> v { (b << static_cast<size_t>(shift)).limbs() };
+        std::vector<Limb> u { (a << static_cast<size_t>(shift)).limbs() };
+        u.resize(a.limbs().size() + 1, 0);
+
+        const size_t n { v.size() };
+        const size_t m { a.limbs().size() - n };
+        std::vector<Limb> quotient(m + 1, 0);
+        constexpr unsigned __int128 base { static_cast<unsigned __int128>(1) << 64 };
+
+        for (size_t j { m + 1 }; j-- > 0;) {
+            const unsigned __int128 top { (static_cast<unsigned __int128>(u[j + n]) << 64) | u[j + n - 1] };
+            unsigned __int128 qhat { top / v[n - 1] };
+            unsigned __int128 rhat { top % v[n - 1] };
+            while (qhat >= base || qhat * v[n - 2] > ((rhat << 64) | u[j + n - 2])) {
+                --qhat;
+                rhat += v[n - 1];
+                if (rhat >= base)
+                    break;
+            }
+
+            // u[j .. j + n] -= qhat * v
+            __int128 borrow { 0 };
+            for (size_t i { 0 }; i < n; ++i) {
+                const unsigned __int128 product { qhat * v[i] };
+                const __int128 t { static_cast<__int128>(u[i + j]) - borrow - static_cast<__int128>(static_cast<Limb>(product)) };
+                u[i + j] = static_cast<Limb>(t);
+                borrow = static_cast<__int128>(product >> 64) - (t >> 64);
+            }
+            const __int128 t { static_cast<__int128>(u[j + n]) - borrow };
+            u[j + n] = static_cast<Limb>(t);
+
+            quotient[j] = static_cast<Limb>(qhat);
+            if (t < 0) {
+                // qhat was one too big, add v back
+                --quotient[j];
+                unsigned __int128 carry { 0 };
+                for (size_t i { 0 }; i < n; ++i) {
+                    carry += static_cast<unsigned __int128>(u[i + j]) + v[i];
+                    u[i + j] = static_cast<Limb>(carry);
+                    carry >>= 64;
+                }
+                u[j + n] += static_cast<Limb>(carry);
+            }
+        }
+
+        u.resize(n);
+        return { Detail::fromLimbs(quotient), Detail::fromLimbs(u) >> static_cast<size_t>(shift) };
+    }
+
+    std::uint64_t remainder(const Integer& a, std::uint64_t b) {
+        assert(b != 0 && "ERROR: division of a BigNum::Integer by 0.");
+
+        unsigned __int128 rest { 0 };
+        for (size_t i { a.limbs().size() }; i-- > 0;)
+            rest = ((rest << 64) | a.limbs()[i]) % b;
+        return static_cast<std::uint64_t>(rest);
+    }
+
+    namespace Detail {
+        // Montgomery arithmetic modulo an odd 'modulus' of 'size' limbs, with R = 2 ^ (64 * size)
+        // Numbers are kept as 'size' limbs, zero padded, and in Montgomery form x * R mod modulus
+        class Montgomery {
+        public:
+            explicit Montgomery(const Integer& modulus)
+                : n { modulus.limbs() }, size { n.size() }, scratch(size + 2) {
+                // n0' = -n^-1 mod 2^64 by Newton's iteration, n[0] is already its own inverse modulo 8 (3 bits), every step doubles that
+                Limb inverse { n[0] };
+                for (int i { 0 }; i < 5; ++i)
+                    inverse *= 2 - n[0] * inverse;
+                nPrime = 0 - inverse;
+
+                rSquared = limbsOf((Integer { 1 } << (128 * size)) % modulus);
+            }
+
+            std::vector<Limb> limbsOf(const Integer& x) const {
+                std::vector<Limb> limbs { x.limbs() };
+                limbs.resize(size, 0);
+                return limbs;
+            }
+
+            // result = a * b * R^-1 mod n (CIOS), 'result' may be 'a' or 'b'
+            void multiply(const Limb* a, const Limb* b, Limb* result) {
+                // Locals, so the compiler doesn't reload them after every store to 't' (they are all 64 bit words)
+                const Limb* const modulus { n.data() };
+                const size_t limbs { size };
+                const Limb prime { nPrime };
+                Limb* const t { scratch.data() };
+                std::fill(t, t + limbs + 2, 0);
+
+                for (size_t i { 0 }; i < limbs; ++i) {
+                    const Limb bi { b[i] };
+                    unsigned __int128 carry { 0 };
+                    for (size_t j { 0 }; j < limbs; ++j) {
+                        carry += static_cast<unsigned __int128>(a[j]) * bi + t[j];
+                        t[j] = static_cast<Limb>(carry);
+                        carry >>= 64;
+                    }
+                    carry += t[limbs];
+                    t[limbs] = static_cast<Limb>(carry);
+                    t[limbs + 1] = static_cast<Limb>(carry >> 64);
+
+                    const Limb m { t[0] * prime };
+                    carry = static_cast<unsigned __int128>(m) * modulus[0] + t[0];
+                    carry >>= 64;
+                    for (size_t j { 1 }; j < limbs; ++j) {
+                        carry += static_cast<unsigned __int128>(m) * modulus[j] + t[j];
+                        t[j - 1] = static_cast<Limb>(carry);
+                        carry >>= 64;
+                    }
+                    carry += t[limbs];
+                    t[limbs - 1] = static_cast<Limb>(carry);
+                    t[limbs] = t[limbs + 1] + static_cast<Limb>(carry >> 64);
+                }
+
+                // t < 2n, one subtraction brings it below n
+                bool isBelow { false };
+                if (t[limbs] == 0)
+                    for (size_t i { limbs }; i-- > 0;)
+                        if (t[i] != modulus[i]) {
+                            isBelow = t[i] < modulus[i];
+                            break;
+                        }
+                if (isBelow) {
+                    std::copy(t, t + limbs, result);
+                    return;
+                }
+
+                Limb borrow { 0 };
+                for (size_t i { 0 }; i < limbs; ++i) {
+                    const Limb limb { t[i] };
+                    result[i] = limb - modulus[i] - borrow;
+                    borrow = limb < modulus[i] || (limb == modulus[i] && borrow != 0) ? 1 : 0;
+                }
+            }
+
+            const std::vector<Limb>& n;
+            const size_t size;
+            Limb nPrime {};
+            std::vector<Limb> rSquared {};
+
+        private:
+            std::vector<Limb> scratch;
+        };
+    }
+
+    Integer modPower(const Integer& x, const Integer& exponent, const Integer& modulus) {
+        assert(!modulus.isZero() && "ERROR: modular power with a modulus of 0.");
+        if (modulus == Integer { 1 })
+            return Integer {};
+
+        if (!modulus.isOdd()) {
+            Integer result { 1 };
+            const Integer base { x % modulus };
+            for (size_t i { exponent.bitLength() }; i-- > 0;) {
+                result = (result * result) % modulus;
+                if (exponent.bit(i))
+                    result = (result * base) % modulus;
+            }
+            return result;
+        }
+
+        using Detail::Limb;
+        constexpr size_t windowBits { 4 };
+        Detail::Montgomery montgomery { modulus };
+        const size_t size { montgomery.size };
+
+        // table[i] = x^i in Montgomery form
+        std::vector<std::vector<Limb>> table(size_t { 1 } << windowBits, std::vector<Limb>(size));
+        std::vector<Limb> one(size, 0);
+        one[0] = 1;
+        montgomery.multiply(one.data(), montgomery.rSquared.data(), table[0].data());
+        const std::vector<Limb> base { montgomery.limbsOf(x % modulus) };
+        montgomery.multiply(base.data(), montgomery.rSquared.data(), table[1].data());
+        for (size_t i { 2 }; i < table.size(); ++i)
+            montgomery.multiply(table[i - 1].data(), table[1].data(), table[i].data());
+
+        std::vector<Limb> result { table[0] };
+        const size_t windows { (exponent.bitLength() + windowBits - 1) / windowBits };
+        for (size_t window { windows }; window-- > 0;) {
+            for (size_t i { 0 }; i < windowBits; ++i)
+                montgomery.multiply(result.data(), result.data(), result.data());
+
+            size_t digit { 0 };
+            for (size_t i { windowBits }; i-- > 0;)
+                digit = (digit << 1) | (exponent.bit(window * windowBits + i) ? 1 : 0);
+            if (digit != 0)
+                montgomery.multiply(result.data(), table[digit].data(), result.data());
+        }
+
+        // Out of Montgomery form
+        montgomery.multiply(result.data(), one.data(), result.data());
+        return Detail::fromLimbs(result);
+    }
+
+    std::optional<Integer> modInverse(const Integer& a, const Integer& modulus) {
+        if (modulus < Integer { 2 })
+            return std::nullopt;
+
+        // Only the coefficient of 'a' is tracked, and kept in [0, modulus) so nothing goes negative
+        Integer previousRest { modulus }, rest { a % modulus };
+        Integer previousCoefficient {}, coefficient { 1 };
+        while (!rest.isZero()) {
+            const auto [quotient, nextRest] { divide(previousRest, rest) };
+            const Integer product { (quotient * coefficient) % modulus };
+            Integer nextCoefficient { previousCoefficient >= product ? previousCoefficient - product : previousCoefficient + modulus - product };
+
+            previousRest = std::exchange(rest, nextRest);
+            previousCoefficient = std::exchange(coefficient, std::move(nextCoefficient));
+        }
+
+        if (previousRest != Integer { 1 })
+            return std::nullopt;
+        return previousCoefficient;
+    }
+
+    Integer random(size_t bits) {
+        Utility::Bytes bytes((bits + 7) / 8);
+        Utility::Random::fill(bytes);
+        if (bits % 8 != 0)
+            bytes[0] &= static_cast<unsigned char>((1u << (bits % 8)) - 1);
+        return Integer::fromBytes(bytes);
+    }
+
+    bool millerRabin(const Integer& x, size_t rounds) {
+        if (x < Integer { 2 })
+            return false;
+        for (const int prime : Utility::Math::smallPrimes) {
+            if (x == Integer { static_cast<unsigned long long int>(prime) })
+                return true;
+            if (remainder(x, static_cast<std::uint64_t>(prime)) == 0)
+                return false;
+        }
+
+        // x - 1 = d * 2^s with d odd
+        const Integer xMinusOne { x - Integer { 1 } };
+        size_t s { 0 };
+        while (!xMinusOne.bit(s))
+            ++s;
+        const Integer d { xMinusOne >> s };
+
+        // Bases are drawn from [2, x - 2], x is past the small primes so that range isn't empty
+        const Integer baseRange { x - Integer { 3 } };
+        for (size_t round { 0 }; round < rounds; ++round) {
+            const Integer base { random(x.bitLength() + 64) % baseRange + Integer { 2 } };
+
+            Integer y { modPower(base, d, x) };
+            if (y == Integer { 1 } || y == xMinusOne)
+                continue;
+
+            bool isWitness { true };
+            for (size_t i { 1 }; i < s && isWitness; ++i) {
+                y = (y * y) % x;
+                isWitness = y != xMinusOne;
+            }
+            if (isWitness)
+                return false;
+        }
+        return true;
+    }
+}
@@ -0,0 +1,45 @@
+#include <optional>
+
+#include "rsa/cache.hpp"
+#include "rsa/convert.hpp"
+#include "rsa/hash.hpp"
+#include "rsa/key.hpp"
+#include "rsa/padding.hpp"
+#include "rsa/rsa.hpp"
+
+namespace Cache {
+    Id signatureId(const Key::Wide::Private& privateKey, const Utility::Bytes& digest, Padding::Signature::Scheme scheme) {
+        return makeId(Hash::fingerprint(privateKey), digest, Utility::Bytes { static_cast<unsigned char>(scheme) });
+    }
+
+    Id verificationId(const Key::Wide::Public& publicKey, const Utility::Bytes& digest, const Utility::Bytes& signature, Padding::Signature::Scheme scheme) {
+        return makeId(Hash::fingerprint(publicKey), digest, signature, Utility::Bytes { static_cast<unsigned char>(scheme) });
+    }
+}
+
+std::optional<Utility::Bytes> signCached(const Key::Wide::Private& privateKey, const Utility::Bytes& digest, Cache::Signatures& cache, Padding::Signature::Scheme scheme) {
+    // A PSS signature carries a fresh random salt, handing out a stored one would make two signatures of a digest identical
+    if (scheme == Padding::Signature::Scheme::PSS)
+        return sign(privateKey, digest, scheme);
+
+    const Cache::Id id { Cache::signatureId(privateKey, digest, scheme) };
+
+    if (std::optional<Utility::Bytes> signature { cache.find(id) })
+        return *signature;
+
+    std::optional<Utility::Bytes> signature { sign(privateKey, digest, scheme) };
+    if (signature)
+        cache.insert(id, *signature);
+    return signature;
+}
+
+bool verifyCached(const Key::Wide::Public& publicKey, const Utility::Bytes& digest, const Utility::Bytes& signature, Cache::Verifications& cache, Padding::Signature::Scheme scheme) {
+    const Cache::Id id { Cache::verificationId(publicKey, digest, signature, scheme) };
+
+    if (std::optional<bool> isValid { cache.find(id) })
+        return *isValid;
+
+    const bool isValid { verify(publicKey, digest, signature, scheme) };
+    cache.insert(id, isValid);
+    return isValid;
+}
@@ -0,0 +1,452 @@
+#include <cstring>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <optional>
+#include <shared_mutex>
+#include <utility>
+
+#include "rsa/bignum.hpp"
+#include "rsa/concurrency.hpp"
+#include "rsa/convert.hpp"
+#include "rsa/file.hpp"
+#include "rsa/generate.hpp"
+#include "rsa/key.hpp"
+#include "rsa/padding.hpp"
+#include "rsa/rsa.h"
+#include "rsa/rsa.hpp"
+
+// C interface of the shared library (rsa/rsa.h). Every entry point turns bad arguments and exceptions into an rsa_status,
+// nothing may unwind into C code, and nothing the asserts of the C++ side would catch reaches it
+struct rsa_public_key {
+    Key::Wide::Public key;
+    std::optional<Key::Public> narrowKey;   // Only when n and e fit a long long int, for rsa_encode_batch
+    size_t k;
+};
+
+struct rsa_private_key {
+    Key::Wide::CRT crtKey;
+    BigNum::Integer n;
+    std::optional<Key::CRT> narrowCrtKey;   // Only when n fits a long long int, for rsa_decode_batch
+    size_t k;
+};
+
+namespace CInterface {
+    // Batches shorter than this run on the calling thread, handing them to the pool costs more than it saves
+    constexpr size_t parallelThreshold { 64 };
+
+    // Pool chosen with rsa_thread_pool_configure(). Batches hold the lock shared, so they never see the pool swapped under them
+    std::shared_mutex poolMutex {};
+    std::unique_ptr<Concurrency::WorkerPool> configuredPool {};
+    bool isInline { false };
+
+    // An exception thrown on a pool thread would end the host process, so it is caught there and rethrown on the calling
+    // thread, where guarded() turns it into a status
+    template <typename Body>
+    void forEach(size_t count, Body&& body) {
+        std::shared_lock lock { poolMutex };
+
+        if (isInline || count < parallelThreshold) {
+            for (size_t i { 0 }; i < count; ++i)
+                body(i);
+            return;
+        }
+
+        std::mutex errorMutex {};
+        std::exception_ptr error {};
+        Concurrency::WorkerPool& pool { configuredPool ? *configuredPool : Concurrency::defaultPool() };
+        pool.parallelFor(count, [&](size_t i) {
+            try {
+                body(i);
+            } catch (...) {
+                std::lock_guard errorLock { errorMutex };
+                if (!error)
+                    error = std::current_exception();
+            }
+        });
+
+        if (error)
+            std::rethrow_exception(error);
+    }
+
+    template <typename Function>
+    rsa_status guarded(Function&& function) noexcept {
+        try {
+            return function();
+        } catch (const std::bad_alloc&) {
+            return RSA_ERROR_OUT_OF_MEMORY;
+        } catch (...) {
+            return RSA_ERROR_INTERNAL;
+        }
+    }
+
+    BigNum::Integer toInteger(const uint8_t* bytes, size_t length) {
+        return length == 0 ? BigNum::Integer {} : BigNum::Integer::fromBytes(Utility::Bytes(bytes, bytes + length));
+    }
+
+    // Miller-Rabin rounds for the primes of a key handed in from outside, a composite passes with a probability below 4^-32
+    constexpr size_t primalityRounds { 32 };
+
+    std::optional<rsa_public_key> makePublic(const BigNum::Integer& n, const BigNum::Integer& e) {
+        if (n < BigNum::Integer { 2 } || e.isZero())
+            return std::nullopt;
+
+        std::optional<Key::Public> narrowKey {};
+        if (const std::optional<long long int> narrowN { n.toInteger() }, narrowE { e.toInteger() }; narrowN && narrowE)
+            narrowKey = Key::Public { *narrowN, *narrowE };
+        return rsa_public_key { Key::Wide::Public { n, e }, narrowKey, n.byteLength() };
+    }
+
+    std::optional<rsa_public_key> makePublic(long long int n, long long int e) {
+        if (n < 2 || e < 1)
+            return std::nullopt;
+        return makePublic(BigNum::Integer { static_cast<unsigned long long int>(n) }, BigNum::Integer { static_cast<unsigned long long int>(e) });
+    }
+
+    // p and q must be distinct primes and d invertible modulo (p - 1) * (q - 1), anything else would give a key that
+    // silently decodes to garbage
+    std::optional<rsa_private_key> makePrivate(const BigNum::Integer& p, const BigNum::Integer& q, const BigNum::Integer& d) {
+        const BigNum::Integer one { 1 };
+        if (p <= one || q <= one || p == q || d.isZero())
+            return std::nullopt;
+        if (!BigNum::millerRabin(p, primalityRounds) || !BigNum::millerRabin(q, primalityRounds) || !BigNum::modInverse(d, (p - one) * (q - one)))
+            return std::nullopt;
+
+        std::optional<Key::Wide::CRT> crtKey { Generate::crt(Key::Wide::Private { p, q, d }) };
+        if (!crtKey)
+            return std::nullopt;
+
+        // d only matters modulo (p - 1) * (q - 1), reduced it fits a long long int whenever n does
+        const BigNum::Integer n { p * q };
+        std::optional<Key::CRT> narrowCrtKey {};
+        if (n.toInteger())
+            narrowCrtKey = Generate::crt(Key::Private { *p.toInteger(), *q.toInteger(), *(d % ((p - one) * (q - one))).toInteger() });
+        return rsa_private_key { std::move(*crtKey), n, narrowCrtKey, n.byteLength() };
+    }
+
+    std::optional<rsa_private_key> makePrivate(long long int p, long long int q, long long int d) {
+        long long int n {};
+        if (p < 2 || q < 2 || d < 1 || __builtin_mul_overflow(p, q, &n))
+            return std::nullopt;
+        return makePrivate(BigNum::Integer { static_cast<unsigned long long int>(p) }, BigNum::Integer { static_cast<unsigned long long int>(q) }, BigNum::Integer { static_cast<unsigned long long int>(d) });
+    }
+
+    // The padding and signature encoders would fail every item of the batch on a modulus too short for them, the length is
+    // checked once here so the caller gets RSA_ERROR_KEY_TOO_SMALL instead of a batch of invalid results
+    bool fitsPadding(size_t k, rsa_padding padding) {
+        return padding == RSA_PADDING_OAEP ? k >= 2 * Padding::OAEP::hashLength + 2 : k >= Padding::PKCS1::minimumPaddingLength + 3;
+    }
+
+    bool fitsSignature(const BigNum::Integer& n, rsa_signature_scheme scheme) {
+        if (scheme == RSA_SIGNATURE_PKCS1)
+            return n.byteLength() >= Padding::Signature::minimumKeySize(Padding::Signature::Scheme::PKCS1);
+        return (n.bitLength() - 1 + 7) / 8 >= Padding::Signature::PSS::hashLength + Padding::Signature::PSS::saltLength + 2;
+    }
+
+    bool isPadding(rsa_padding padding) {
+        return padding == RSA_PADDING_OAEP || padding == RSA_PADDING_PKCS1;
+    }
+
+    bool isSignatureScheme(rsa_signature_scheme scheme) {
+        return scheme == RSA_SIGNATURE_PKCS1 || scheme == RSA_SIGNATURE_PSS;
+    }
+
+    Padding::Scheme toScheme(rsa_padding padding) {
+        return padding == RSA_PADDING_OAEP ? Padding::Scheme::OAEP : Padding::Scheme::PKCS1;
+    }
+
+    Padding::Signature::Scheme toScheme(rsa_signature_scheme scheme) {
+        return scheme == RSA_SIGNATURE_PKCS1 ? Padding::Signature::Scheme::PKCS1 : Padding::Signature::Scheme::PSS;
+    }
+}
+
+extern "C" {
+
+uint32_t rsa_abi_version(void) {
+    return RSA_ABI_VERSION;
+}
+
+const char* rsa_status_string(rsa_status status) {
+    switch (status) {
+        case RSA_OK: return "success";
+        case RSA_ERROR_INVALID_ARGUMENT: return "invalid argument";
+        case RSA_ERROR_IO: return "key file can't be read";
+        case RSA_ERROR_INVALID_INPUT: return "invalid input";
+        case RSA_ERROR_KEY_TOO_SMALL: return "modulus too short for this scheme";
+        case RSA_ERROR_OUT_OF_MEMORY: return "out of memory";
+        case RSA_ERROR_INTERNAL: return "internal error";
+        case RSA_ERROR_KEY_TOO_LARGE: return "modulus too long for 63 bit numbers";
+    }
+    return "unknown status";
+}
+
+rsa_status rsa_public_key_create(int64_t n, int64_t e, rsa_public_key** key) {
+    return CInterface::guarded([&] {
+        if (key == nullptr)
+            return RSA_ERROR_INVALID_ARGUMENT;
+
+        const std::optional<rsa_public_key> publicKey { CInterface::makePublic(n, e) };
+        if (!publicKey)
+            return RSA_ERROR_INVALID_ARGUMENT;
+
+        *key = new rsa_public_key { *publicKey };
+        return RSA_OK;
+    });
+}
+
+rsa_status rsa_public_key_load(const char* filename, rsa_public_key** key) {
+    return CInterface::guarded([&] {
+        if (filename == nullptr || key == nullptr)
+            return RSA_ERROR_INVALID_ARGUMENT;
+
+        const std::optional<Key::Public> loaded { Utility::File::loadPublic(filename) };
+        if (!loaded)
+            return RSA_ERROR_IO;
+
+        const std::optional<rsa_public_key> publicKey { CInterface::makePublic(loaded->n, loaded->e) };
+        if (!publicKey)
+            return RSA_ERROR_IO;
+
+        *key = new rsa_public_key { *publicKey };
+        return RSA_OK;
+    });
+}
+
+void rsa_public_key_free(rsa_public_key* key) {
+    delete key;
+}
+
+size_t rsa_public_key_size(const rsa_public_key* key) {
+    return key == nullptr ? 0 : key->k;
+}
+
+rsa_status rsa_public_key_create_from_bytes(const uint8_t* n, size_t n_length, const uint8_t* e, size_t e_length, rsa_public_key** key) {
+    return CInterface::guarded([&] {
+        if (key == nullptr || (n_length > 0 && n == nullptr) || (e_length > 0 && e == nullptr))
+            return RSA_ERROR_INVALID_ARGUMENT;
+
+        const std::optional<rsa_public_key> publicKey { CInterface::makePublic(CInterface::toInteger(n, n_length), CInterface::toInteger(e, e_length)) };
+        if (!publicKey)
+            return RSA_ERROR_INVALID_ARGUMENT;
+
+        *key = new rsa_public_key { *publicKey };
+        return RSA_OK;
+    });
+}
+
+rsa_status rsa_private_key_create(int64_t p, int64_t q, int64_t d, rsa_private_key** key) {
+    return CInterface::guarded([&] {
+        if (key == nullptr)
+            return RSA_ERROR_INVALID_ARGUMENT;
+
+        const std::optional<rsa_private_key> privateKey { CInterface::makePrivate(p, q, d) };
+        if (!privateKey)
+            return RSA_ERROR_INVALID_ARGUMENT;
+
+        *key = new rsa_private_key { *privateKey };
+        return RSA_OK;
+    });
+}
+
+rsa_status rsa_private_key_load(const char* filename, rsa_private_key** key) {
+    return CInterface::guarded([&] {
+        if (filename == nullptr || key == nullptr)
+            return RSA_ERROR_INVALID_ARGUMENT;
+
+        const std::optional<Key::Private> loaded { Utility::File::loadPrivate(filename) };
+        if (!loaded)
+            return RSA_ERROR_IO;
+
+        const std::optional<rsa_private_key> privateKey { CInterface::makePrivate(loaded->p, loaded->q, loaded->d) };
+        if (!privateKey)
+            return RSA_ERROR_IO;
+
+        *key = new rsa_private_key { *privateKey };
+        return RSA_OK;
+    });
+}
+
+void rsa_private_key_free(rsa_private_key* key) {
+    delete key;
+}
+
+size_t rsa_private_key_size(const rsa_private_key* key) {
+    return key == nullptr ? 0 : key->k;
+}
+
+rsa_status rsa_private_key_create_from_bytes(const uint8_t* p, size_t p_length, const uint8_t* q, size_t q_length, const uint8_t* d, size_t d_length, rsa_private_key** key) {
+    return CInterface::guarded([&] {
+        if (key == nullptr || (p_length > 0 && p == nullptr) || (q_length > 0 && q == nullptr) || (d_length > 0 && d == nullptr))
+            return RSA_ERROR_INVALID_ARGUMENT;
+
+        const std::optional<rsa_private_key> privateKey { CInterface::makePrivate(CInterface::toInteger(p, p_length), CInterface::toInteger(q, q_length), CInterface::toInteger(d, d_length)) };
+        if (!privateKey)
+            return RSA_ERROR_INVALID_ARGUMENT;
+
+        *key = new rsa_private_key { *privateKey };
+        return RSA_OK;
+    });
+}
+
+rsa_status rsa_key_pair_generate(size_t modulus_bits, rsa_public_key** public_key, rsa_private_key** private_key) {
+    return CInterface::guarded([&] {
+        if (public_key == nullptr || private_key == nullptr)
+            return RSA_ERROR_INVALID_ARGUMENT;
+
+        const std::optional<Generate::WideKeyPair> pair { Generate::randomWideKeyPair(modulus_bits) };
+        if (!pair)
+            return RSA_ERROR_INVALID_ARGUMENT;
+
+        const std::optional<rsa_public_key> publicKey { CInterface::makePublic(pair->publicKey.n, pair->publicKey.e) };
+        const std::optional<rsa_private_key> privateKey { CInterface::makePrivate(pair->privateKey.p, pair->privateKey.q, pair->privateKey.d) };
+        if (!publicKey || !privateKey)
+            return RSA_ERROR_INTERNAL;
+
+        std::unique_ptr<rsa_public_key> publicHandle { new rsa_public_key { *publicKey } };
+        *private_key = new rsa_private_key { *privateKey };
+        *public_key = publicHandle.release();
+        return RSA_OK;
+    });
+}
+
+rsa_status rsa_encode_batch(const rsa_public_key* key, const int64_t* messages, int64_t* ciphertexts, size_t count) {
+    return CInterface::guarded([&] {
+        if (key == nullptr || (count > 0 && (messages == nullptr || ciphertexts == nullptr)))
+            return RSA_ERROR_INVALID_ARGUMENT;
+
+        if (!key->narrowKey)
+            return RSA_ERROR_KEY_TOO_LARGE;
+
+        const Key::Public& publicKey { *key->narrowKey };
+        for (size_t i { 0 }; i < count; ++i)
+            if (messages[i] < 0 || messages[i] >= publicKey.n)
+                return RSA_ERROR_INVALID_INPUT;
+
+        CInterface::forEach(count, [&](size_t i) {
+            ciphertexts[i] = encode(publicKey, messages[i]);
+        });
+        return RSA_OK;
+    });
+}
+
+rsa_status rsa_decode_batch(const rsa_private_key* key, const int64_t* ciphertexts, int64_t* messages, size_t count) {
+    return CInterface::guarded([&] {
+        if (key == nullptr || (count > 0 && (ciphertexts == nullptr || messages == nullptr)))
+            return RSA_ERROR_INVALID_ARGUMENT;
+
+        if (!key->narrowCrtKey)
+            return RSA_ERROR_KEY_TOO_LARGE;
+
+        const Key::CRT& crtKey { *key->narrowCrtKey };
+        const long long int n { crtKey.p * crtKey.q };
+        for (size_t i { 0 }; i < count; ++i)
+            if (ciphertexts[i] < 0 || ciphertexts[i] >= n)
+                return RSA_ERROR_INVALID_INPUT;
+
+        CInterface::forEach(count, [&](size_t i) {
+            messages[i] = decode(crtKey, ciphertexts[i]);
+        });
+        return RSA_OK;
+    });
+}
+
+rsa_status rsa_encrypt_batch(const rsa_public_key* key, rsa_padding padding, const uint8_t* messages, size_t message_stride,
+                             const size_t* message_lengths, size_t count, uint8_t* ciphertexts) {
+    return CInterface::guarded([&] {
+        if (key == nullptr || !CInterface::isPadding(padding) || (count > 0 && (messages == nullptr || message_lengths == nullptr || ciphertexts == nullptr)))
+            return RSA_ERROR_INVALID_ARGUMENT;
+        if (!CInterface::fitsPadding(key->k, padding))
+            return RSA_ERROR_KEY_TOO_SMALL;
+
+        const size_t maxLength { Padding::maxMessageLength(key->k, CInterface::toScheme(padding)) };
+        for (size_t i { 0 }; i < count; ++i)
+            if (message_lengths[i] > maxLength || message_lengths[i] > message_stride)
+                return RSA_ERROR_INVALID_INPUT;
+
+        CInterface::forEach(count, [&](size_t i) {
+            const uint8_t* const message { messages + i * message_stride };
+            const std::optional<Utility::Bytes> ciphertext { encrypt(key->key, Utility::Bytes(message, message + message_lengths[i]), CInterface::toScheme(padding)) };
+            if (ciphertext)
+                std::memcpy(ciphertexts + i * key->k, ciphertext->data(), key->k);
+        });
+        return RSA_OK;
+    });
+}
+
+rsa_status rsa_decrypt_batch(const rsa_private_key* key, rsa_padding padding, const uint8_t* ciphertexts, size_t count,
+                             uint8_t* plaintexts, size_t plaintext_stride, size_t* plaintext_lengths, uint8_t* valid) {
+    return CInterface::guarded([&] {
+        if (key == nullptr || !CInterface::isPadding(padding) || (count > 0 && (ciphertexts == nullptr || plaintexts == nullptr || plaintext_lengths == nullptr || valid == nullptr)))
+            return RSA_ERROR_INVALID_ARGUMENT;
+        if (!CInterface::fitsPadding(key->k, padding))
+            return RSA_ERROR_KEY_TOO_SMALL;
+
+        CInterface::forEach(count, [&](size_t i) {
+            const uint8_t* const ciphertext { ciphertexts + i * key->k };
+            const std::optional<Utility::Bytes> plaintext { decrypt(key->crtKey, Utility::Bytes(ciphertext, ciphertext + key->k), CInterface::toScheme(padding)) };
+
+            valid[i] = plaintext && plaintext->size() <= plaintext_stride;
+            plaintext_lengths[i] = valid[i] ? plaintext->size() : 0;
+            if (valid[i])
+                std::memcpy(plaintexts + i * plaintext_stride, plaintext->data(), plaintext->size());
+        });
+        return RSA_OK;
+    });
+}
+
+rsa_status rsa_sign_batch(const rsa_private_key* key, rsa_signature_scheme scheme, const uint8_t* digests, size_t count, uint8_t* signatures) {
+    return CInterface::guarded([&] {
+        if (key == nullptr || !CInterface::isSignatureScheme(scheme) || (count > 0 && (digests == nullptr || signatures == nullptr)))
+            return RSA_ERROR_INVALID_ARGUMENT;
+        if (!CInterface::fitsSignature(key->n, scheme))
+            return RSA_ERROR_KEY_TOO_SMALL;
+
+        CInterface::forEach(count, [&](size_t i) {
+            const uint8_t* const digest { digests + i * RSA_DIGEST_SIZE };
+            const std::optional<Utility::Bytes> signature { sign(key->crtKey, Utility::Bytes(digest, digest + RSA_DIGEST_SIZE), CInterface::toScheme(scheme)) };
+            if (signature)
+                std::memcpy(signatures + i * key->k, signature->data(), key->k);
+        });
+        return RSA_OK;
+    });
+}
+
+rsa_status rsa_verify_batch(const rsa_public_key* key, rsa_signature_scheme scheme, const uint8_t* digests, const uint8_t* signatures,
+                            size_t count, uint8_t* results) {
+    return CInterface::guarded([&] {
+        if (key == nullptr || !CInterface::isSignatureScheme(scheme) || (count > 0 && (digests == nullptr || signatures == nullptr || results == nullptr)))
+            return RSA_ERROR_INVALID_ARGUMENT;
+        if (!CInterface::fitsSignature(key->key.n, scheme))
+            return RSA_ERROR_KEY_TOO_SMALL;
+
+        CInterface::forEach(count, [&](size_t i) {
+            const uint8_t* const digest { digests + i * RSA_DIGEST_SIZE };
+            const uint8_t* const signature { signatures + i * key->k };
+            results[i] = verify(key->key, Utility::Bytes(digest, digest + RSA_DIGEST_SIZE), Utility::Bytes(signature, signature + key->k), CInterface::toScheme(scheme));
+        });
+        return RSA_OK;
+    });
+}
+
+rsa_status rsa_thread_pool_configure(size_t thread_count, int pinned) {
+    return CInterface::guarded([&] {
+        std::unique_lock lock { CInterface::poolMutex };
+
+        CInterface::configuredPool.reset();
+        CInterface::isInline = thread_count == 0;
+        if (thread_count > 0)
+            CInterface::configuredPool = std::make_unique<Concurrency::WorkerPool>(thread_count, 4096, pinned != 0);
+        return RSA_OK;
+    });
+}
+
+size_t rsa_thread_pool_size(void) {
+    std::shared_lock lock { CInterface::poolMutex };
+
+    if (CInterface::isInline)
+        return 0;
+    return CInterface::configuredPool ? CInterface::configuredPool->size() : Concurrency::defaultPool().size();
+}
+
+}
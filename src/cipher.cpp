@@ -0,0 +1,290 @@
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+
+#include "rsa/convert.hpp"
+
+#include "detail/cipher.hpp"
+
+namespace Cipher {
+    namespace Detail {
+        constexpr std::uint32_t rotateLeft(std::uint32_t x, int bits) {
+            return (x << bits) | (x >> (32 - bits));
+        }
+
+        // Vector of 'Lanes' 32 bit words (GCC/Clang vector extension), compiled to SSE, AVX2 or AVX-512 registers
+        template <size_t Lanes>
+        struct WordVector {
+            typedef std::uint32_t type __attribute__((vector_size(4 * Lanes)));
+        };
+
+        // Generates 'Lanes' consecutive ChaCha20 blocks at once, starting from block 'counter'
+        // Word 'i' of every block is kept in one vector register, so each step of a round works on all the blocks together
+        template <size_t Lanes>
+        __attribute__((always_inline)) inline void chacha20Blocks(const std::uint32_t (&input)[16], std::uint32_t counter, unsigned char* keystream) {
+            using Vector = typename WordVector<Lanes>::type;
+
+            Vector counters {};
+            for (size_t lane { 0 }; lane < Lanes; ++lane)
+                counters[lane] = counter + static_cast<std::uint32_t>(lane);
+
+            Vector start[16];
+            for (int i { 0 }; i < 16; ++i)
+                start[i] = i == 12 ? counters : Vector {} + input[i];
+
+            Vector x[16];
+            for (int i { 0 }; i < 16; ++i)
+                x[i] = start[i];
+
+            // Column rounds then diagonal rounds, each line is one quarter round (a, b, c, d)
+            constexpr int quarterRounds[8][4] {
+                { 0, 4, 8, 12 }, { 1, 5, 9, 13 }, { 2, 6, 10, 14 }, { 3, 7, 11, 15 },
+                { 0, 5, 10, 15 }, { 1, 6, 11, 12 }, { 2, 7, 8, 13 }, { 3, 4, 9, 14 },
+            };
+
+            for (int round { 0 }; round < 10; ++round) {
+#pragma GCC unroll 8
+                for (int i { 0 }; i < 8; ++i) {
+                    const int a { quarterRounds[i][0] }, b { quarterRounds[i][1] }, c { quarterRounds[i][2] }, d { quarterRounds[i][3] };
+                    x[a] += x[b]; x[d] ^= x[a]; x[d] = (x[d] << 16) | (x[d] >> 16);
+                    x[c] += x[d]; x[b] ^= x[c]; x[b] = (x[b] << 12) | (x[b] >> 20);
+                    x[a] += x[b]; x[d] ^= x[a]; x[d] = (x[d] << 8) | (x[d] >> 24);
+                    x[c] += x[d]; x[b] ^= x[c]; x[b] = (x[b] << 7) | (x[b] >> 25);
+                }
+            }
+
+            for (int i { 0 }; i < 16; ++i)
+                x[i] += start[i];
+
+            // Keystream bytes are little-endian words, block after block
+            for (size_t lane { 0 }; lane < Lanes; ++lane)
+                for (int i { 0 }; i < 16; ++i) {
+                    const std::uint32_t word { x[i][lane] };
+                    unsigned char* const out { keystream + 64 * lane + 4 * i };
+                    out[0] = static_cast<unsigned char>(word); out[1] = static_cast<unsigned char>(word >> 8);
+                    out[2] = static_cast<unsigned char>(word >> 16); out[3] = static_cast<unsigned char>(word >> 24);
+                }
+        }
+
+        void chacha20Blocks4(const std::uint32_t (&input)[16], std::uint32_t counter, unsigned char* keystream) {
+            chacha20Blocks<4>(input, counter, keystream);
+        }
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+        __attribute__((target("avx2")))
+        void chacha20Blocks8(const std::uint32_t (&input)[16], std::uint32_t counter, unsigned char* keystream) {
+            chacha20Blocks<8>(input, counter, keystream);
+        }
+
+        __attribute__((target("avx512f")))
+        void chacha20Blocks16(const std::uint32_t (&input)[16], std::uint32_t counter, unsigned char* keystream) {
+            chacha20Blocks<16>(input, counter, keystream);
+        }
+#endif
+
+        BlockGenerator blockGenerator() {
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+            if (__builtin_cpu_supports("avx512f"))
+                return BlockGenerator { 16, chacha20Blocks16 };
+            if (__builtin_cpu_supports("avx2"))
+                return BlockGenerator { 8, chacha20Blocks8 };
+#endif
+            return BlockGenerator { 4, chacha20Blocks4 };
+        }
+    }
+
+    namespace ChaCha20 {
+        void apply(const unsigned char* key, const unsigned char* nonce, std::uint32_t counter, unsigned char* data, size_t length) {
+            std::uint32_t input[16] { 0x61707865, 0x3320646e, 0x79622d32, 0x6b206574 };
+            for (int i { 0 }; i < 8; ++i)
+                input[4 + i] = Detail::loadLittleEndian32(key + 4 * i);
+            input[12] = counter;
+            for (int i { 0 }; i < 3; ++i)
+                input[13 + i] = Detail::loadLittleEndian32(nonce + 4 * i);
+
+            const Detail::BlockGenerator generator { Detail::blockGenerator() };
+
+            alignas(64) unsigned char keystream[Detail::maxLanes * blockSize];
+            while (length > 0) {
+                generator.generate(input, counter, keystream);
+
+                const size_t taken { std::min(length, generator.lanes * blockSize) };
+                size_t i { 0 };
+                for (; i + 8 <= taken; i += 8) {
+                    std::uint64_t word {}, key {};
+                    std::memcpy(&word, data + i, 8);
+                    std::memcpy(&key, keystream + i, 8);
+                    word ^= key;
+                    std::memcpy(data + i, &word, 8);
+                }
+                for (; i < taken; ++i)
+                    data[i] ^= keystream[i];
+
+                data += taken;
+                length -= taken;
+                counter += static_cast<std::uint32_t>(generator.lanes);
+            }
+        }
+    }
+
+    // Poly1305 one-time authenticator (RFC 8439), the accumulator is kept in three 44/44/42 bit limbs
+    class Poly1305 {
+    public:
+        static constexpr size_t keySize { 32 };
+        static constexpr size_t tagSize { 16 };
+
+        explicit Poly1305(const unsigned char* key) {
+            const std::uint64_t t0 { Detail::loadLittleEndian64(key) };
+            const std::uint64_t t1 { Detail::loadLittleEndian64(key + 8) };
+
+            r[0] = t0 & 0xffc0fffffffULL;
+            r[1] = ((t0 >> 44) | (t1 << 20)) & 0xfffffc0ffffULL;
+            r[2] = (t1 >> 24) & 0x00ffffffc0fULL;
+
+            pad[0] = Detail::loadLittleEndian64(key + 16);
+            pad[1] = Detail::loadLittleEndian64(key + 24);
+        }
+
+        void update(const unsigned char* data, size_t length) {
+            if (bufferLength > 0) {
+                const size_t taken { std::min(length, buffer.size() - bufferLength) };
+                std::memcpy(buffer.data() + bufferLength, data, taken);
+                bufferLength += taken;
+                data += taken;
+                length -= taken;
+
+                if (bufferLength < buffer.size())
+                    return;
+
+                blocks(buffer.data(), buffer.size(), 1ULL << 40);
+                bufferLength = 0;
+            }
+
+            const size_t whole { length & ~static_cast<size_t>(15) };
+            blocks(data, whole, 1ULL << 40);
+
+            std::memcpy(buffer.data(), data + whole, length - whole);
+            bufferLength = length - whole;
+        }
+
+        std::array<unsigned char, tagSize> finish() {
+            constexpr std::uint64_t mask44 { 0xfffffffffffULL };
+            constexpr std::uint64_t mask42 { 0x3ffffffffffULL };
+
+            if (bufferLength > 0) {
+                buffer[bufferLength] = 1;
+                std::fill(buffer.begin() + static_cast<std::ptrdiff_t>(bufferLength) + 1, buffer.end(), 0);
+                blocks(buffer.data(), buffer.size(), 0);
+            }
+
+            // Fully carries h, then computes h + -p to pick h mod p without branches
+            std::uint64_t c {};
+            for (int pass { 0 }; pass < 2; ++pass) {
+                c = h[1] >> 44; h[1] &= mask44; h[2] += c;
+                c = h[2] >> 42; h[2] &= mask42; h[0] += c * 5;
+                c = h[0] >> 44; h[0] &= mask44; h[1] += c;
+            }
+            c = h[1] >> 44; h[1] &= mask44; h[2] += c;
+
+            std::uint64_t g0 { h[0] + 5 }; c = g0 >> 44; g0 &= mask44;
+            std::uint64_t g1 { h[1] + c }; c = g1 >> 44; g1 &= mask44;
+            std::uint64_t g2 { h[2] + c - (1ULL << 42) };
+
+            std::uint64_t select { (g2 >> 63) - 1 };
+            g0 &= select; g1 &= select; g2 &= select;
+            select = ~select;
+            h[0] = (h[0] & select) | g0;
+            h[1] = (h[1] & select) | g1;
+            h[2] = (h[2] & select) | g2;
+
+            // tag = (h + pad) mod 2^128
+            h[0] += pad[0] & mask44; c = h[0] >> 44; h[0] &= mask44;
+            h[1] += (((pad[0] >> 44) | (pad[1] << 20)) & mask44) + c; c = h[1] >> 44; h[1] &= mask44;
+            h[2] += ((pad[1] >> 24) & mask42) + c; h[2] &= mask42;
+
+            std::array<unsigned char, tagSize> tag {};
+            Detail::storeLittleEndian64(tag.data(), h[0] | (h[1] << 44));
+            Detail::storeLittleEndian64(tag.data() + 8, (h[1] >> 20) | (h[2] << 24));
+            return tag;
+        }
+
+    private:
+        // h = (h + block) * r mod 2^130 - 5 for every 16 byte block, 'highBit' is the 2^128 bit added to whole blocks
+        void blocks(const unsigned char* data, size_t length, std::uint64_t highBit) {
+            constexpr std::uint64_t mask44 { 0xfffffffffffULL };
+            constexpr std::uint64_t mask42 { 0x3ffffffffffULL };
+            const std::uint64_t s1 { r[1] * (5 << 2) };
+            const std::uint64_t s2 { r[2] * (5 << 2) };
+
+            for (; length >= 16; data += 16, length -= 16) {
+                const std::uint64_t t0 { Detail::loadLittleEndian64(data) };
+                const std::uint64_t t1 { Detail::loadLittleEndian64(data + 8) };
+
+                h[0] += t0 & mask44;
+                h[1] += ((t0 >> 44) | (t1 << 20)) & mask44;
+                h[2] += (((t1 >> 24)) & mask42) | highBit;
+
+                using Wide = unsigned __int128;
+                const Wide d0 { Wide { h[0] } * r[0] + Wide { h[1] } * s2 + Wide { h[2] } * s1 };
+                Wide d1 { Wide { h[0] } * r[1] + Wide { h[1] } * r[0] + Wide { h[2] } * s2 };
+                Wide d2 { Wide { h[0] } * r[2] + Wide { h[1] } * r[1] + Wide { h[2] } * r[0] };
+
+                std::uint64_t c { static_cast<std::uint64_t>(d0 >> 44) }; h[0] = static_cast<std::uint64_t>(d0) & mask44;
+                d1 += c; c = static_cast<std::uint64_t>(d1 >> 44); h[1] = static_cast<std::uint64_t>(d1) & mask44;
+                d2 += c; c = static_cast<std::uint64_t>(d2 >> 42); h[2] = static_cast<std::uint64_t>(d2) & mask42;
+                h[0] += c * 5; c = h[0] >> 44; h[0] &= mask44;
+                h[1] += c;
+            }
+        }
+
+        std::array<std::uint64_t, 3> r {};
+        std::array<std::uint64_t, 3> h {};
+        std::array<std::uint64_t, 2> pad {};
+        std::array<unsigned char, 16> buffer {};
+        size_t bufferLength { 0 };
+    };
+
+    namespace ChaCha20Poly1305 {
+        static_assert(tagSize == Poly1305::tagSize);
+
+        namespace Detail {
+            std::array<unsigned char, tagSize> tag(const unsigned char* key, const unsigned char* nonce, const Utility::Bytes& aad, const unsigned char* ciphertext, size_t length) {
+                std::array<unsigned char, ChaCha20::blockSize> oneTimeKey {};
+                ChaCha20::apply(key, nonce, 0, oneTimeKey.data(), oneTimeKey.size());
+
+                const std::array<unsigned char, 16> zeros {};
+                Poly1305 mac { oneTimeKey.data() };
+                mac.update(aad.data(), aad.size());
+                mac.update(zeros.data(), (16 - aad.size() % 16) % 16);
+                mac.update(ciphertext, length);
+                mac.update(zeros.data(), (16 - length % 16) % 16);
+
+                std::array<unsigned char, 16> lengths {};
+                Cipher::Detail::storeLittleEndian64(lengths.data(), aad.size());
+                Cipher::Detail::storeLittleEndian64(lengths.data() + 8, length);
+                mac.update(lengths.data(), lengths.size());
+
+                return mac.finish();
+            }
+        }
+
+        std::array<unsigned char, tagSize> seal(const unsigned char* key, const unsigned char* nonce, const Utility::Bytes& aad, unsigned char* data, size_t length) {
+            ChaCha20::apply(key, nonce, 1, data, length);
+            return Detail::tag(key, nonce, aad, data, length);
+        }
+
+        bool open(const unsigned char* key, const unsigned char* nonce, const Utility::Bytes& aad, unsigned char* data, size_t length, const unsigned char* tag) {
+            const std::array<unsigned char, tagSize> expected { Detail::tag(key, nonce, aad, data, length) };
+
+            unsigned char difference { 0 };
+            for (size_t i { 0 }; i < tagSize; ++i)
+                difference |= expected[i] ^ tag[i];
+            if (difference != 0)
+                return false;
+
+            ChaCha20::apply(key, nonce, 1, data, length);
+            return true;
+        }
+    }
+}
@@ -0,0 +1,155 @@
+#include <algorithm>
+#include <fstream>
+#include <mutex>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined(__unix__)
+#include <pthread.h>
+#endif
+
+#if defined(__linux__)
+#include <sched.h>
+#endif
+
+#include "rsa/concurrency.hpp"
+
+namespace Concurrency {
+    namespace Topology {
+        std::vector<int> parseList(const std::string& list) {
+            std::vector<int> values {};
+            std::istringstream stream { list };
+            std::string range {};
+
+            while (std::getline(stream, range, ',')) {
+                if (range.empty())
+                    continue;
+                const size_t dash { range.find('-') };
+                const int first { std::stoi(range.substr(0, dash)) };
+                const int last { dash == std::string::npos ? first : std::stoi(range.substr(dash + 1)) };
+                for (int value { first }; value <= last; ++value)
+                    values.push_back(value);
+            }
+            return values;
+        }
+
+        const Layout& layout() {
+            static const Layout cached { [] {
+                Layout result {};
+#if defined(__linux__)
+                cpu_set_t allowed {};
+                CPU_ZERO(&allowed);
+                const bool hasMask { sched_getaffinity(0, sizeof(allowed), &allowed) == 0 };
+
+                std::ifstream online { "/sys/devices/system/node/online" };
+                std::string nodeList {};
+                if (online && std::getline(online, nodeList))
+                    for (const int node : parseList(nodeList)) {
+                        std::ifstream cpuFile { "/sys/devices/system/node/node" + std::to_string(node) + "/cpulist" };
+                        std::string cpuList {};
+                        if (!cpuFile || !std::getline(cpuFile, cpuList))
+                            continue;
+
+                        if (static_cast<size_t>(node) >= result.nodeCpus.size())
+                            result.nodeCpus.resize(static_cast<size_t>(node) + 1);
+                        for (const int cpu : parseList(cpuList)) {
+                            if (hasMask && (cpu >= CPU_SETSIZE || !CPU_ISSET(cpu, &allowed)))
+                                continue;
+                            result.nodeCpus[static_cast<size_t>(node)].push_back(cpu);
+                            if (static_cast<size_t>(cpu) >= result.cpuNode.size())
+                                result.cpuNode.resize(static_cast<size_t>(cpu) + 1, 0);
+                            result.cpuNode[static_cast<size_t>(cpu)] = node;
+                        }
+                    }
+
+                if (std::none_of(result.nodeCpus.begin(), result.nodeCpus.end(), [](const std::vector<int>& cpus) { return !cpus.empty(); })) {
+                    result.nodeCpus.assign(1, {});
+                    for (int cpu { 0 }; cpu < CPU_SETSIZE; ++cpu)
+                        if (hasMask && CPU_ISSET(cpu, &allowed))
+                            result.nodeCpus[0].push_back(cpu);
+                    result.cpuNode.assign(result.nodeCpus[0].empty() ? 0 : static_cast<size_t>(result.nodeCpus[0].back()) + 1, 0);
+                }
+#else
+                result.nodeCpus.assign(1, {});
+#endif
+                return result;
+            }() };
+            return cached;
+        }
+
+        size_t nodeCount() {
+            return layout().nodeCpus.size();
+        }
+
+        size_t currentNode() {
+#if defined(__linux__)
+            const int cpu { sched_getcpu() };
+            const std::vector<int>& cpuNode { layout().cpuNode };
+            if (cpu >= 0 && static_cast<size_t>(cpu) < cpuNode.size())
+                return static_cast<size_t>(cpuNode[static_cast<size_t>(cpu)]);
+#endif
+            return 0;
+        }
+
+        std::optional<int> cpuFor(size_t worker) {
+            std::vector<int> order {};
+            const std::vector<std::vector<int>>& nodeCpus { layout().nodeCpus };
+            for (size_t round { 0 }; order.size() <= worker; ++round) {
+                const size_t before { order.size() };
+                for (const std::vector<int>& cpus : nodeCpus)
+                    if (round < cpus.size())
+                        order.push_back(cpus[round]);
+                if (order.size() == before)
+                    break;
+            }
+
+            if (order.empty())
+                return std::nullopt;
+            return order[worker % order.size()];
+        }
+
+        bool pin(int cpu) {
+#if defined(__linux__)
+            if (cpu < 0 || cpu >= CPU_SETSIZE)
+                return false;
+            cpu_set_t set {};
+            CPU_ZERO(&set);
+            CPU_SET(cpu, &set);
+            return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+            (void)cpu;
+            return false;
+#endif
+        }
+    }
+
+    namespace Detail {
+        std::mutex defaultPoolMutex {};
+        bool isDefaultPoolCreated { false };
+        bool isDefaultPoolPinned { false };
+    }
+
+    WorkerPool& defaultPool() {
+        static WorkerPool pool { [] {
+            std::lock_guard lock { Detail::defaultPoolMutex };
+            Detail::isDefaultPoolCreated = true;
+
+            const size_t threadCount { std::max<size_t>(1, std::thread::hardware_concurrency()) };
+            Policy policy {};
+            policy.reservedWorkers = threadCount >= 4 ? 1 : 0;
+            return WorkerPool { threadCount, 4096, Detail::isDefaultPoolPinned, policy };
+        }() };
+        return pool;
+    }
+
+    bool pinDefaultPool() {
+        std::lock_guard lock { Detail::defaultPoolMutex };
+        if (Detail::isDefaultPoolCreated)
+            return false;
+        Detail::isDefaultPoolPinned = true;
+        return true;
+    }
+}
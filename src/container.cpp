@@ -0,0 +1,537 @@
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#if defined(__unix__)
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "rsa/concurrency.hpp"
+#include "rsa/container.hpp"
+#include "rsa/convert.hpp"
+#include "rsa/file.hpp"
+#include "rsa/generate.hpp"
+#include "rsa/hash.hpp"
+#include "rsa/key.hpp"
+#include "rsa/rsa.hpp"
+
+#include "detail/file.hpp"
+#include "detail/container.hpp"
+#include "detail/io.hpp"
+#include "detail/sharding.hpp"
+
+namespace Container {
+    namespace Detail {
+        void append(Utility::Bytes& bytes, unsigned long long int x, size_t length) {
+            const Utility::Bytes written { Utility::Convert::toBytes(static_cast<long long int>(x), length) };
+            bytes.insert(bytes.end(), written.begin(), written.end());
+        }
+
+        unsigned long long int read(const unsigned char* bytes, size_t length) {
+            unsigned long long int x { 0 };
+            for (size_t i { 0 }; i < length; ++i)
+                x = (x << 8) | bytes[i];
+            return x;
+        }
+
+        Utility::Bytes serialize(const Header& header) {
+            Utility::Bytes bytes { magic.begin(), magic.end() };
+            bytes.push_back(version);
+            bytes.push_back(static_cast<unsigned char>(header.k));
+            append(bytes, 0, 2);
+            bytes.insert(bytes.end(), header.fingerprint.begin(), header.fingerprint.end());
+            append(bytes, header.blockSize, 4);
+            append(bytes, header.blockCount, 8);
+            append(bytes, header.plaintextLength, 8);
+            append(bytes, 0, headerSize - bytes.size());
+            return bytes;
+        }
+
+        std::optional<Header> parse(const Utility::Bytes& bytes) {
+            if (bytes.size() != headerSize || !std::equal(magic.begin(), magic.end(), bytes.begin()) || bytes[4] != version)
+                return std::nullopt;
+
+            Header header {};
+            header.k = bytes[5];
+            header.fingerprint.assign(bytes.begin() + 8, bytes.begin() + 40);
+            header.blockSize = static_cast<size_t>(read(bytes.data() + 40, 4));
+            header.blockCount = read(bytes.data() + 44, 8);
+            header.plaintextLength = read(bytes.data() + 52, 8);
+
+            if (header.k < 2 || header.k > 8 || header.blockSize == 0 || header.blockSize > maxBlockSize)
+                return std::nullopt;
+            return header;
+        }
+    }
+
+    void encryptBlock(const Key::Public& publicKey, const Header& header, const unsigned char* plaintext, size_t length, unsigned char* ciphertext) {
+        const size_t chunkSize { header.chunkSize() };
+
+        for (size_t chunk { 0 }; chunk < header.chunksPerBlock(); ++chunk) {
+            const size_t start { chunk * chunkSize };
+            const size_t taken { start < length ? std::min(chunkSize, length - start) : 0 };
+
+            Utility::Bytes chunkBytes(chunkSize, 0);
+            std::memcpy(chunkBytes.data(), plaintext + start, taken);
+
+            const Utility::Bytes encoded { Utility::Convert::toBytes(encode(publicKey, *Utility::Convert::toInteger(chunkBytes)), header.k) };
+            std::memcpy(ciphertext + chunk * header.k, encoded.data(), header.k);
+        }
+    }
+
+    bool decryptBlock(const Key::CRT& crtKey, const Header& header, const unsigned char* ciphertext, size_t length, unsigned char* plaintext) {
+        const long long int n { crtKey.p * crtKey.q };
+        const size_t chunkSize { header.chunkSize() };
+
+        for (size_t chunk { 0 }; chunk * chunkSize < length; ++chunk) {
+            const std::optional<long long int> c { Utility::Convert::toInteger(Utility::Bytes(ciphertext + chunk * header.k, ciphertext + (chunk + 1) * header.k)) };
+            if (!c || *c >= n)
+                return false;
+
+            const long long int m { decode(crtKey, *c) };
+            if (Utility::Convert::byteLength(m) > chunkSize)
+                return false;
+
+            const Utility::Bytes decoded { Utility::Convert::toBytes(m, chunkSize) };
+            const size_t start { chunk * chunkSize };
+            std::memcpy(plaintext + start, decoded.data(), std::min(chunkSize, length - start));
+        }
+
+        return true;
+    }
+
+    bool write(const Key::Public& publicKey, std::istream& in, std::ostream& out, size_t blockSize) {
+        Header header {};
+        header.fingerprint = Hash::fingerprint(publicKey);
+        header.k = Utility::Convert::byteLength(publicKey.n);
+        header.blockSize = blockSize;
+        if (header.k < 2 || blockSize == 0 || blockSize > maxBlockSize)
+            return false;
+
+        const std::streampos start { out.tellp() };
+        Utility::Bytes headerBytes { Detail::serialize(header) };
+        out.write(reinterpret_cast<const char*>(headerBytes.data()), static_cast<std::streamsize>(headerBytes.size()));
+
+        Utility::Bytes plaintext(blockSize);
+        Utility::Bytes ciphertext(header.ciphertextBlockSize());
+        Utility::Bytes index {};
+
+        while (true) {
+            in.read(reinterpret_cast<char*>(plaintext.data()), static_cast<std::streamsize>(blockSize));
+            const size_t length { static_cast<size_t>(in.gcount()) };
+            if (length == 0)
+                break;
+
+            encryptBlock(publicKey, header, plaintext.data(), length, ciphertext.data());
+            out.write(reinterpret_cast<const char*>(ciphertext.data()), static_cast<std::streamsize>(ciphertext.size()));
+
+            Detail::append(index, header.blockOffset(header.blockCount), 8);
+            Detail::append(index, length, 4);
+            ++header.blockCount;
+            header.plaintextLength += length;
+        }
+
+        Detail::append(index, header.blockOffset(header.blockCount), 8);
+        index.insert(index.end(), indexMagic.begin(), indexMagic.end());
+        out.write(reinterpret_cast<const char*>(index.data()), static_cast<std::streamsize>(index.size()));
+
+        const std::streampos end { out.tellp() };
+        headerBytes = Detail::serialize(header);
+        out.seekp(start);
+        out.write(reinterpret_cast<const char*>(headerBytes.data()), static_cast<std::streamsize>(headerBytes.size()));
+        out.seekp(end);
+
+        return static_cast<bool>(out);
+    }
+
+    std::optional<Layout> readLayout(std::istream& in) {
+        Utility::Bytes headerBytes(headerSize);
+        in.seekg(0);
+        if (!in.read(reinterpret_cast<char*>(headerBytes.data()), static_cast<std::streamsize>(headerSize)))
+            return std::nullopt;
+
+        std::optional<Header> header { Detail::parse(headerBytes) };
+        if (!header)
+            return std::nullopt;
+
+        // The block count comes from the file: the index it implies has to fit in the stream before anything is allocated for it
+        const std::optional<unsigned long long int> indexOffset { header->checkedBlockOffset(header->blockCount) };
+        unsigned long long int indexSize {}, indexEnd {};
+        if (!indexOffset || __builtin_mul_overflow(header->blockCount, indexEntrySize, &indexSize) || __builtin_add_overflow(indexSize, footerSize, &indexSize)
+            || __builtin_add_overflow(*indexOffset, indexSize, &indexEnd))
+            return std::nullopt;
+
+        in.seekg(0, std::ios::end);
+        const std::streamoff streamLength { in.tellg() };
+        if (streamLength < 0 || indexEnd > static_cast<unsigned long long int>(streamLength))
+            return std::nullopt;
+
+        Layout layout { *header, {} };
+        Utility::Bytes index(static_cast<size_t>(indexSize));
+        in.seekg(static_cast<std::streamoff>(*indexOffset));
+        if (!in.read(reinterpret_cast<char*>(index.data()), static_cast<std::streamsize>(index.size())))
+            return std::nullopt;
+
+        const unsigned char* const footer { index.data() + index.size() - footerSize };
+        if (Detail::read(footer, 8) != *indexOffset || !std::equal(indexMagic.begin(), indexMagic.end(), footer + 8))
+            return std::nullopt;
+
+        unsigned long long int plaintextLength { 0 };
+        layout.index.resize(header->blockCount);
+        for (unsigned long long int i { 0 }; i < header->blockCount; ++i) {
+            IndexEntry& entry { layout.index[i] };
+            entry.offset = Detail::read(index.data() + i * indexEntrySize, 8);
+            entry.plaintextLength = static_cast<size_t>(Detail::read(index.data() + i * indexEntrySize + 8, 4));
+
+            if (entry.offset != header->blockOffset(i) || entry.plaintextLength > header->blockSize || (i + 1 < header->blockCount && entry.plaintextLength != header->blockSize))
+                return std::nullopt;
+            plaintextLength += entry.plaintextLength;
+        }
+
+        if (plaintextLength != header->plaintextLength)
+            return std::nullopt;
+
+        return layout;
+    }
+
+    // Decodes the blocks [first, first + count) and returns their plaintext, every other block is left untouched on disk
+    std::optional<Utility::Bytes> readBlocks(std::istream& in, const Layout& layout, const Key::CRT& crtKey, unsigned long long int first, unsigned long long int count) {
+        if (first > layout.header.blockCount || count > layout.header.blockCount - first)
+            return std::nullopt;
+        if (count == 0)
+            return Utility::Bytes {};
+
+        const Header& header { layout.header };
+        Utility::Bytes ciphertext(header.ciphertextBlockSize());
+        Utility::Bytes plaintext {};
+
+        for (unsigned long long int i { first }; i < first + count; ++i) {
+            const IndexEntry& entry { layout.index[i] };
+
+            in.seekg(static_cast<std::streamoff>(entry.offset));
+            if (!in.read(reinterpret_cast<char*>(ciphertext.data()), static_cast<std::streamsize>(ciphertext.size())))
+                return std::nullopt;
+
+            const size_t position { plaintext.size() };
+            plaintext.resize(position + entry.plaintextLength);
+            if (!decryptBlock(crtKey, header, ciphertext.data(), entry.plaintextLength, plaintext.data() + position))
+                return std::nullopt;
+        }
+
+        return plaintext;
+    }
+
+#if defined(__unix__)
+    // Work stealing over a range of blocks: every worker starts with an equal share and takes small pieces from its front.
+    // A worker that runs out steals the back half of the biggest remaining share, so uneven tails still keep every core busy
+    class BlockScheduler {
+    public:
+        BlockScheduler(unsigned long long int first, unsigned long long int last, size_t workers, unsigned long long int grain)
+            : shares(workers), grain { std::max<unsigned long long int>(1, grain) } {
+            const unsigned long long int total { last - first };
+            for (size_t i { 0 }; i < workers; ++i) {
+                shares[i].begin = first + total * i / workers;
+                shares[i].end = first + total * (i + 1) / workers;
+            }
+        }
+
+        // Next piece of work for 'worker', as [begin, end). Returns false when every share is empty
+        bool next(size_t worker, unsigned long long int& begin, unsigned long long int& end) {
+            if (take(worker, begin, end))
+                return true;
+
+            while (true) {
+                size_t victim { worker };
+                unsigned long long int biggest { 0 };
+                for (size_t i { 0 }; i < shares.size(); ++i) {
+                    std::lock_guard lock { shares[i].mutex };
+                    if (shares[i].end - shares[i].begin > biggest) {
+                        biggest = shares[i].end - shares[i].begin;
+                        victim = i;
+                    }
+                }
+                if (biggest == 0)
+                    return false;
+
+                {
+                    std::scoped_lock lock { shares[victim].mutex, shares[worker].mutex };
+                    Share& stolen { shares[victim] };
+                    if (stolen.end == stolen.begin)
+                        continue;
+
+                    const unsigned long long int half { stolen.begin + (stolen.end - stolen.begin) / 2 };
+                    shares[worker].begin = half;
+                    shares[worker].end = stolen.end;
+                    stolen.end = half;
+                }
+
+                if (take(worker, begin, end))
+                    return true;
+            }
+        }
+
+    private:
+        struct Share {
+            std::mutex mutex {};
+            unsigned long long int begin {};
+            unsigned long long int end {};
+        };
+
+        bool take(size_t worker, unsigned long long int& begin, unsigned long long int& end) {
+            Share& share { shares[worker] };
+            std::lock_guard lock { share.mutex };
+            if (share.begin == share.end)
+                return false;
+
+            begin = share.begin;
+            end = std::min(share.end, share.begin + grain);
+            share.begin = end;
+            return true;
+        }
+
+        std::vector<Share> shares;
+        const unsigned long long int grain;
+    };
+
+    bool decryptFile(const Key::Public& publicKey, const Key::Private& privateKey, const std::string& inputFilename, const std::string& outputFilename,
+                     size_t threadCount, std::optional<std::pair<unsigned long long int, unsigned long long int>> range) {
+        std::optional<Layout> layout {};
+        {
+            std::ifstream in { inputFilename, std::ios::binary };
+            layout = readLayout(in);
+        }
+        if (!layout || layout->header.fingerprint != Hash::fingerprint(publicKey))
+            return false;
+
+        const Header& header { layout->header };
+        const unsigned long long int begin { range ? range->first : 0 };
+        const unsigned long long int end { range ? range->second : header.plaintextLength };
+        if (begin > end || end > header.plaintextLength)
+            return false;
+
+        const std::optional<Utility::File::Mapping> input { Utility::File::Mapping::openRead(inputFilename) };
+        const std::optional<Utility::File::Mapping> output { Utility::File::Mapping::createWrite(outputFilename, static_cast<size_t>(end - begin)) };
+        if (!input || !output || input->size() < header.blockOffset(header.blockCount))
+            return false;
+        if (begin == end)
+            return true;
+
+        const std::optional<Key::CRT> crtKey { Generate::crt(privateKey) };
+        if (!crtKey)
+            return false;
+
+        Concurrency::NodeLocal<Key::CRT> crtKeys { *crtKey };
+        const unsigned long long int firstBlock { begin / header.blockSize };
+        const unsigned long long int lastBlock { (end + header.blockSize - 1) / header.blockSize };
+
+        threadCount = std::max<size_t>(1, std::min<unsigned long long int>(threadCount, lastBlock - firstBlock));
+        BlockScheduler scheduler { firstBlock, lastBlock, threadCount, 16 };
+        std::atomic<bool> isValid { true };
+
+        const auto work { [&](size_t worker) {
+            // The calling thread keeps its affinity, the others are pinned first so their scratch and key copy are node-local
+            if (worker > 0)
+                if (const std::optional<int> cpu { Concurrency::Topology::cpuFor(worker) })
+                    Concurrency::Topology::pin(*cpu);
+            const Key::CRT& crtKey { crtKeys.local() };
+            Utility::Bytes scratch(header.blockSize);
+            unsigned long long int pieceBegin {}, pieceEnd {};
+
+            while (isValid.load(std::memory_order_relaxed) && scheduler.next(worker, pieceBegin, pieceEnd))
+                for (unsigned long long int block { pieceBegin }; block < pieceEnd; ++block) {
+                    const IndexEntry& entry { layout->index[block] };
+                    const unsigned long long int blockStart { block * header.blockSize };
+                    const unsigned long long int copyBegin { std::max(begin, blockStart) };
+                    const unsigned long long int copyEnd { std::min(end, blockStart + entry.plaintextLength) };
+
+                    // Whole blocks go straight into the output, the first and last ones of a range are clipped through scratch
+                    const bool isWhole { copyBegin == blockStart && copyEnd == blockStart + entry.plaintextLength };
+                    unsigned char* const target { isWhole ? output->data() + (blockStart - begin) : scratch.data() };
+
+                    if (!decryptBlock(crtKey, header, input->data() + entry.offset, entry.plaintextLength, target)) {
+                        isValid = false;
+                        return;
+                    }
+                    if (!isWhole)
+                        std::memcpy(output->data() + (copyBegin - begin), scratch.data() + (copyBegin - blockStart), static_cast<size_t>(copyEnd - copyBegin));
+                }
+        } };
+
+        std::vector<std::thread> threads {};
+        for (size_t worker { 1 }; worker < threadCount; ++worker)
+            threads.emplace_back(work, worker);
+        work(0);
+        for (std::thread& thread : threads)
+            thread.join();
+
+        return isValid;
+    }
+
+    bool decryptFileSharded(const Key::Public& publicKey, const Key::Private& privateKey, const std::string& inputFilename, const std::string& outputFilename,
+                            size_t processCount) {
+        std::optional<Layout> layout {};
+        {
+            std::ifstream in { inputFilename, std::ios::binary };
+            layout = readLayout(in);
+        }
+        if (!layout || layout->header.fingerprint != Hash::fingerprint(publicKey))
+            return false;
+
+        const Header& header { layout->header };
+        const std::optional<Utility::File::Mapping> input { Utility::File::Mapping::openRead(inputFilename) };
+        const std::optional<Utility::File::Mapping> output { Utility::File::Mapping::createWrite(outputFilename, static_cast<size_t>(header.plaintextLength)) };
+        const std::optional<Key::CRT> localCrtKey { Generate::crt(privateKey) };
+        if (!localCrtKey)
+            return false;
+
+        const std::optional<Sharding::Shared<Key::CRT>> crtKey { Sharding::Shared<Key::CRT>::create(*localCrtKey) };
+        if (!input || !output || !crtKey || input->size() < header.blockOffset(header.blockCount))
+            return false;
+        if (header.blockCount == 0)
+            return true;
+
+        return Sharding::run(processCount, header.blockCount, 16, [&](unsigned long long int first, unsigned long long int last) {
+            for (unsigned long long int block { first }; block < last; ++block) {
+                const IndexEntry& entry { layout->index[block] };
+                if (!decryptBlock(crtKey->get(), header, input->data() + entry.offset, entry.plaintextLength, output->data() + block * header.blockSize))
+                    return false;
+            }
+            return true;
+        });
+    }
+#endif
+
+#if defined(__linux__)
+    bool decryptFileAsync(const Key::Public& publicKey, const Key::Private& privateKey, const std::string& inputFilename, const std::string& outputFilename,
+                          unsigned int queueDepth, size_t segmentBlocks, bool useDirectIO, size_t threadCount) {
+        if (queueDepth == 0 || segmentBlocks == 0)
+            return false;
+
+        std::optional<Layout> layout {};
+        {
+            std::ifstream in { inputFilename, std::ios::binary };
+            layout = readLayout(in);
+        }
+        if (!layout || layout->header.fingerprint != Hash::fingerprint(publicKey))
+            return false;
+
+        const Header& header { layout->header };
+        const IO::File input { inputFilename, O_RDONLY, useDirectIO };
+        const IO::File output { outputFilename, O_WRONLY | O_CREAT | O_TRUNC, useDirectIO };
+        if (input.buffered < 0 || output.buffered < 0)
+            return false;
+
+        std::vector<IO::Segment> segments {};
+        for (unsigned long long int first { 0 }; first < header.blockCount; first += segmentBlocks) {
+            const unsigned long long int last { std::min<unsigned long long int>(header.blockCount, first + segmentBlocks) };
+            size_t plaintextLength { 0 };
+            for (unsigned long long int i { first }; i < last; ++i)
+                plaintextLength += layout->index[i].plaintextLength;
+
+            segments.push_back(IO::Segment { header.blockOffset(first), static_cast<size_t>(last - first) * header.ciphertextBlockSize(), first * header.blockSize, plaintextLength });
+        }
+
+        const std::optional<Key::CRT> crtKey { Generate::crt(privateKey) };
+        if (!crtKey)
+            return false;
+
+        const auto transform { [&](size_t segment, const unsigned char* ciphertext, unsigned char* plaintext) {
+            const unsigned long long int first { static_cast<unsigned long long int>(segment) * segmentBlocks };
+            const unsigned long long int last { std::min<unsigned long long int>(header.blockCount, first + segmentBlocks) };
+
+            for (unsigned long long int i { first }; i < last; ++i, ciphertext += header.ciphertextBlockSize(), plaintext += header.blockSize)
+                if (!decryptBlock(*crtKey, header, ciphertext, layout->index[i].plaintextLength, plaintext))
+                    return false;
+            return true;
+        } };
+
+        const std::unique_ptr<IO::Backend> backend { IO::makeBackend(queueDepth) };
+        return segments.empty() || IO::runPipeline(*backend, input, output, segments, transform, queueDepth, threadCount);
+    }
+
+    bool encryptFileAsync(const Key::Public& publicKey, const std::string& inputFilename, const std::string& outputFilename, size_t blockSize,
+                          unsigned int queueDepth, size_t segmentBlocks, bool useDirectIO, size_t threadCount) {
+        if (Utility::Convert::byteLength(publicKey.n) < 2 || blockSize == 0 || blockSize > maxBlockSize || queueDepth == 0 || segmentBlocks == 0)
+            return false;
+
+        const IO::File input { inputFilename, O_RDONLY, useDirectIO };
+        const IO::File output { outputFilename, O_WRONLY | O_CREAT | O_TRUNC, useDirectIO };
+        struct stat status {};
+        if (input.buffered < 0 || output.buffered < 0 || ::fstat(input.buffered, &status) != 0)
+            return false;
+
+        Header header {};
+        header.fingerprint = Hash::fingerprint(publicKey);
+        header.k = Utility::Convert::byteLength(publicKey.n);
+        header.blockSize = blockSize;
+        header.plaintextLength = static_cast<unsigned long long int>(status.st_size);
+        header.blockCount = (header.plaintextLength + blockSize - 1) / blockSize;
+
+        const auto plaintextLengthOf { [&header](unsigned long long int block) {
+            return static_cast<size_t>(std::min<unsigned long long int>(header.blockSize, header.plaintextLength - block * header.blockSize));
+        } };
+
+        std::vector<IO::Segment> segments {};
+        for (unsigned long long int first { 0 }; first < header.blockCount; first += segmentBlocks) {
+            const unsigned long long int last { std::min<unsigned long long int>(header.blockCount, first + segmentBlocks) };
+            const size_t plaintextLength { static_cast<size_t>(std::min<unsigned long long int>(header.plaintextLength, last * blockSize) - first * blockSize) };
+            segments.push_back(IO::Segment { first * blockSize, plaintextLength, header.blockOffset(first), static_cast<size_t>(last - first) * header.ciphertextBlockSize() });
+        }
+
+        const auto transform { [&](size_t segment, const unsigned char* plaintext, unsigned char* ciphertext) {
+            const unsigned long long int first { static_cast<unsigned long long int>(segment) * segmentBlocks };
+            const unsigned long long int last { std::min<unsigned long long int>(header.blockCount, first + segmentBlocks) };
+
+            for (unsigned long long int i { first }; i < last; ++i, plaintext += header.blockSize, ciphertext += header.ciphertextBlockSize())
+                encryptBlock(publicKey, header, plaintext, plaintextLengthOf(i), ciphertext);
+            return true;
+        } };
+
+        const std::unique_ptr<IO::Backend> backend { IO::makeBackend(queueDepth) };
+        if (!segments.empty() && !IO::runPipeline(*backend, input, output, segments, transform, queueDepth, threadCount))
+            return false;
+
+        Utility::Bytes index {};
+        for (unsigned long long int i { 0 }; i < header.blockCount; ++i) {
+            Detail::append(index, header.blockOffset(i), 8);
+            Detail::append(index, plaintextLengthOf(i), 4);
+        }
+        Detail::append(index, header.blockOffset(header.blockCount), 8);
+        index.insert(index.end(), indexMagic.begin(), indexMagic.end());
+
+        const Utility::Bytes headerBytes { Detail::serialize(header) };
+        return ::pwrite(output.buffered, index.data(), index.size(), static_cast<off_t>(header.blockOffset(header.blockCount))) == static_cast<ssize_t>(index.size())
+            && ::pwrite(output.buffered, headerBytes.data(), headerBytes.size(), 0) == static_cast<ssize_t>(headerBytes.size());
+    }
+#endif
+
+    bool read(const Key::Public& publicKey, const Key::Private& privateKey, std::istream& in, std::ostream& out) {
+        const std::optional<Layout> layout { readLayout(in) };
+        if (!layout || layout->header.fingerprint != Hash::fingerprint(publicKey))
+            return false;
+
+        const std::optional<Key::CRT> crtKey { Generate::crt(privateKey) };
+        if (!crtKey)
+            return false;
+
+        for (unsigned long long int i { 0 }; i < layout->header.blockCount; ++i) {
+            const std::optional<Utility::Bytes> plaintext { readBlocks(in, *layout, *crtKey, i, 1) };
+            if (!plaintext)
+                return false;
+            out.write(reinterpret_cast<const char*>(plaintext->data()), static_cast<std::streamsize>(plaintext->size()));
+        }
+
+        return true;
+    }
+}
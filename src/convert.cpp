@@ -0,0 +1,42 @@
+#include <cassert>
+#include <iomanip>
+#include <limits>
+#include <optional>
+#include <sstream>
+#include <string>
+
+#include "rsa/convert.hpp"
+
+namespace Utility {
+    namespace Convert {
+        std::optional<long long int> toInteger(const Bytes& bytes) {
+            unsigned long long int x { 0 };
+            for (const unsigned char byte : bytes) {
+                if (x >> 55 != 0)
+                    return std::nullopt;
+                x = (x << 8) | byte;
+            }
+            if (x > static_cast<unsigned long long int>(std::numeric_limits<long long int>::max()))
+                return std::nullopt;
+            return static_cast<long long int>(x);
+        }
+
+        Bytes toBytes(long long int x, size_t length) {
+            assert(x >= 0 && byteLength(x) <= length && "Error: x doesn't fit into the requested number of bytes");
+
+            Bytes bytes(length, 0);
+            for (size_t i { length }; i > 0 && x > 0; --i) {
+                bytes[i - 1] = static_cast<unsigned char>(x & 0xff);
+                x >>= 8;
+            }
+            return bytes;
+        }
+
+        std::string toHex(const Bytes& bytes) {
+            std::ostringstream stream {};
+            for (const unsigned char byte : bytes)
+                stream << std::hex << std::setw(2) << std::setfill('0') << static_cast<int>(byte);
+            return stream.str();
+        }
+    }
+}
@@ -0,0 +1,60 @@
+#ifndef RSA_DETAIL_CIPHER_HPP
+#define RSA_DETAIL_CIPHER_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "rsa/convert.hpp"
+
+// Symmetric ciphers used once RSA has exchanged a key, for payloads too big to go through encode() block by block
+// Internal to the library: the random generator, key generation and Hybrid are built on them
+namespace Cipher {
+    namespace Detail {
+        constexpr std::uint32_t loadLittleEndian32(const unsigned char* bytes) {
+            return static_cast<std::uint32_t>(bytes[0]) | (static_cast<std::uint32_t>(bytes[1]) << 8) | (static_cast<std::uint32_t>(bytes[2]) << 16) | (static_cast<std::uint32_t>(bytes[3]) << 24);
+        }
+
+        constexpr std::uint64_t loadLittleEndian64(const unsigned char* bytes) {
+            return static_cast<std::uint64_t>(loadLittleEndian32(bytes)) | (static_cast<std::uint64_t>(loadLittleEndian32(bytes + 4)) << 32);
+        }
+
+        inline void storeLittleEndian64(unsigned char* bytes, std::uint64_t x) {
+            for (int i { 0 }; i < 8; ++i)
+                bytes[i] = static_cast<unsigned char>(x >> (8 * i));
+        }
+
+        constexpr std::size_t maxLanes { 16 };
+
+        // Widest block generator the processor runs: 4, 8 (AVX2) or 16 (AVX-512) blocks at a time
+        struct BlockGenerator {
+            std::size_t lanes;
+            void (*generate)(const std::uint32_t (&)[16], std::uint32_t, unsigned char*);
+        };
+
+        BlockGenerator blockGenerator();
+    }
+
+    // ChaCha20 stream cipher (RFC 8439) with a 32 byte key and a 12 byte nonce
+    namespace ChaCha20 {
+        constexpr std::size_t keySize { 32 };
+        constexpr std::size_t nonceSize { 12 };
+        constexpr std::size_t blockSize { 64 };
+
+        // XORs 'length' bytes of 'data' in place with the keystream, starting from block 'counter'
+        // Blocks are generated 4, 8 (AVX2) or 16 (AVX-512) at a time depending on the processor
+        void apply(const unsigned char* key, const unsigned char* nonce, std::uint32_t counter, unsigned char* data, std::size_t length);
+    }
+
+    // ChaCha20-Poly1305 AEAD (RFC 8439): encrypts and authenticates in place, additional data 'aad' is only authenticated
+    namespace ChaCha20Poly1305 {
+        constexpr std::size_t tagSize { 16 };
+
+        std::array<unsigned char, tagSize> seal(const unsigned char* key, const unsigned char* nonce, const Utility::Bytes& aad, unsigned char* data, std::size_t length);
+
+        // Checks the tag before decrypting, 'data' is left untouched when it doesn't match
+        bool open(const unsigned char* key, const unsigned char* nonce, const Utility::Bytes& aad, unsigned char* data, std::size_t length, const unsigned char* tag);
+    }
+}
+
+#endif
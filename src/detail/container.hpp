@@ -0,0 +1,87 @@
+#ifndef RSA_DETAIL_CONTAINER_HPP
+#define RSA_DETAIL_CONTAINER_HPP
+
+#include <array>
+#include <cstddef>
+#include <istream>
+#include <optional>
+#include <vector>
+
+#include "rsa/convert.hpp"
+#include "rsa/key.hpp"
+
+// Seekable container for data encoded block by block with encode(), any block can be found in O(1) and decoded on its own
+//
+// Layout:
+//   header (64 bytes): "RSAC" | version (1) | k (1) | 2 zero bytes | public key fingerprint (32) | block size (4) | block count (8) | plaintext length (8) | 4 zero bytes
+//   blocks: every block holds 'block size' plaintext bytes (fewer for the last one), split into chunks of k - 1 bytes.
+//           Each chunk is read as a number m < n and stored as encode(m) in k bytes, so every block has the same width on disk
+//   index: for every block, its offset in the file (8) and its plaintext length (4)
+//   footer (12 bytes): offset of the index (8) | "RSAI"
+// All numbers are big-endian
+namespace Container {
+    constexpr std::array<unsigned char, 4> magic { 'R', 'S', 'A', 'C' };
+    constexpr std::array<unsigned char, 4> indexMagic { 'R', 'S', 'A', 'I' };
+    constexpr unsigned char version { 1 };
+    constexpr std::size_t headerSize { 64 };
+    constexpr std::size_t indexEntrySize { 12 };
+    constexpr std::size_t footerSize { 12 };
+
+    struct Header {
+        Utility::Bytes fingerprint {};
+        std::size_t k {};
+        std::size_t blockSize {};
+        unsigned long long int blockCount {};
+        unsigned long long int plaintextLength {};
+
+        std::size_t chunkSize() const { return k - 1; }
+        std::size_t chunksPerBlock() const { return (blockSize + chunkSize() - 1) / chunkSize(); }
+        std::size_t ciphertextBlockSize() const { return chunksPerBlock() * k; }
+
+        // Where block 'i' starts, without looking at the index
+        unsigned long long int blockOffset(unsigned long long int i) const { return headerSize + i * ciphertextBlockSize(); }
+
+        // blockOffset() for a block count read from a file, nothing is returned if the offset doesn't fit 64 bits
+        std::optional<unsigned long long int> checkedBlockOffset(unsigned long long int i) const {
+            unsigned long long int offset {};
+            if (__builtin_mul_overflow(i, static_cast<unsigned long long int>(ciphertextBlockSize()), &offset) || __builtin_add_overflow(offset, headerSize, &offset))
+                return std::nullopt;
+            return offset;
+        }
+    };
+
+    struct IndexEntry {
+        unsigned long long int offset {};
+        std::size_t plaintextLength {};
+    };
+
+    // Header and index of a container, everything needed to find its blocks
+    struct Layout {
+        Header header {};
+        std::vector<IndexEntry> index {};
+    };
+    namespace Detail {
+        // Appends 'x' to 'bytes' as 'length' big-endian bytes
+        void append(Utility::Bytes& bytes, unsigned long long int x, std::size_t length);
+
+        // Reads 'length' big-endian bytes
+        unsigned long long int read(const unsigned char* bytes, std::size_t length);
+
+        Utility::Bytes serialize(const Header& header);
+
+        // Nothing is returned if 'bytes' isn't a valid header
+        std::optional<Header> parse(const Utility::Bytes& bytes);
+    }
+
+    // Encodes one block of plaintext into 'ciphertext', which must be header.ciphertextBlockSize() bytes long
+    // Chunks past the end of a short last block are encoded as zeros so the block keeps its width
+    void encryptBlock(const Key::Public& publicKey, const Header& header, const unsigned char* plaintext, std::size_t length, unsigned char* ciphertext);
+
+    // Decodes one block into 'plaintext', which must have room for 'length' bytes. Returns false if a chunk isn't a valid ciphertext
+    bool decryptBlock(const Key::CRT& crtKey, const Header& header, const unsigned char* ciphertext, std::size_t length, unsigned char* plaintext);
+
+    // Reads the header and the index of a container. Nothing is returned if they aren't consistent with each other
+    std::optional<Layout> readLayout(std::istream& in);
+}
+
+#endif
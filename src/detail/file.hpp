@@ -0,0 +1,91 @@
+#ifndef RSA_DETAIL_FILE_HPP
+#define RSA_DETAIL_FILE_HPP
+
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <utility>
+
+#if defined(__unix__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace Utility {
+    namespace File {
+        // A whole file mapped into memory, unmapped and closed when the object goes away
+        // Read-only mappings open an existing file, writable ones create (or truncate) the file with the given size
+        class Mapping {
+        public:
+            static std::optional<Mapping> openRead(const std::string& filename) {
+                Mapping mapping {};
+                mapping.descriptor = ::open(filename.c_str(), O_RDONLY);
+                if (mapping.descriptor < 0)
+                    return std::nullopt;
+
+                struct stat status {};
+                if (::fstat(mapping.descriptor, &status) != 0)
+                    return std::nullopt;
+
+                if (!mapping.map(static_cast<std::size_t>(status.st_size), PROT_READ))
+                    return std::nullopt;
+                return mapping;
+            }
+
+            static std::optional<Mapping> createWrite(const std::string& filename, std::size_t size) {
+                Mapping mapping {};
+                mapping.descriptor = ::open(filename.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+                if (mapping.descriptor < 0 || ::ftruncate(mapping.descriptor, static_cast<off_t>(size)) != 0)
+                    return std::nullopt;
+
+                if (!mapping.map(size, PROT_READ | PROT_WRITE))
+                    return std::nullopt;
+                return mapping;
+            }
+
+            Mapping(Mapping&& other) noexcept
+                : descriptor { std::exchange(other.descriptor, -1) }, address { std::exchange(other.address, nullptr) }, length { std::exchange(other.length, 0) } {}
+
+            Mapping& operator=(Mapping&& other) noexcept {
+                std::swap(descriptor, other.descriptor);
+                std::swap(address, other.address);
+                std::swap(length, other.length);
+                return *this;
+            }
+
+            ~Mapping() {
+                if (address != nullptr)
+                    ::munmap(address, length);
+                if (descriptor >= 0)
+                    ::close(descriptor);
+            }
+
+            unsigned char* data() const { return static_cast<unsigned char*>(address); }
+            std::size_t size() const { return length; }
+
+        private:
+            Mapping() = default;
+
+            bool map(std::size_t size, int protection) {
+                length = size;
+                if (size == 0)
+                    return true; // Empty files can't be mapped, there is nothing to read or write anyway
+
+                void* const mapped { ::mmap(nullptr, size, protection, MAP_SHARED, descriptor, 0) };
+                if (mapped == MAP_FAILED)
+                    return false;
+
+                address = mapped;
+                return true;
+            }
+
+            int descriptor { -1 };
+            void* address { nullptr };
+            std::size_t length { 0 };
+        };
+    }
+}
+#endif
+
+#endif
@@ -0,0 +1,125 @@
+#ifndef RSA_DETAIL_IO_HPP
+#define RSA_DETAIL_IO_HPP
+
+#include <cstddef>
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#include <new>
+#include <string>
+#include <utility>
+#include <vector>
+
+#if defined(__linux__)
+#include <fcntl.h>
+#include <unistd.h>
+
+// Asynchronous file I/O for bulk jobs on files bigger than the page cache: many reads and writes are kept in flight at once
+// instead of one thread blocking on every page fault. io_uring is used when the kernel allows it, otherwise a pool of
+// threads doing pread/pwrite takes its place behind the same interface
+namespace IO {
+    // Direct I/O needs buffers, offsets and lengths aligned to the device's logical block size, 4096 covers every common device
+    constexpr std::size_t directAlignment { 4096 };
+
+    constexpr std::size_t alignDown(std::size_t x) { return x / directAlignment * directAlignment; }
+    constexpr std::size_t alignUp(std::size_t x) { return (x + directAlignment - 1) / directAlignment * directAlignment; }
+
+    // Memory aligned for direct I/O. Throws std::bad_alloc like any other allocation if there isn't enough memory
+    class AlignedBuffer {
+    public:
+        explicit AlignedBuffer(std::size_t size = 0)
+            : data_ { static_cast<unsigned char*>(size == 0 ? nullptr : std::aligned_alloc(directAlignment, alignUp(size))) }, size_ { size } {
+            if (size != 0 && data_ == nullptr)
+                throw std::bad_alloc {};
+        }
+
+        AlignedBuffer(AlignedBuffer&& other) noexcept
+            : data_ { std::exchange(other.data_, nullptr) }, size_ { std::exchange(other.size_, 0) } {}
+
+        AlignedBuffer& operator=(AlignedBuffer&& other) noexcept {
+            std::swap(data_, other.data_);
+            std::swap(size_, other.size_);
+            return *this;
+        }
+
+        ~AlignedBuffer() { std::free(data_); }
+
+        unsigned char* data() const { return data_; }
+        std::size_t size() const { return size_; }
+
+    private:
+        unsigned char* data_;
+        std::size_t size_;
+    };
+
+    struct Request {
+        int descriptor {};
+        bool isWrite {};
+        unsigned char* buffer {};
+        std::size_t length {};
+        unsigned long long int offset {};
+        unsigned long long int tag {};  // Given back untouched with the completion
+    };
+
+    struct Completion {
+        unsigned long long int tag {};
+        long long int result {};        // Bytes transferred, or -errno
+    };
+
+    // submit() can be called from any thread, wait() only from one
+    class Backend {
+    public:
+        virtual ~Backend() = default;
+        virtual void submit(const Request& request) = 0;
+        virtual Completion wait() = 0;
+        virtual const char* name() const = 0;
+    };
+
+    // io_uring when possible, the thread pool otherwise
+    std::unique_ptr<Backend> makeBackend(unsigned int queueDepth);
+
+    // A file opened twice: once for direct I/O (when the file system allows it) and once through the page cache.
+    // Requests that aren't aligned for direct I/O use the buffered descriptor. Reads are widened to aligned ranges and writes
+    // are split into an aligned middle and unaligned edges by runPipeline(), so the bulk of every transfer goes direct
+    struct File {
+        int direct { -1 };
+        int buffered { -1 };
+
+        File(const std::string& filename, int flags, bool useDirect) {
+            buffered = ::open(filename.c_str(), flags, 0644);
+            if (useDirect && buffered >= 0)
+                direct = ::open(filename.c_str(), (flags & ~(O_CREAT | O_TRUNC)) | O_DIRECT);
+        }
+
+        File(const File&) = delete;
+        File& operator=(const File&) = delete;
+
+        ~File() {
+            if (direct >= 0)
+                ::close(direct);
+            if (buffered >= 0)
+                ::close(buffered);
+        }
+
+        int descriptorFor(unsigned long long int offset, std::size_t length) const {
+            return direct >= 0 && offset % directAlignment == 0 && length % directAlignment == 0 ? direct : buffered;
+        }
+    };
+
+    // One unit of a bulk job: read 'readLength' bytes at 'readOffset', transform them, write 'writeLength' bytes at 'writeOffset'
+    struct Segment {
+        unsigned long long int readOffset {};
+        std::size_t readLength {};
+        unsigned long long int writeOffset {};
+        std::size_t writeLength {};
+    };
+
+    // Runs every segment through read -> transform -> write with at most 'queueDepth' segments in flight.
+    // This thread only drives I/O completions, 'threadCount' workers run the transforms as soon as their reads complete
+    // and submit the writes themselves. Returns false if any read, write or transform fails
+    bool runPipeline(Backend& backend, const File& input, const File& output, const std::vector<Segment>& segments,
+                     const std::function<bool(std::size_t, const unsigned char*, unsigned char*)>& transform, std::size_t queueDepth, std::size_t threadCount);
+}
+#endif
+
+#endif
@@ -0,0 +1,78 @@
+#ifndef RSA_DETAIL_SHARDING_HPP
+#define RSA_DETAIL_SHARDING_HPP
+
+#include <cstddef>
+#include <cstring>
+#include <functional>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+#if defined(__unix__)
+#include <sys/mman.h>
+
+// Multi-process batch jobs, for hosts where per-process memory limits make threads alone not enough
+// A coordinator forks worker processes; they read the prepared key from one read-only shared page and claim work
+// in chunks from a shared atomic counter, so nothing is duplicated per process and the load balances itself
+namespace Sharding {
+    // One read-only value in shared memory, inherited by every forked process. The page exists once, whatever the process count
+    template <typename T>
+    class Shared {
+        static_assert(std::is_trivially_copyable_v<T>, "Error: only plain data can be shared between processes");
+
+    public:
+        static std::optional<Shared> create(const T& value) {
+            void* const mapped { ::mmap(nullptr, sizeof(T), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0) };
+            if (mapped == MAP_FAILED)
+                return std::nullopt;
+
+            std::memcpy(mapped, &value, sizeof(T));
+            // Sealed before any worker exists, a stray write in a worker faults instead of corrupting the others' key
+            if (::mprotect(mapped, sizeof(T), PROT_READ) != 0) {
+                ::munmap(mapped, sizeof(T));
+                return std::nullopt;
+            }
+            return Shared { static_cast<const T*>(mapped) };
+        }
+
+        Shared(Shared&& other) noexcept
+            : value { std::exchange(other.value, nullptr) } {
+        }
+
+        Shared& operator=(Shared&& other) noexcept {
+            if (this != &other) {
+                release();
+                value = std::exchange(other.value, nullptr);
+            }
+            return *this;
+        }
+
+        ~Shared() {
+            release();
+        }
+
+        const T& get() const { return *value; }
+
+    private:
+        explicit Shared(const T* value)
+            : value { value } {
+        }
+
+        void release() {
+            if (value)
+                ::munmap(const_cast<T*>(value), sizeof(T));
+        }
+
+        const T* value {};
+    };
+
+    // Runs work(first, last) over the items [0, itemCount) in chunks of 'chunkSize', on 'processCount' forked processes
+    // 'work' returns false on failure, which stops every worker. Anything 'work' writes must go to shared memory
+    // (like a MAP_SHARED file mapping) to be seen by the coordinator. Workers end with _exit, so they never run the
+    // destructors of objects (thread pools) that only exist in the coordinator
+    bool run(std::size_t processCount, unsigned long long int itemCount, unsigned long long int chunkSize,
+             const std::function<bool(unsigned long long int, unsigned long long int)>& work);
+}
+#endif
+
+#endif
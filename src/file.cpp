@@ -0,0 +1,79 @@
+#include <fstream>
+#include <iostream>
+#include <optional>
+#include <string>
+
+#include "rsa/file.hpp"
+#include "rsa/key.hpp"
+
+namespace Utility {
+    namespace File {
+        bool saveTo(const std::string& filename, const Key::Public& key) {
+            std::fstream fs{};
+
+            fs.open(filename);
+
+            if (!fs.is_open()) {
+                std::cout << "Couldn't open existing file. Creating " << filename << "...\n";
+                fs.clear();
+                fs.open(filename, std::ios::out);
+                fs.close();
+                fs.open(filename);
+                std::cout << "File created.\n";
+            }
+
+            fs.clear(); // Cleanup the files contents before writing to it. Potentially unsafe and can be used to delete contents in important files
+
+            fs << "n: " << key.n << '\n' << "e: " << key.e; // Write the key to the file
+            fs.close();
+            return !fs.fail();
+        }
+
+        bool saveTo(const std::string& filename, const Key::Private& key) {
+            std::fstream fs{};
+
+            fs.open(filename);
+
+            if (!fs.is_open()) {
+                std::cout << "Couldn't open existing file. Creating " << filename << "...\n";
+                fs.clear();
+                fs.open(filename, std::ios::out);
+                fs.close();
+                fs.open(filename);
+                std::cout << "File created.\n";
+            }
+
+            fs.clear(); // Cleanup the files contents before writing to it. Potentially unsafe and can be used to delete contents in important files
+
+            fs << "p: " << key.p << '\n' << "q: " << key.q << '\n' << "d: " << key.d; // Write the key to the file
+            fs.close();
+            return !fs.fail();
+        }
+
+        std::optional<Key::Public> loadPublic(const std::string& filename) {
+            std::ifstream fs { filename };
+
+            Key::Public key {};
+            std::string label_n {}, label_e {};
+            if (!(fs >> label_n >> key.n >> label_e >> key.e) || label_n != "n:" || label_e != "e:")
+                return std::nullopt;
+            if (key.n < 2 || key.e < 1)
+                return std::nullopt;
+
+            return key;
+        }
+
+        std::optional<Key::Private> loadPrivate(const std::string& filename) {
+            std::ifstream fs { filename };
+
+            Key::Private key {};
+            std::string label_p {}, label_q {}, label_d {};
+            if (!(fs >> label_p >> key.p >> label_q >> key.q >> label_d >> key.d) || label_p != "p:" || label_q != "q:" || label_d != "d:")
+                return std::nullopt;
+            if (key.p < 2 || key.q < 2 || key.d < 1)
+                return std::nullopt;
+
+            return key;
+        }
+    }
+}
@@ -0,0 +1,269 @@
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <condition_variable>
+#include <cstring>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+
+#if defined(__unix__)
+#include <unistd.h>
+#endif
+
+#include "rsa/concurrency.hpp"
+#include "rsa/container.hpp"
+#include "rsa/convert.hpp"
+#include "rsa/filter.hpp"
+#include "rsa/generate.hpp"
+#include "rsa/key.hpp"
+#include "rsa/rsa.hpp"
+
+#include "detail/container.hpp"
+
+#if defined(__unix__)
+// Filter mode for shell pipelines (tar | rsa encrypt | zstd): raw bytes come in on stdin and go out on stdout
+// Input is read in large batches of blocks, the batches are encoded on every core and a reorder buffer puts them back
+// in order before they are written out with large write() calls
+//
+// Stream layout: "RSAF" | k (1 byte) | block size (4 bytes) | frames, every frame is
+//   plaintext length (4 bytes) | ciphertext block (fixed width, same encoding as Container blocks)
+// and a frame with length 0 ends the stream, so a cut off stream is noticed
+namespace Filter {
+    constexpr std::array<unsigned char, 4> magic { 'R', 'S', 'A', 'F' };
+    constexpr size_t headerSize { 9 };
+    constexpr size_t lengthSize { 4 };
+    constexpr size_t batchBlocks { 256 };
+
+    // Reads until 'length' bytes arrived or the input ended, returns how many bytes were read (or -1 on error)
+    long long int readFully(int descriptor, unsigned char* data, size_t length) {
+        size_t done { 0 };
+        while (done < length) {
+            const ssize_t result { ::read(descriptor, data + done, length - done) };
+            if (result < 0 && errno == EINTR)
+                continue;
+            if (result < 0)
+                return -1;
+            if (result == 0)
+                break;
+            done += static_cast<size_t>(result);
+        }
+        return static_cast<long long int>(done);
+    }
+
+    bool writeFully(int descriptor, const unsigned char* data, size_t length) {
+        while (length > 0) {
+            const ssize_t result { ::write(descriptor, data, length) };
+            if (result < 0 && errno == EINTR)
+                continue;
+            if (result <= 0)
+                return false;
+            data += result;
+            length -= static_cast<size_t>(result);
+        }
+        return true;
+    }
+
+    // Reads batches with 'read', transforms them on 'threadCount' threads with 'transform' and writes them in their original order.
+    // 'read' returns the batch (empty at the end of the input) or nothing on error, 'transform' turns a batch into its output
+    bool run(const std::function<std::optional<Utility::Bytes>()>& read, const std::function<std::optional<Utility::Bytes>(const Utility::Bytes&)>& transform, size_t threadCount, bool isPinned) {
+        threadCount = std::max<size_t>(1, threadCount);
+        const size_t maxInFlight { 2 * threadCount + 2 };
+
+        std::mutex mutex {};
+        std::condition_variable changed {};
+        std::unordered_map<unsigned long long int, std::optional<Utility::Bytes>> finished {};   // The reorder buffer
+        unsigned long long int nextToWrite { 0 };
+        unsigned long long int batchCount { 0 };
+        bool isInputDone { false };
+        bool isValid { true };
+
+        // Batches go through the lock-free queue of the pool, the mutex only guards the reorder buffer
+        Concurrency::WorkerPool workers { threadCount, maxInFlight, isPinned };
+
+        std::thread writer { [&] {
+            while (true) {
+                std::optional<Utility::Bytes> output {};
+                {
+                    std::unique_lock lock { mutex };
+                    changed.wait(lock, [&] { return finished.count(nextToWrite) > 0 || (isInputDone && nextToWrite == batchCount); });
+                    if (finished.count(nextToWrite) == 0)
+                        return;
+                    output = std::move(finished[nextToWrite]);
+                    finished.erase(nextToWrite);
+                    ++nextToWrite;
+                }
+                changed.notify_all();
+
+                bool shouldWrite {};
+                {
+                    std::lock_guard lock { mutex };
+                    isValid = isValid && output.has_value();
+                    shouldWrite = isValid;
+                }
+
+                // Nothing more is written once a batch failed, but the remaining batches are still drained
+                if (shouldWrite && !writeFully(STDOUT_FILENO, output->data(), output->size())) {
+                    std::lock_guard lock { mutex };
+                    isValid = false;
+                }
+            }
+        } };
+
+        while (true) {
+            std::optional<Utility::Bytes> batch { read() };
+
+            std::unique_lock lock { mutex };
+            if (!batch || batch->empty() || !isValid) {
+                isValid = isValid && batch.has_value();
+                isInputDone = true;
+                break;
+            }
+
+            // Backpressure: the reader waits while too many batches are being transformed or wait to be written
+            changed.wait(lock, [&] { return batchCount - nextToWrite < maxInFlight; });
+            const unsigned long long int index { batchCount++ };
+            lock.unlock();
+
+            workers.submit([&, index, input = std::move(*batch)] {
+                std::optional<Utility::Bytes> output { transform(input) };
+                {
+                    std::lock_guard lock { mutex };
+                    finished.emplace(index, std::move(output));
+                }
+                changed.notify_all();
+            });
+        }
+        changed.notify_all();
+
+        writer.join();
+
+        return isValid;
+    }
+
+    Container::Header blockLayout(const Key::Public& publicKey, size_t blockSize) {
+        Container::Header header {};
+        header.k = Utility::Convert::byteLength(publicKey.n);
+        header.blockSize = blockSize;
+        return header;
+    }
+
+    bool encrypt(const Key::Public& publicKey, size_t threadCount, size_t blockSize, bool isPinned) {
+        const Container::Header header { blockLayout(publicKey, blockSize) };
+        if (header.k < 2 || blockSize == 0 || blockSize > maxBlockSize)
+            return false;
+
+        Utility::Bytes streamHeader { magic.begin(), magic.end() };
+        streamHeader.push_back(static_cast<unsigned char>(header.k));
+        Container::Detail::append(streamHeader, blockSize, 4);
+        if (!writeFully(STDOUT_FILENO, streamHeader.data(), streamHeader.size()))
+            return false;
+
+        bool isInputDone { false };
+        const auto read { [&]() -> std::optional<Utility::Bytes> {
+            if (isInputDone)
+                return Utility::Bytes {};
+
+            Utility::Bytes batch(batchBlocks * blockSize);
+            const long long int length { readFully(STDIN_FILENO, batch.data(), batch.size()) };
+            if (length < 0)
+                return std::nullopt;
+
+            isInputDone = static_cast<size_t>(length) < batch.size();
+            batch.resize(static_cast<size_t>(length));
+            return batch;
+        } };
+
+        const size_t frameSize { lengthSize + header.ciphertextBlockSize() };
+        const auto transform { [&](const Utility::Bytes& batch) -> std::optional<Utility::Bytes> {
+            const size_t blocks { (batch.size() + blockSize - 1) / blockSize };
+
+            Utility::Bytes frames(blocks * frameSize);
+            for (size_t i { 0 }; i < blocks; ++i) {
+                const size_t length { std::min(blockSize, batch.size() - i * blockSize) };
+                unsigned char* const frame { frames.data() + i * frameSize };
+
+                const Utility::Bytes lengthBytes { Utility::Convert::toBytes(static_cast<long long int>(length), lengthSize) };
+                std::memcpy(frame, lengthBytes.data(), lengthSize);
+                Container::encryptBlock(publicKey, header, batch.data() + i * blockSize, length, frame + lengthSize);
+            }
+            return frames;
+        } };
+
+        if (!run(read, transform, threadCount, isPinned))
+            return false;
+
+        const std::array<unsigned char, lengthSize> end {};
+        return writeFully(STDOUT_FILENO, end.data(), end.size());
+    }
+
+    bool decrypt(const Key::Public& publicKey, const Key::Private& privateKey, size_t threadCount, bool isPinned) {
+        std::array<unsigned char, headerSize> streamHeader {};
+        if (readFully(STDIN_FILENO, streamHeader.data(), streamHeader.size()) != static_cast<long long int>(headerSize) || !std::equal(magic.begin(), magic.end(), streamHeader.begin()))
+            return false;
+
+        // The block size comes from the stream: it is bounded before any frame size is computed or allocated from it
+        const size_t blockSize { static_cast<size_t>(Container::Detail::read(streamHeader.data() + 5, 4)) };
+        const Container::Header header { blockLayout(publicKey, blockSize) };
+        if (header.k < 2 || streamHeader[4] != header.k || blockSize == 0 || blockSize > maxBlockSize)
+            return false;
+
+        const size_t frameSize { lengthSize + header.ciphertextBlockSize() };
+        bool hasEnded { false };
+
+        // Frames are read one batch at a time, the end marker stops the reading
+        const auto read { [&]() -> std::optional<Utility::Bytes> {
+            if (hasEnded)
+                return Utility::Bytes {};
+
+            // Grows with the frames actually read, a short stream doesn't get a whole batch allocated up front
+            Utility::Bytes batch {};
+            for (size_t i { 0 }; i < batchBlocks; ++i) {
+                std::array<unsigned char, lengthSize> lengthBytes {};
+                if (readFully(STDIN_FILENO, lengthBytes.data(), lengthSize) != static_cast<long long int>(lengthSize))
+                    return std::nullopt;
+
+                const size_t length { static_cast<size_t>(Container::Detail::read(lengthBytes.data(), lengthSize)) };
+                if (length == 0) {
+                    hasEnded = true;
+                    break;
+                }
+                if (length > blockSize)
+                    return std::nullopt;
+
+                const size_t position { batch.size() };
+                batch.resize(position + frameSize);
+                std::memcpy(batch.data() + position, lengthBytes.data(), lengthSize);
+                if (readFully(STDIN_FILENO, batch.data() + position + lengthSize, frameSize - lengthSize) != static_cast<long long int>(frameSize - lengthSize))
+                    return std::nullopt;
+            }
+            return batch;
+        } };
+
+        const std::optional<Key::CRT> crtKey { Generate::crt(privateKey) };
+        if (!crtKey)
+            return false;
+
+        Concurrency::NodeLocal<Key::CRT> crtKeys { *crtKey };
+        const auto transform { [&](const Utility::Bytes& batch) -> std::optional<Utility::Bytes> {
+            const Key::CRT& crtKey { crtKeys.local() };
+            Utility::Bytes plaintext {};
+            plaintext.reserve(batch.size() / frameSize * blockSize);
+
+            for (size_t position { 0 }; position < batch.size(); position += frameSize) {
+                const size_t length { static_cast<size_t>(Container::Detail::read(batch.data() + position, lengthSize)) };
+                const size_t start { plaintext.size() };
+                plaintext.resize(start + length);
+                if (!Container::decryptBlock(crtKey, header, batch.data() + position + lengthSize, length, plaintext.data() + start))
+                    return std::nullopt;
+            }
+            return plaintext;
+        } };
+
+        return run(read, transform, threadCount, isPinned) && hasEnded;
+    }
+}
+#endif
@@ -0,0 +1,430 @@
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "rsa/bignum.hpp"
+#include "rsa/concurrency.hpp"
+#include "rsa/convert.hpp"
+#include "rsa/generate.hpp"
+#include "rsa/hash.hpp"
+#include "rsa/key.hpp"
+#include "rsa/math.hpp"
+#include "rsa/random.hpp"
+
+#include "detail/cipher.hpp"
+
+namespace Generate {
+    Key::Public publicKey(const long long int p, const long long int q) {
+        assert(Utility::Math::isPrime(p) && Utility::Math::isPrime(q) && "ERROR: p and/or q are not prime numbers."); // Make sure p and q are prime numbers
+
+        const long long int n { p * q };
+
+        const long long int n_eulero { Utility::Math::phi(n, p, q) }; // Calculates phi(n)
+
+        // Chooses the first value that is correct for 'e'
+        long long int e {};
+        for (long long int i { 2 }; i < n_eulero; ++i)
+            if (Utility::Math::areCoprimes(i, n_eulero)) {
+                e = i;
+                break;
+            }
+
+        return Key::Public { n, e };
+    }
+
+    Key::Private privateKey(const long long int p, const long long int q, const Key::Public& publicKey) {
+        assert(Utility::Math::isPrime(p) && Utility::Math::isPrime(q) && "ERROR: p and/or q are not prime numbers."); // Make sure p and q are prime numbers
+        
+        const long long int n_eulero { Utility::Math::phi(publicKey.n, p, q) }; // Calculates phi(n) again
+
+        // d = (1 + k * phi(n)) / e for the smallest k that divides evenly, which is the inverse of e modulo phi(n)
+        // publicKey() picked 'e' coprime with phi(n), so the inverse exists
+        const long long int d { *Utility::Math::modInverse(publicKey.e, n_eulero) };
+
+        return Key::Private { p, q, d };
+    }
+
+    std::optional<Key::CRT> crt(const Key::Private& privateKey) {
+        const long long int p { privateKey.p };
+        const long long int q { privateKey.q };
+        if (p < 2 || q < 2)
+            return std::nullopt;
+
+        const std::optional<long long int> qInv { Utility::Math::modInverse(q % p, p) };
+        if (!qInv)
+            return std::nullopt;
+
+        return Key::CRT { p, q, privateKey.d % (p - 1), privateKey.d % (q - 1), *qInv };
+    }
+
+    namespace Detail {
+        // e of the generated keys
+        constexpr long long int publicExponent { 65537 };
+
+        // Random stream of a seeded key: ChaCha20 keyed with SHA-256(seed), with the key's index as nonce
+        // ChaCha20's output doesn't depend on the processor, so a seed and index give the same key everywhere
+        class SeededStream {
+        public:
+            SeededStream(const std::string& seed, std::uint64_t index)
+                : key { Hash::sha256(Utility::Bytes(seed.begin(), seed.end())) } {
+                Cipher::Detail::storeLittleEndian64(nonce.data() + 4, index);
+            }
+
+            std::uint64_t next() {
+                if (position == buffer.size()) {
+                    buffer.fill(0);
+                    Cipher::ChaCha20::apply(key.data(), nonce.data(), counter, buffer.data(), buffer.size());
+                    counter += static_cast<std::uint32_t>(buffer.size() / Cipher::ChaCha20::blockSize);
+                    position = 0;
+                }
+
+                const std::uint64_t value { Cipher::Detail::loadLittleEndian64(buffer.data() + position) };
+                position += sizeof(value);
+                return value;
+            }
+
+        private:
+            Utility::Bytes key;
+            std::array<unsigned char, Cipher::ChaCha20::nonceSize> nonce {};
+            std::array<unsigned char, 4 * Cipher::ChaCha20::blockSize> buffer {};
+            size_t position { buffer.size() };
+            std::uint32_t counter { 0 };
+        };
+
+        // Draws 'bits' bit candidates until one is prime and p - 1 is coprime with e. The two top bits are set, so the product
+        // of two such primes always has exactly 2 * bits bits
+        long long int seededPrime(SeededStream& stream, size_t bits) {
+            while (true) {
+                const long long int candidate { static_cast<long long int>(stream.next() >> (64 - bits)) | (3LL << (bits - 2)) | 1 };
+                if ((candidate - 1) % publicExponent != 0 && Utility::Math::millerRabin(candidate))
+                    return candidate;
+            }
+        }
+
+        // Key set file: the seed (hexadecimal), the prime size and key count, one "key: p q d" line per key, then its digest
+        // Returns false if the file couldn't be written completely
+        bool saveKeySet(const std::string& filename, const std::string& seed, size_t primeBits, const std::vector<KeyPair>& keys) {
+            std::ofstream fs { filename, std::ios::trunc };
+
+            fs << "seed: " << Utility::Convert::toHex(Utility::Bytes(seed.begin(), seed.end())) << '\n'
+               << "bits: " << primeBits << '\n'
+               << "count: " << keys.size() << '\n';
+            for (const KeyPair& pair : keys)
+                fs << "key: " << pair.privateKey.p << ' ' << pair.privateKey.q << ' ' << pair.privateKey.d << '\n';
+            fs << "sha256: " << keySetDigest(keys) << '\n';
+
+            fs.close();
+            return !fs.fail();
+        }
+
+        // Nothing is returned unless the file holds exactly the requested set and its keys still match their digest
+        std::optional<std::vector<KeyPair>> loadKeySet(const std::string& filename, const std::string& seed, size_t count, size_t primeBits) {
+            std::ifstream fs { filename };
+
+            std::string label_seed {}, label_bits {}, label_count {}, fileSeed {};
+            size_t fileBits {}, fileCount {};
+            if (!(fs >> label_seed >> fileSeed >> label_bits >> fileBits >> label_count >> fileCount) || label_seed != "seed:" || label_bits != "bits:" || label_count != "count:")
+                return std::nullopt;
+            if (fileSeed != Utility::Convert::toHex(Utility::Bytes(seed.begin(), seed.end())) || fileBits != primeBits || fileCount != count)
+                return std::nullopt;
+
+            std::vector<KeyPair> keys(count);
+            for (KeyPair& pair : keys) {
+                std::string label_key {};
+                Key::Private& key { pair.privateKey };
+                if (!(fs >> label_key >> key.p >> key.q >> key.d) || label_key != "key:" || key.p < 2 || key.q < 2)
+                    return std::nullopt;
+                pair.publicKey = Key::Public { key.p * key.q, publicExponent };
+            }
+
+            std::string label_digest {}, digest {};
+            if (!(fs >> label_digest >> digest) || label_digest != "sha256:" || digest != keySetDigest(keys))
+                return std::nullopt;
+
+            return keys;
+        }
+
+        // Candidates sieved at once
+        constexpr size_t sieveWindow { 2048 };
+
+        // Miller-Rabin for numbers already known to have no factor below 1024
+        bool isSievedPrime(long long int x) {
+            return Utility::Math::millerRabin(x, false);
+        }
+
+        // Searches the odd numbers c = base + 2i, i < sieveWindow, c < limit for a safe prime p = 2c + 1
+        // All of them are sieved together against the small primes first, c is crossed out if c or 2c + 1 has a small factor.
+        // Only survivors get a Miller-Rabin test, c before 2c + 1, which fails far more often
+        std::optional<long long int> safeSieveSearch(long long int base, long long int limit, const std::atomic<bool>& isFound) {
+            std::array<bool, sieveWindow> isCrossed {};
+
+            // i with base + 2i = x (mod r) is (x - base) / 2 mod r, halving mod an odd r is a shift, after adding r if odd
+            const auto half = [](std::uint32_t x, std::uint32_t r) { return (x & 1) == 0 ? x / 2 : (x + r) / 2; };
+
+            for (size_t index { 1 }; index < Utility::Math::smallPrimes.size(); ++index) {
+                const std::uint32_t r { static_cast<std::uint32_t>(Utility::Math::smallPrimes[index]) };
+                const std::uint32_t b { static_cast<std::uint32_t>(static_cast<unsigned long long int>(base) % r) };
+
+                // base + 2i = 0 (mod r)
+                for (size_t i { half(b == 0 ? 0 : r - b, r) }; i < sieveWindow; i += r)
+                    isCrossed[i] = true;
+
+                // 2(base + 2i) + 1 = 0 (mod r), that is base + 2i = (r - 1) / 2
+                for (size_t i { half(((r - 1) / 2 + r - b) % r, r) }; i < sieveWindow; i += r)
+                    isCrossed[i] = true;
+            }
+
+            for (size_t i { 0 }; i < sieveWindow && !isFound.load(std::memory_order_relaxed); ++i) {
+                const long long int c { base + 2 * static_cast<long long int>(i) };
+                if (c >= limit)
+                    break;
+                if (!isCrossed[i] && isSievedPrime(c) && isSievedPrime(2 * c + 1))
+                    return 2 * c + 1;
+            }
+            return std::nullopt;
+        }
+
+        // Prime of 'bits' bits with its 'topBits' top bits set, drawn one odd candidate at a time
+        // Most candidates fail the trial division by 3, 5 or 7 at once, at this size cheaper than setting up a sieve
+        long long int drawnPrime(size_t bits, size_t topBits) {
+            const long long int top { ((1LL << topBits) - 1) << (bits - topBits) };
+            while (true) {
+                const long long int candidate { static_cast<long long int>(Utility::Random::below(1ULL << (bits - topBits))) | top | 1 };
+                if (Utility::Math::millerRabin(candidate))
+                    return candidate;
+            }
+        }
+
+        // One round of Gordon's algorithm: primes s and t, then a prime r = 2it + 1, then p = p0 + 2jrs with p0 = 2(s^(r-2) mod r)s - 1,
+        // which makes p = 1 (mod r) and p = -1 (mod s). The p's that fit 'bits' bits are tried from a random j on
+        std::optional<StrongPrime> gordonSearch(size_t bits) {
+            if (bits < minStrongPrimeBits || bits > maxPrimeBits)
+                return std::nullopt;
+
+            const long long int s { drawnPrime(bits / 2 - 2, 1) };
+            const long long int t { drawnPrime(bits / 2 - 6, 1) };
+
+            long long int r { 2 * t + 1 };
+            while (!Utility::Math::millerRabin(r))
+                r += 2 * t;
+            if (r == s)
+                return std::nullopt;
+
+            const long long int p0 { 2 * Utility::Math::modPower(s, r - 2, r) * s - 1 };
+            const long long int step { 2 * r * s };
+            const long long int low { 3LL << (bits - 2) }, high { 1LL << bits };
+
+            const long long int first { p0 + (low - p0 + step - 1) / step * step };
+            if (first >= high)
+                return std::nullopt;
+
+            for (long long int p { first + static_cast<long long int>(Utility::Random::below(static_cast<std::uint64_t>((high - first + step - 1) / step))) * step }; p < high; p += step)
+                if (Utility::Math::millerRabin(p))
+                    return StrongPrime { p, r, s, t };
+            return std::nullopt;
+        }
+    }
+
+    std::optional<StrongPrime> randomStrongPrime(size_t bits) {
+        if (bits < minStrongPrimeBits || bits > maxPrimeBits)
+            return std::nullopt;
+
+        // Every worker searches on its own, the first prime found wins
+        std::atomic<bool> isFound { false };
+        StrongPrime prime {};
+
+        Concurrency::WorkerPool& pool { Concurrency::defaultPool() };
+        pool.parallelFor(pool.size(), [&](size_t) {
+            while (!isFound.load(std::memory_order_relaxed))
+                if (const std::optional<StrongPrime> found { Detail::gordonSearch(bits) }; found && !isFound.exchange(true, std::memory_order_acq_rel))
+                    prime = *found;
+        }, Concurrency::Priority::Bulk);
+
+        return prime;
+    }
+
+    std::optional<long long int> randomPrime(size_t bits, PrimeKind kind) {
+        if (bits < minRandomPrimeBits || bits > maxPrimeBits)
+            return std::nullopt;
+
+        if (kind == PrimeKind::Ordinary)
+            return Detail::drawnPrime(bits, 2);
+        if (kind == PrimeKind::Strong) {
+            const std::optional<StrongPrime> strong { randomStrongPrime(bits) };
+            return strong ? std::optional<long long int> { strong->p } : std::nullopt;
+        }
+
+        // Candidates p' = (p - 1) / 2 of a safe prime, keeping p's two top bits set
+        const long long int low { 3LL << (bits - 3) };
+        const long long int high { 1LL << (bits - 1) };
+
+        // Every worker searches on its own, the first prime found wins
+        std::atomic<bool> isFound { false };
+        long long int prime { 0 };
+
+        Concurrency::WorkerPool& pool { Concurrency::defaultPool() };
+        pool.parallelFor(pool.size(), [&](size_t) {
+            while (!isFound.load(std::memory_order_relaxed)) {
+                const long long int base { (low + static_cast<long long int>(Utility::Random::below(static_cast<std::uint64_t>(high - low)))) | 1 };
+                if (const std::optional<long long int> found { Detail::safeSieveSearch(base, high, isFound) }; found && !isFound.exchange(true, std::memory_order_acq_rel))
+                    prime = *found;
+            }
+        }, Concurrency::Priority::Bulk);
+
+        return prime;
+    }
+
+    std::optional<KeyPair> randomKeyPair(size_t primeBits, PrimeKind kind) {
+        if (primeBits < (kind == PrimeKind::Strong ? minStrongPrimeBits : minRandomPrimeBits) || primeBits > maxPrimeBits)
+            return std::nullopt;
+
+        const auto draw = [&] {
+            long long int prime { *randomPrime(primeBits, kind) };
+            while ((prime - 1) % Detail::publicExponent == 0)
+                prime = *randomPrime(primeBits, kind);
+            return prime;
+        };
+
+        const long long int p { draw() };
+        long long int q { draw() };
+        while (q == p)
+            q = draw();
+
+        // e is a prime that divides neither p - 1 nor q - 1, so it always has an inverse
+        const long long int d { *Utility::Math::modInverse(Detail::publicExponent, (p - 1) * (q - 1)) };
+        return KeyPair { Key::Public { p * q, Detail::publicExponent }, Key::Private { p, q, d } };
+    }
+
+    namespace Detail {
+        // Candidates walked from one random start before drawing another
+        constexpr long long int wideWindow { 1 << 16 };
+
+        // Random prime of exactly 'bits' bits (both top bits set) with p - 1 not a multiple of e
+        // From an odd random start, candidates go up 2 by 2 while their residues modulo the small primes and e are updated
+        // incrementally, only those no small prime divides reach Miller-Rabin
+        BigNum::Integer widePrime(size_t bits) {
+            const size_t rounds { bits >= 1024 ? 5u : 8u };
+            std::array<long long int, Utility::Math::smallPrimes.size() + 1> moduli {};
+            std::copy(Utility::Math::smallPrimes.begin(), Utility::Math::smallPrimes.end(), moduli.begin());
+            moduli.back() = publicExponent;
+
+            while (true) {
+                BigNum::Integer start { BigNum::random(bits) };
+                start.setBit(bits - 1);
+                start.setBit(bits - 2);
+                start.setBit(0);
+
+                std::array<long long int, Utility::Math::smallPrimes.size() + 1> residues {};
+                for (size_t i { 0 }; i < moduli.size(); ++i)
+                    residues[i] = static_cast<long long int>(BigNum::remainder(start, static_cast<std::uint64_t>(moduli[i])));
+
+                for (long long int offset { 0 }; offset < wideWindow; offset += 2) {
+                    bool isCandidate { residues.back() != 1 };
+                    for (size_t i { 0 }; i + 1 < moduli.size() && isCandidate; ++i)
+                        isCandidate = residues[i] != 0;
+
+                    if (isCandidate) {
+                        BigNum::Integer candidate { start + BigNum::Integer { static_cast<unsigned long long int>(offset) } };
+                        if (candidate.bitLength() != bits)
+                            break;
+                        if (BigNum::millerRabin(candidate, rounds))
+                            return candidate;
+                    }
+
+                    for (size_t i { 0 }; i < moduli.size(); ++i)
+                        residues[i] = (residues[i] + 2) % moduli[i];
+                }
+            }
+        }
+    }
+
+    std::optional<WideKeyPair> randomWideKeyPair(size_t modulusBits) {
+        if (modulusBits % 2 != 0 || modulusBits < minWideModulusBits || modulusBits > maxWideModulusBits)
+            return std::nullopt;
+
+        // Two primes with both top bits set give a product of exactly 'modulusBits' bits
+        const BigNum::Integer p { Detail::widePrime(modulusBits / 2) };
+        BigNum::Integer q { Detail::widePrime(modulusBits / 2) };
+        while (q == p)
+            q = Detail::widePrime(modulusBits / 2);
+
+        const BigNum::Integer one { 1 };
+        const BigNum::Integer e { static_cast<unsigned long long int>(Detail::publicExponent) };
+        // e is a prime that divides neither p - 1 nor q - 1, so it always has an inverse
+        const BigNum::Integer d { *BigNum::modInverse(e, (p - one) * (q - one)) };
+        return WideKeyPair { Key::Wide::Public { p * q, e }, Key::Wide::Private { p, q, d } };
+    }
+
+    std::optional<Key::Wide::CRT> crt(const Key::Wide::Private& privateKey) {
+        const BigNum::Integer& p { privateKey.p };
+        const BigNum::Integer& q { privateKey.q };
+        const BigNum::Integer one { 1 };
+        if (p <= one || q <= one)
+            return std::nullopt;
+
+        std::optional<BigNum::Integer> qInv { BigNum::modInverse(q % p, p) };
+        if (!qInv)
+            return std::nullopt;
+
+        return Key::Wide::CRT { p, q, privateKey.d % (p - one), privateKey.d % (q - one), std::move(*qInv) };
+    }
+
+    std::optional<KeyPair> fromSeed(const std::string& seed, std::uint64_t index, size_t primeBits) {
+        if (primeBits < minPrimeBits || primeBits > maxPrimeBits)
+            return std::nullopt;
+
+        Detail::SeededStream stream { seed, index };
+
+        const long long int p { Detail::seededPrime(stream, primeBits) };
+        long long int q { Detail::seededPrime(stream, primeBits) };
+        while (q == p)
+            q = Detail::seededPrime(stream, primeBits);
+
+        // e is a prime that divides neither p - 1 nor q - 1, so it always has an inverse
+        const long long int d { *Utility::Math::modInverse(Detail::publicExponent, (p - 1) * (q - 1)) };
+        return KeyPair { Key::Public { p * q, Detail::publicExponent }, Key::Private { p, q, d } };
+    }
+
+    std::vector<KeyPair> keySetFromSeed(const std::string& seed, std::uint64_t first, size_t count, size_t primeBits) {
+        if (primeBits < minPrimeBits || primeBits > maxPrimeBits)
+            return {};
+
+        std::vector<KeyPair> keys(count);
+
+        Concurrency::defaultPool().parallelFor(count, [&](size_t i) {
+            keys[i] = *fromSeed(seed, first + i, primeBits);
+        }, Concurrency::Priority::Bulk);
+
+        return keys;
+    }
+
+    std::string keySetDigest(const std::vector<KeyPair>& keys) {
+        Hash::SHA256 hash {};
+        for (const KeyPair& pair : keys) {
+            const std::string line { std::to_string(pair.privateKey.p) + ' ' + std::to_string(pair.privateKey.q) + ' ' + std::to_string(pair.privateKey.d) + '\n' };
+            hash.update(reinterpret_cast<const unsigned char*>(line.data()), line.size());
+        }
+        return Utility::Convert::toHex(hash.finish());
+    }
+
+    std::optional<std::vector<KeyPair>> cachedKeySet(const std::string& filename, const std::string& seed, size_t count, size_t primeBits) {
+        if (primeBits < minPrimeBits || primeBits > maxPrimeBits)
+            return std::nullopt;
+
+        if (std::optional<std::vector<KeyPair>> keys { Detail::loadKeySet(filename, seed, count, primeBits) })
+            return keys;
+
+        std::vector<KeyPair> keys { keySetFromSeed(seed, 0, count, primeBits) };
+        if (!Detail::saveKeySet(filename, seed, primeBits, keys))
+            return std::nullopt;
+        return keys;
+    }
+}
@@ -0,0 +1,392 @@
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <numeric>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+#include "rsa/bignum.hpp"
+#include "rsa/convert.hpp"
+#include "rsa/hash.hpp"
+#include "rsa/key.hpp"
+#include "rsa/tuning.hpp"
+
+namespace Hash {
+    namespace Detail {
+        constexpr std::array<std::uint32_t, 64> sha256RoundConstants {
+            0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+            0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+            0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+            0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+            0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+            0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+            0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+            0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+        };
+
+        constexpr std::array<std::uint32_t, 8> sha256InitialState {
+            0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19,
+        };
+
+        constexpr std::uint32_t rotateRight(std::uint32_t x, int bits) {
+            return (x >> bits) | (x << (32 - bits));
+        }
+
+        constexpr std::uint32_t loadBigEndian(const unsigned char* bytes) {
+            return (static_cast<std::uint32_t>(bytes[0]) << 24) | (static_cast<std::uint32_t>(bytes[1]) << 16) | (static_cast<std::uint32_t>(bytes[2]) << 8) | bytes[3];
+        }
+
+        // Portable SHA-256 compression function, runs the 64 rounds on every 64 byte block in 'blocks'
+        void sha256CompressScalar(std::array<std::uint32_t, 8>& state, const unsigned char* blocks, size_t count) {
+            for (; count > 0; --count, blocks += 64) {
+                std::array<std::uint32_t, 64> w {};
+                for (int t { 0 }; t < 16; ++t)
+                    w[t] = loadBigEndian(blocks + 4 * t);
+                for (int t { 16 }; t < 64; ++t) {
+                    const std::uint32_t s0 { rotateRight(w[t - 15], 7) ^ rotateRight(w[t - 15], 18) ^ (w[t - 15] >> 3) };
+                    const std::uint32_t s1 { rotateRight(w[t - 2], 17) ^ rotateRight(w[t - 2], 19) ^ (w[t - 2] >> 10) };
+                    w[t] = w[t - 16] + s0 + w[t - 7] + s1;
+                }
+
+                std::uint32_t a { state[0] }, b { state[1] }, c { state[2] }, d { state[3] };
+                std::uint32_t e { state[4] }, f { state[5] }, g { state[6] }, h { state[7] };
+
+                for (int t { 0 }; t < 64; ++t) {
+                    const std::uint32_t t1 { h + (rotateRight(e, 6) ^ rotateRight(e, 11) ^ rotateRight(e, 25)) + ((e & f) ^ (~e & g)) + sha256RoundConstants[t] + w[t] };
+                    const std::uint32_t t2 { (rotateRight(a, 2) ^ rotateRight(a, 13) ^ rotateRight(a, 22)) + ((a & b) ^ (a & c) ^ (b & c)) };
+                    h = g; g = f; f = e; e = d + t1;
+                    d = c; c = b; b = a; a = t1 + t2;
+                }
+
+                state[0] += a; state[1] += b; state[2] += c; state[3] += d;
+                state[4] += e; state[5] += f; state[6] += g; state[7] += h;
+            }
+        }
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+        // SHA-256 compression function using the x86 SHA extensions (SHA-NI), each sha256rnds2 instruction runs two rounds
+        // The state is kept in the ABEF/CDGH register layout the instructions expect
+        __attribute__((target("sha,sse4.1,ssse3")))
+        void sha256CompressSHANI(std::array<std::uint32_t, 8>& state, const unsigned char* blocks, size_t count) {
+            const __m128i byteSwap { _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL) };
+
+            __m128i tmp { _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(&state[0])), 0xB1) }; // CDAB
+            __m128i state1 { _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(&state[4])), 0x1B) }; // EFGH
+            __m128i state0 { _mm_alignr_epi8(tmp, state1, 8) }; // ABEF
+            state1 = _mm_blend_epi16(state1, tmp, 0xF0); // CDGH
+
+            for (; count > 0; --count, blocks += 64) {
+                const __m128i savedState0 { state0 };
+                const __m128i savedState1 { state1 };
+
+                __m128i w[16];
+                for (int i { 0 }; i < 4; ++i)
+                    w[i] = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(blocks + 16 * i)), byteSwap);
+                for (int i { 4 }; i < 16; ++i)
+                    w[i] = _mm_sha256msg2_epu32(_mm_add_epi32(_mm_sha256msg1_epu32(w[i - 4], w[i - 3]), _mm_alignr_epi8(w[i - 1], w[i - 2], 4)), w[i - 1]);
+
+                for (int i { 0 }; i < 16; ++i) {
+                    __m128i message { _mm_add_epi32(w[i], _mm_loadu_si128(reinterpret_cast<const __m128i*>(&sha256RoundConstants[4 * i]))) };
+                    state1 = _mm_sha256rnds2_epu32(state1, state0, message);
+                    message = _mm_shuffle_epi32(message, 0x0E);
+                    state0 = _mm_sha256rnds2_epu32(state0, state1, message);
+                }
+
+                state0 = _mm_add_epi32(state0, savedState0);
+                state1 = _mm_add_epi32(state1, savedState1);
+            }
+
+            tmp = _mm_shuffle_epi32(state0, 0x1B); // FEBA
+            state1 = _mm_shuffle_epi32(state1, 0xB1); // DCHG
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(&state[0]), _mm_blend_epi16(tmp, state1, 0xF0)); // DCBA
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(&state[4]), _mm_alignr_epi8(state1, tmp, 8)); // HGFE
+        }
+#endif
+
+        // Tells if the processor has the SHA extensions
+        bool hasSHANI() {
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+            static const bool supported { __builtin_cpu_supports("sha") != 0 };
+            return supported;
+#else
+            return false;
+#endif
+        }
+
+        // Runs the compression function on 'count' blocks, picking the SHA-NI version when the processor supports it
+        void sha256Compress(std::array<std::uint32_t, 8>& state, const unsigned char* blocks, size_t count) {
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+            if (hasSHANI()) {
+                sha256CompressSHANI(state, blocks, count);
+                return;
+            }
+#endif
+            sha256CompressScalar(state, blocks, count);
+        }
+    }
+
+    SHA256::SHA256()
+        : state { Detail::sha256InitialState } {
+    }
+
+    void SHA256::update(const unsigned char* data, size_t length) {
+        if (length == 0)
+            return;
+        totalLength += length;
+
+        if (bufferLength > 0) {
+            const size_t taken { std::min(length, blockSize - bufferLength) };
+            std::memcpy(buffer.data() + bufferLength, data, taken);
+            bufferLength += taken;
+            data += taken;
+            length -= taken;
+
+            if (bufferLength < blockSize)
+                return;
+
+            Detail::sha256Compress(state, buffer.data(), 1);
+            bufferLength = 0;
+        }
+
+        // Whole blocks are compressed straight from the input, without copying them
+        const size_t blocks { length / blockSize };
+        Detail::sha256Compress(state, data, blocks);
+        data += blocks * blockSize;
+        length -= blocks * blockSize;
+
+        std::memcpy(buffer.data(), data, length);
+        bufferLength = length;
+    }
+
+    void SHA256::update(const Utility::Bytes& data) {
+        update(data.data(), data.size());
+    }
+
+    Utility::Bytes SHA256::finish() {
+        const unsigned long long int bitLength { static_cast<unsigned long long int>(totalLength) * 8 };
+
+        const unsigned char marker { 0x80 };
+        update(&marker, 1);
+
+        const std::array<unsigned char, blockSize> zeros {};
+        update(zeros.data(), (bufferLength <= 56 ? 56 : 120) - bufferLength);
+
+        std::array<unsigned char, 8> lengthBytes {};
+        for (int i { 0 }; i < 8; ++i)
+            lengthBytes[7 - i] = static_cast<unsigned char>(bitLength >> (8 * i));
+        update(lengthBytes.data(), lengthBytes.size());
+
+        Utility::Bytes digest(digestSize);
+        for (size_t i { 0 }; i < state.size(); ++i)
+            for (int j { 0 }; j < 4; ++j)
+                digest[4 * i + j] = static_cast<unsigned char>(state[i] >> (24 - 8 * j));
+        return digest;
+    }
+
+    Utility::Bytes sha256(const Utility::Bytes& message) {
+        SHA256 hash {};
+        hash.update(message);
+        return hash.finish();
+    }
+
+    namespace Detail {
+        // Multi-buffer SHA-256: hashes 'Lanes' independent messages at once, word 'i' of every lane sits next to the others
+        // so each round becomes a handful of vector instructions working on all lanes together.
+        // Lanes whose message has already ended ('blockCounts[lane] <= block') keep their state untouched.
+        template <size_t Lanes>
+        __attribute__((always_inline)) inline void sha256CompressLanes(std::uint32_t (&state)[8][Lanes], const unsigned char* const (&blocks)[Lanes], const bool (&isActive)[Lanes]) {
+            std::uint32_t w[64][Lanes];
+
+            for (int t { 0 }; t < 16; ++t)
+                for (size_t lane { 0 }; lane < Lanes; ++lane)
+                    w[t][lane] = loadBigEndian(blocks[lane] + 4 * t);
+
+            for (int t { 16 }; t < 64; ++t)
+                for (size_t lane { 0 }; lane < Lanes; ++lane) {
+                    const std::uint32_t s0 { rotateRight(w[t - 15][lane], 7) ^ rotateRight(w[t - 15][lane], 18) ^ (w[t - 15][lane] >> 3) };
+                    const std::uint32_t s1 { rotateRight(w[t - 2][lane], 17) ^ rotateRight(w[t - 2][lane], 19) ^ (w[t - 2][lane] >> 10) };
+                    w[t][lane] = w[t - 16][lane] + s0 + w[t - 7][lane] + s1;
+                }
+
+            std::uint32_t a[Lanes], b[Lanes], c[Lanes], d[Lanes], e[Lanes], f[Lanes], g[Lanes], h[Lanes];
+            for (size_t lane { 0 }; lane < Lanes; ++lane) {
+                a[lane] = state[0][lane]; b[lane] = state[1][lane]; c[lane] = state[2][lane]; d[lane] = state[3][lane];
+                e[lane] = state[4][lane]; f[lane] = state[5][lane]; g[lane] = state[6][lane]; h[lane] = state[7][lane];
+            }
+
+            for (int t { 0 }; t < 64; ++t)
+                for (size_t lane { 0 }; lane < Lanes; ++lane) {
+                    const std::uint32_t t1 { h[lane] + (rotateRight(e[lane], 6) ^ rotateRight(e[lane], 11) ^ rotateRight(e[lane], 25)) + ((e[lane] & f[lane]) ^ (~e[lane] & g[lane])) + sha256RoundConstants[t] + w[t][lane] };
+                    const std::uint32_t t2 { (rotateRight(a[lane], 2) ^ rotateRight(a[lane], 13) ^ rotateRight(a[lane], 22)) + ((a[lane] & b[lane]) ^ (a[lane] & c[lane]) ^ (b[lane] & c[lane])) };
+                    h[lane] = g[lane]; g[lane] = f[lane]; f[lane] = e[lane]; e[lane] = d[lane] + t1;
+                    d[lane] = c[lane]; c[lane] = b[lane]; b[lane] = a[lane]; a[lane] = t1 + t2;
+                }
+
+            for (size_t lane { 0 }; lane < Lanes; ++lane) {
+                const std::uint32_t keep { isActive[lane] ? 1u : 0u };
+                state[0][lane] += a[lane] * keep; state[1][lane] += b[lane] * keep; state[2][lane] += c[lane] * keep; state[3][lane] += d[lane] * keep;
+                state[4][lane] += e[lane] * keep; state[5][lane] += f[lane] * keep; state[6][lane] += g[lane] * keep; state[7][lane] += h[lane] * keep;
+            }
+        }
+
+        // A message prepared for multi-buffer hashing: its whole blocks are read in place, the last one or two blocks (with the
+        // 0x80 marker and the length) are built in 'tail'
+        struct PaddedMessage {
+            const unsigned char* data {};
+            size_t wholeBlocks {};
+            std::array<unsigned char, 128> tail {};
+            size_t blockCount {};
+
+            explicit PaddedMessage(const Utility::Bytes& message)
+                : data { message.data() }, wholeBlocks { message.size() / SHA256::blockSize } {
+                const size_t rest { message.size() % SHA256::blockSize };
+                // An empty message may have no storage at all, memcpy must not be given its null data()
+                if (rest > 0)
+                    std::memcpy(tail.data(), message.data() + wholeBlocks * SHA256::blockSize, rest);
+                tail[rest] = 0x80;
+
+                const size_t tailBlocks { rest < 56 ? 1u : 2u };
+                const unsigned long long int bitLength { static_cast<unsigned long long int>(message.size()) * 8 };
+                for (int i { 0 }; i < 8; ++i)
+                    tail[tailBlocks * SHA256::blockSize - 1 - i] = static_cast<unsigned char>(bitLength >> (8 * i));
+
+                blockCount = wholeBlocks + tailBlocks;
+            }
+
+            const unsigned char* block(size_t i) const {
+                return i < wholeBlocks ? data + i * SHA256::blockSize : tail.data() + (i - wholeBlocks) * SHA256::blockSize;
+            }
+        };
+
+        // Hashes up to 'Lanes' messages together, the group runs for as many blocks as its longest message
+        template <size_t Lanes>
+        __attribute__((always_inline)) inline void sha256Group(const std::vector<PaddedMessage>& messages, const size_t* indices, size_t count, std::vector<Utility::Bytes>& digests) {
+            static constexpr std::array<unsigned char, SHA256::blockSize> idleBlock {};
+
+            std::uint32_t state[8][Lanes];
+            for (int i { 0 }; i < 8; ++i)
+                for (size_t lane { 0 }; lane < Lanes; ++lane)
+                    state[i][lane] = sha256InitialState[i];
+
+            size_t longest { 0 };
+            for (size_t lane { 0 }; lane < count; ++lane)
+                longest = std::max(longest, messages[indices[lane]].blockCount);
+
+            for (size_t block { 0 }; block < longest; ++block) {
+                const unsigned char* blocks[Lanes];
+                bool isActive[Lanes];
+                for (size_t lane { 0 }; lane < Lanes; ++lane) {
+                    isActive[lane] = lane < count && block < messages[indices[lane]].blockCount;
+                    blocks[lane] = isActive[lane] ? messages[indices[lane]].block(block) : idleBlock.data();
+                }
+                sha256CompressLanes<Lanes>(state, blocks, isActive);
+            }
+
+            for (size_t lane { 0 }; lane < count; ++lane) {
+                Utility::Bytes& digest { digests[indices[lane]] };
+                digest.resize(SHA256::digestSize);
+                for (int i { 0 }; i < 8; ++i)
+                    for (int j { 0 }; j < 4; ++j)
+                        digest[4 * i + j] = static_cast<unsigned char>(state[i][lane] >> (24 - 8 * j));
+            }
+        }
+
+        // One entry point per instruction set, the compiler vectorizes the lane loops with the widest registers available
+        void sha256Group4(const std::vector<PaddedMessage>& messages, const size_t* indices, size_t count, std::vector<Utility::Bytes>& digests) {
+            sha256Group<4>(messages, indices, count, digests);
+        }
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+        __attribute__((target("avx2")))
+        void sha256Group8(const std::vector<PaddedMessage>& messages, const size_t* indices, size_t count, std::vector<Utility::Bytes>& digests) {
+            sha256Group<8>(messages, indices, count, digests);
+        }
+
+        __attribute__((target("avx512f")))
+        void sha256Group16(const std::vector<PaddedMessage>& messages, const size_t* indices, size_t count, std::vector<Utility::Bytes>& digests) {
+            sha256Group<16>(messages, indices, count, digests);
+        }
+#endif
+    }
+
+    std::vector<Utility::Bytes> sha256Batch(const std::vector<Utility::Bytes>& messages, Tuning::HashBatch hashBatch) {
+        std::vector<Utility::Bytes> digests(messages.size());
+
+        size_t lanes { 4 };
+        void (*hashGroup)(const std::vector<Detail::PaddedMessage>&, const size_t*, size_t, std::vector<Utility::Bytes>&) { Detail::sha256Group4 };
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+        if (__builtin_cpu_supports("avx512f")) {
+            lanes = 16;
+            hashGroup = Detail::sha256Group16;
+        }
+        else if (__builtin_cpu_supports("avx2")) {
+            lanes = 8;
+            hashGroup = Detail::sha256Group8;
+        }
+#endif
+
+        const bool isSerial { hashBatch == Tuning::HashBatch::Auto ? Detail::hasSHANI() : hashBatch == Tuning::HashBatch::Serial };
+        if (messages.size() < lanes || isSerial) {
+            for (size_t i { 0 }; i < messages.size(); ++i)
+                digests[i] = sha256(messages[i]);
+            return digests;
+        }
+
+        std::vector<Detail::PaddedMessage> padded {};
+        padded.reserve(messages.size());
+        for (const Utility::Bytes& message : messages)
+            padded.emplace_back(message);
+
+        // Scheduler: groups messages with a similar number of blocks, so little lane time is spent idle
+        std::vector<size_t> order(messages.size());
+        std::iota(order.begin(), order.end(), 0);
+        std::stable_sort(order.begin(), order.end(), [&padded](size_t a, size_t b) { return padded[a].blockCount < padded[b].blockCount; });
+
+        for (size_t first { 0 }; first < order.size(); first += lanes)
+            hashGroup(padded, order.data() + first, std::min(lanes, order.size() - first), digests);
+
+        return digests;
+    }
+
+    Utility::Bytes fingerprint(const Key::Public& key) {
+        SHA256 hash {};
+        hash.update(Utility::Convert::toBytes(key.n, 8));
+        hash.update(Utility::Convert::toBytes(key.e, 8));
+        return hash.finish();
+    }
+
+    Utility::Bytes fingerprint(const Key::Private& key) {
+        SHA256 hash {};
+        hash.update(Utility::Convert::toBytes(key.p, 8));
+        hash.update(Utility::Convert::toBytes(key.q, 8));
+        hash.update(Utility::Convert::toBytes(key.d, 8));
+        return hash.finish();
+    }
+
+    namespace Detail {
+        void updateWithNumber(SHA256& hash, const BigNum::Integer& x) {
+            const size_t length { x.byteLength() };
+            hash.update(Utility::Convert::toBytes(static_cast<long long int>(length), 4));
+            hash.update(*x.toBytes(length));
+        }
+    }
+
+    Utility::Bytes fingerprint(const Key::Wide::Public& key) {
+        SHA256 hash {};
+        Detail::updateWithNumber(hash, key.n);
+        Detail::updateWithNumber(hash, key.e);
+        return hash.finish();
+    }
+
+    Utility::Bytes fingerprint(const Key::Wide::Private& key) {
+        SHA256 hash {};
+        Detail::updateWithNumber(hash, key.p);
+        Detail::updateWithNumber(hash, key.q);
+        Detail::updateWithNumber(hash, key.d);
+        return hash.finish();
+    }
+}
@@ -0,0 +1,146 @@
+#include <algorithm>
+#include <array>
+#include <iostream>
+#include <optional>
+#include <utility>
+
+#if defined(__unix__)
+#include <fcntl.h>
+#endif
+
+#include "rsa/convert.hpp"
+#include "rsa/generate.hpp"
+#include "rsa/hash.hpp"
+#include "rsa/hybrid.hpp"
+#include "rsa/key.hpp"
+#include "rsa/random.hpp"
+#include "rsa/rsa.hpp"
+
+#include "detail/cipher.hpp"
+
+namespace Hybrid {
+    constexpr std::array<unsigned char, 4> magic { 'R', 'S', 'A', 'H' };
+    constexpr unsigned char version { 1 };
+
+    // KDF2 with SHA-256, derives the ChaCha20 key from the secret number 'z' written as 'k' bytes
+    std::array<unsigned char, Cipher::ChaCha20::keySize> deriveKey(long long int z, size_t k) {
+        Hash::SHA256 hash {};
+        hash.update(Utility::Convert::toBytes(z, k));
+        hash.update(Utility::Bytes { 0, 0, 0, 1 });
+        const Utility::Bytes digest { hash.finish() };
+
+        std::array<unsigned char, Cipher::ChaCha20::keySize> key {};
+        std::copy(digest.begin(), digest.end(), key.begin());
+        return key;
+    }
+
+    std::array<unsigned char, Cipher::ChaCha20::nonceSize> segmentNonce(unsigned long long int segment) {
+        std::array<unsigned char, Cipher::ChaCha20::nonceSize> nonce {};
+        for (int i { 0 }; i < 8; ++i)
+            nonce[11 - i] = static_cast<unsigned char>(segment >> (8 * i));
+        return nonce;
+    }
+
+    // Reads up to 'length' bytes, less only when the stream ends
+    size_t readFully(std::istream& in, unsigned char* data, size_t length) {
+        in.read(reinterpret_cast<char*>(data), static_cast<std::streamsize>(length));
+        return static_cast<size_t>(in.gcount());
+    }
+
+    bool encrypt(const Key::Public& publicKey, std::istream& in, std::ostream& out, size_t segmentSize) {
+        if (publicKey.n < 2 || segmentSize == 0 || segmentSize > maxSegmentSize)
+            return false;
+
+        const size_t k { Utility::Convert::byteLength(publicKey.n) };
+
+        // RSA-KEM: a random number 'z' in [0, n) is encoded with the public key, the symmetric key is derived from 'z'
+        long long int z {};
+        do {
+            Utility::Bytes random(k);
+            Utility::Random::fill(random);
+            random[0] &= static_cast<unsigned char>(0xff >> (8 * k - Utility::Convert::bitLength(publicKey.n)));
+            z = Utility::Convert::toInteger(random).value_or(publicKey.n);
+        } while (z >= publicKey.n);
+
+        const std::array<unsigned char, Cipher::ChaCha20::keySize> key { deriveKey(z, k) };
+
+        Utility::Bytes header { magic.begin(), magic.end() };
+        header.push_back(version);
+        header.push_back(static_cast<unsigned char>(k));
+        const Utility::Bytes encapsulated { Utility::Convert::toBytes(encode(publicKey, z), k) };
+        header.insert(header.end(), encapsulated.begin(), encapsulated.end());
+        const Utility::Bytes segmentSizeBytes { Utility::Convert::toBytes(static_cast<long long int>(segmentSize), 4) };
+        header.insert(header.end(), segmentSizeBytes.begin(), segmentSizeBytes.end());
+        out.write(reinterpret_cast<const char*>(header.data()), static_cast<std::streamsize>(header.size()));
+
+        // One segment is read ahead, so the last one is known before it is sealed
+        Utility::Bytes current(segmentSize);
+        Utility::Bytes next(segmentSize);
+        size_t currentLength { readFully(in, current.data(), segmentSize) };
+
+        for (unsigned long long int segment { 0 };; ++segment) {
+            const size_t nextLength { currentLength == segmentSize ? readFully(in, next.data(), segmentSize) : 0 };
+            const bool isLast { nextLength == 0 };
+
+            const auto nonce { segmentNonce(segment) };
+            const auto tag { Cipher::ChaCha20Poly1305::seal(key.data(), nonce.data(), Utility::Bytes { static_cast<unsigned char>(isLast) }, current.data(), currentLength) };
+            out.write(reinterpret_cast<const char*>(current.data()), static_cast<std::streamsize>(currentLength));
+            out.write(reinterpret_cast<const char*>(tag.data()), static_cast<std::streamsize>(tag.size()));
+
+            if (isLast)
+                return static_cast<bool>(out);
+
+            std::swap(current, next);
+            currentLength = nextLength;
+        }
+    }
+
+    bool decrypt(const Key::Public& publicKey, const Key::Private& privateKey, std::istream& in, std::ostream& out) {
+        const size_t k { Utility::Convert::byteLength(publicKey.n) };
+
+        Utility::Bytes header(magic.size() + 2 + k + 4);
+        if (readFully(in, header.data(), header.size()) != header.size())
+            return false;
+        if (!std::equal(magic.begin(), magic.end(), header.begin()) || header[4] != version || header[5] != k)
+            return false;
+
+        const std::optional<long long int> c { Utility::Convert::toInteger(Utility::Bytes(header.begin() + 6, header.begin() + 6 + static_cast<std::ptrdiff_t>(k))) };
+        if (!c || *c >= publicKey.n)
+            return false;
+
+        const std::optional<Key::CRT> crtKey { Generate::crt(privateKey) };
+        if (!crtKey)
+            return false;
+
+        const std::array<unsigned char, Cipher::ChaCha20::keySize> key { deriveKey(decode(*crtKey, *c), k) };
+        const size_t segmentSize { static_cast<size_t>(*Utility::Convert::toInteger(Utility::Bytes(header.end() - 4, header.end()))) };
+        if (segmentSize == 0 || segmentSize > maxSegmentSize)
+            return false;
+
+        const size_t recordSize { segmentSize + Cipher::ChaCha20Poly1305::tagSize };
+        Utility::Bytes current(recordSize);
+        Utility::Bytes next(recordSize);
+        size_t currentLength { readFully(in, current.data(), recordSize) };
+
+        for (unsigned long long int segment { 0 };; ++segment) {
+            if (currentLength < Cipher::ChaCha20Poly1305::tagSize)
+                return false;
+
+            const size_t nextLength { currentLength == recordSize ? readFully(in, next.data(), recordSize) : 0 };
+            const bool isLast { nextLength == 0 };
+            const size_t length { currentLength - Cipher::ChaCha20Poly1305::tagSize };
+
+            const auto nonce { segmentNonce(segment) };
+            if (!Cipher::ChaCha20Poly1305::open(key.data(), nonce.data(), Utility::Bytes { static_cast<unsigned char>(isLast) }, current.data(), length, current.data() + length))
+                return false;
+            if (!out.write(reinterpret_cast<const char*>(current.data()), static_cast<std::streamsize>(length)))
+                return false;
+
+            if (isLast)
+                return true;
+
+            std::swap(current, next);
+            currentLength = nextLength;
+        }
+    }
+}
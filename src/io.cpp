@@ -0,0 +1,404 @@
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#if defined(__unix__)
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#if defined(__linux__)
+#include <linux/io_uring.h>
+#include <sys/syscall.h>
+#endif
+
+#include "detail/io.hpp"
+
+#if defined(__linux__)
+namespace IO {
+    // io_uring through the raw system calls, one submission and one completion ring shared with the kernel
+    class UringBackend final : public Backend {
+    public:
+        // Nothing is returned when the kernel doesn't support io_uring or doesn't allow it (seccomp, containers)
+        static std::unique_ptr<UringBackend> create(unsigned int queueDepth) {
+            std::unique_ptr<UringBackend> backend { new UringBackend {} };
+
+            io_uring_params parameters {};
+            backend->ring = static_cast<int>(::syscall(__NR_io_uring_setup, queueDepth, &parameters));
+            if (backend->ring < 0)
+                return nullptr;
+
+            backend->submissionRingSize = parameters.sq_off.array + parameters.sq_entries * sizeof(unsigned int);
+            backend->completionRingSize = parameters.cq_off.cqes + parameters.cq_entries * sizeof(io_uring_cqe);
+            backend->entriesSize = parameters.sq_entries * sizeof(io_uring_sqe);
+
+            backend->submissionRing = ::mmap(nullptr, backend->submissionRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, backend->ring, IORING_OFF_SQ_RING);
+            backend->completionRing = ::mmap(nullptr, backend->completionRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, backend->ring, IORING_OFF_CQ_RING);
+            void* const entries { ::mmap(nullptr, backend->entriesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, backend->ring, IORING_OFF_SQES) };
+            if (backend->submissionRing == MAP_FAILED || backend->completionRing == MAP_FAILED || entries == MAP_FAILED)
+                return nullptr;
+            backend->entries = static_cast<io_uring_sqe*>(entries);
+
+            unsigned char* const submission { static_cast<unsigned char*>(backend->submissionRing) };
+            backend->submissionTail = reinterpret_cast<unsigned int*>(submission + parameters.sq_off.tail);
+            backend->submissionMask = *reinterpret_cast<unsigned int*>(submission + parameters.sq_off.ring_mask);
+            backend->submissionArray = reinterpret_cast<unsigned int*>(submission + parameters.sq_off.array);
+
+            unsigned char* const completion { static_cast<unsigned char*>(backend->completionRing) };
+            backend->completionHead = reinterpret_cast<unsigned int*>(completion + parameters.cq_off.head);
+            backend->completionTail = reinterpret_cast<unsigned int*>(completion + parameters.cq_off.tail);
+            backend->completionMask = *reinterpret_cast<unsigned int*>(completion + parameters.cq_off.ring_mask);
+            backend->completions = reinterpret_cast<io_uring_cqe*>(completion + parameters.cq_off.cqes);
+
+            return backend;
+        }
+
+        ~UringBackend() override {
+            if (entries != nullptr)
+                ::munmap(entries, entriesSize);
+            if (completionRing != nullptr && completionRing != MAP_FAILED)
+                ::munmap(completionRing, completionRingSize);
+            if (submissionRing != nullptr && submissionRing != MAP_FAILED)
+                ::munmap(submissionRing, submissionRingSize);
+            if (ring >= 0)
+                ::close(ring);
+        }
+
+        // The caller keeps at most 'queueDepth' requests in flight, so the rings never fill up
+        // Once io_uring_enter fails for a reason other than a busy kernel the ring isn't used anymore: the requests still in
+        // flight and every later one complete with -EIO, so the caller sees the failure instead of waiting forever
+        void submit(const Request& request) override {
+            std::lock_guard lock { submitMutex };
+            if (isBroken) {
+                failed.push_back(Completion { request.tag, -EIO });
+                return;
+            }
+
+            const unsigned int tail { *submissionTail };
+            const unsigned int index { tail & submissionMask };
+
+            io_uring_sqe& entry { entries[index] };
+            std::memset(&entry, 0, sizeof(entry));
+            entry.opcode = request.isWrite ? IORING_OP_WRITE : IORING_OP_READ;
+            entry.fd = request.descriptor;
+            entry.addr = reinterpret_cast<unsigned long long int>(request.buffer);
+            entry.len = static_cast<unsigned int>(request.length);
+            entry.off = request.offset;
+            entry.user_data = request.tag;
+
+            submissionArray[index] = index;
+            __atomic_store_n(submissionTail, tail + 1, __ATOMIC_RELEASE);
+            inFlight.push_back(request.tag);
+
+            long result {};
+            while ((result = ::syscall(__NR_io_uring_enter, ring, 1, 0, 0, nullptr, 0)) != 1) {
+                if (result < 0 && !isTransient(errno)) {
+                    breakRing();
+                    return;
+                }
+                std::this_thread::yield();
+            }
+        }
+
+        Completion wait() override {
+            while (true) {
+                {
+                    std::lock_guard lock { submitMutex };
+                    if (!failed.empty()) {
+                        const Completion completion { failed.front() };
+                        failed.pop_front();
+                        return completion;
+                    }
+                }
+
+                const unsigned int head { *completionHead };
+                if (head != __atomic_load_n(completionTail, __ATOMIC_ACQUIRE)) {
+                    const io_uring_cqe& entry { completions[head & completionMask] };
+                    const Completion completion { entry.user_data, entry.res };
+                    __atomic_store_n(completionHead, head + 1, __ATOMIC_RELEASE);
+
+                    // A request the ring broke under was already reported as failed
+                    std::lock_guard lock { submitMutex };
+                    const auto known { std::find(inFlight.begin(), inFlight.end(), completion.tag) };
+                    if (known == inFlight.end())
+                        continue;
+                    inFlight.erase(known);
+                    return completion;
+                }
+
+                if (::syscall(__NR_io_uring_enter, ring, 0, 1, IORING_ENTER_GETEVENTS, nullptr, 0) < 0 && !isTransient(errno)) {
+                    std::lock_guard lock { submitMutex };
+                    breakRing();
+                }
+            }
+        }
+
+        const char* name() const override { return "io_uring"; }
+
+    private:
+        UringBackend() = default;
+
+        // The kernel is busy or the call was interrupted, the same call can be made again
+        static bool isTransient(int error) { return error == EINTR || error == EAGAIN || error == EBUSY; }
+
+        // Called with 'submitMutex' held
+        void breakRing() {
+            if (isBroken)
+                return;
+            isBroken = true;
+            for (const unsigned long long int tag : inFlight)
+                failed.push_back(Completion { tag, -EIO });
+            inFlight.clear();
+        }
+
+        int ring { -1 };
+        std::mutex submitMutex {};
+        bool isBroken { false };
+        std::vector<unsigned long long int> inFlight {};
+        std::deque<Completion> failed {};
+
+        void* submissionRing { nullptr };
+        size_t submissionRingSize {};
+        unsigned int* submissionTail {};
+        unsigned int submissionMask {};
+        unsigned int* submissionArray {};
+
+        void* completionRing { nullptr };
+        size_t completionRingSize {};
+        unsigned int* completionHead {};
+        unsigned int* completionTail {};
+        unsigned int completionMask {};
+        io_uring_cqe* completions {};
+
+        io_uring_sqe* entries { nullptr };
+        size_t entriesSize {};
+    };
+
+    // Fallback when io_uring isn't available: 'threadCount' threads run blocking pread/pwrite calls
+    class ThreadPoolBackend final : public Backend {
+    public:
+        explicit ThreadPoolBackend(size_t threadCount) {
+            for (size_t i { 0 }; i < std::max<size_t>(1, threadCount); ++i)
+                threads.emplace_back([this] { run(); });
+        }
+
+        ~ThreadPoolBackend() override {
+            {
+                std::lock_guard lock { mutex };
+                isStopping = true;
+            }
+            requestAvailable.notify_all();
+            for (std::thread& thread : threads)
+                thread.join();
+        }
+
+        void submit(const Request& request) override {
+            {
+                std::lock_guard lock { mutex };
+                requests.push_back(request);
+            }
+            requestAvailable.notify_one();
+        }
+
+        Completion wait() override {
+            std::unique_lock lock { mutex };
+            completionAvailable.wait(lock, [this] { return !completions.empty(); });
+            const Completion completion { completions.front() };
+            completions.pop_front();
+            return completion;
+        }
+
+        const char* name() const override { return "pread/pwrite threads"; }
+
+    private:
+        void run() {
+            while (true) {
+                Request request {};
+                {
+                    std::unique_lock lock { mutex };
+                    requestAvailable.wait(lock, [this] { return isStopping || !requests.empty(); });
+                    if (requests.empty())
+                        return;
+                    request = requests.front();
+                    requests.pop_front();
+                }
+
+                const ssize_t result { request.isWrite ? ::pwrite(request.descriptor, request.buffer, request.length, static_cast<off_t>(request.offset))
+                                                       : ::pread(request.descriptor, request.buffer, request.length, static_cast<off_t>(request.offset)) };
+                {
+                    std::lock_guard lock { mutex };
+                    completions.push_back(Completion { request.tag, result < 0 ? -static_cast<long long int>(errno) : static_cast<long long int>(result) });
+                }
+                completionAvailable.notify_one();
+            }
+        }
+
+        std::mutex mutex {};
+        std::condition_variable requestAvailable {};
+        std::condition_variable completionAvailable {};
+        std::deque<Request> requests {};
+        std::deque<Completion> completions {};
+        bool isStopping { false };
+        std::vector<std::thread> threads {};
+    };
+
+    std::unique_ptr<Backend> makeBackend(unsigned int queueDepth) {
+        if (std::unique_ptr<UringBackend> uring { UringBackend::create(queueDepth) })
+            return uring;
+        return std::make_unique<ThreadPoolBackend>(queueDepth);
+    }
+
+    bool runPipeline(Backend& backend, const File& input, const File& output, const std::vector<Segment>& segments,
+                     const std::function<bool(size_t, const unsigned char*, unsigned char*)>& transform, size_t queueDepth, size_t threadCount) {
+        // A write goes out in up to three parts: the unaligned head up to the first aligned offset, the aligned middle
+        // (direct when the output allows it) and the unaligned tail. The output is transformed 'outputSkip' bytes into its
+        // buffer, so the middle part also starts on an aligned address
+        constexpr size_t writeParts { 3 };
+
+        struct Slot {
+            AlignedBuffer input {};
+            AlignedBuffer output {};
+            size_t segment {};
+            size_t inputSkip {};    // Bytes read in front of the segment to align the read
+            size_t outputSkip {};
+            std::array<size_t, writeParts> writeLengths {};
+            std::atomic<size_t> pendingWrites { 0 };
+        };
+
+        size_t largestRead { 0 }, largestWrite { 0 };
+        for (const Segment& segment : segments) {
+            largestRead = std::max(largestRead, segment.readLength);
+            largestWrite = std::max(largestWrite, segment.writeLength);
+        }
+
+        queueDepth = std::max<size_t>(1, std::min(queueDepth, segments.size()));
+        std::vector<Slot> slots(queueDepth);
+        for (Slot& slot : slots) {
+            slot.input = AlignedBuffer { alignUp(largestRead) + 2 * directAlignment };
+            slot.output = AlignedBuffer { alignUp(largestWrite) + directAlignment };
+        }
+
+        // Tags carry the slot and what the completion is for: 0 for its read, 1 + i for part i of its write
+        const auto tagOf { [](size_t slot, size_t part) { return static_cast<unsigned long long int>(slot) * (1 + writeParts) + part; } };
+
+        size_t nextSegment { 0 };
+        const auto submitRead { [&](size_t slotIndex) {
+            Slot& slot { slots[slotIndex] };
+            const Segment& segment { segments[nextSegment] };
+            slot.segment = nextSegment++;
+
+            unsigned long long int offset { segment.readOffset };
+            size_t length { segment.readLength };
+            if (input.direct >= 0) {
+                offset = alignDown(static_cast<size_t>(segment.readOffset));
+                length = alignUp(static_cast<size_t>(segment.readOffset - offset) + segment.readLength);
+            }
+            slot.inputSkip = static_cast<size_t>(segment.readOffset - offset);
+
+            backend.submit(Request { input.descriptorFor(offset, length), false, slot.input.data(), length, offset, tagOf(slotIndex, 0) });
+        } };
+
+        std::mutex workMutex {};
+        std::condition_variable workAvailable {};
+        std::deque<size_t> readySlots {};
+        bool isDone { false };
+        std::atomic<bool> isValid { true };
+
+        std::vector<std::thread> workers {};
+        for (size_t i { 0 }; i < std::max<size_t>(1, threadCount); ++i)
+            workers.emplace_back([&] {
+                while (true) {
+                    size_t slotIndex {};
+                    {
+                        std::unique_lock lock { workMutex };
+                        workAvailable.wait(lock, [&] { return isDone || !readySlots.empty(); });
+                        if (readySlots.empty())
+                            return;
+                        slotIndex = readySlots.front();
+                        readySlots.pop_front();
+                    }
+
+                    Slot& slot { slots[slotIndex] };
+                    const Segment& segment { segments[slot.segment] };
+                    const bool isDirect { output.direct >= 0 };
+                    slot.outputSkip = isDirect ? static_cast<size_t>(segment.writeOffset % directAlignment) : 0;
+                    if (!transform(slot.segment, slot.input.data() + slot.inputSkip, slot.output.data() + slot.outputSkip))
+                        isValid = false;
+
+                    // Direct writes must be whole aligned blocks, the edges of the segment go through the page cache
+                    const unsigned long long int end { segment.writeOffset + segment.writeLength };
+                    const unsigned long long int middle { isDirect ? std::min<unsigned long long int>(alignUp(static_cast<size_t>(segment.writeOffset)), end) : end };
+                    const unsigned long long int tail { isDirect ? std::max<unsigned long long int>(middle, alignDown(static_cast<size_t>(end))) : end };
+                    const std::array<unsigned long long int, writeParts + 1> bounds { segment.writeOffset, middle, tail, end };
+
+                    size_t partCount { 0 };
+                    for (size_t part { 0 }; part < writeParts; ++part) {
+                        slot.writeLengths[part] = static_cast<size_t>(bounds[part + 1] - bounds[part]);
+                        partCount += slot.writeLengths[part] > 0 ? 1 : 0;
+                    }
+                    slot.pendingWrites.store(partCount, std::memory_order_release);
+
+                    for (size_t part { 0 }; part < writeParts; ++part)
+                        if (slot.writeLengths[part] > 0) {
+                            unsigned char* const buffer { slot.output.data() + slot.outputSkip + (bounds[part] - segment.writeOffset) };
+                            backend.submit(Request { output.descriptorFor(bounds[part], slot.writeLengths[part]), true, buffer, slot.writeLengths[part], bounds[part], tagOf(slotIndex, 1 + part) });
+                        }
+                }
+            });
+
+        size_t inFlight { 0 };
+        for (size_t slot { 0 }; slot < slots.size(); ++slot, ++inFlight)
+            submitRead(slot);
+
+        while (inFlight > 0) {
+            const Completion completion { backend.wait() };
+            const size_t slotIndex { static_cast<size_t>(completion.tag / (1 + writeParts)) };
+            const size_t part { static_cast<size_t>(completion.tag % (1 + writeParts)) };
+            Slot& slot { slots[slotIndex] };
+            const Segment& segment { segments[slot.segment] };
+
+            if (part == 0) {
+                if (completion.result < static_cast<long long int>(slots[slotIndex].inputSkip + segment.readLength))
+                    isValid = false;
+                {
+                    std::lock_guard lock { workMutex };
+                    readySlots.push_back(slotIndex);
+                }
+                workAvailable.notify_one();
+                continue;
+            }
+
+            // The segment is done once its last write part completes
+            const bool isLastPart { slot.pendingWrites.fetch_sub(1, std::memory_order_acq_rel) == 1 };
+            if (completion.result != static_cast<long long int>(slot.writeLengths[part - 1]))
+                isValid = false;
+            if (!isLastPart)
+                continue;
+
+            if (nextSegment < segments.size() && isValid)
+                submitRead(slotIndex);
+            else
+                --inFlight;
+        }
+
+        {
+            std::lock_guard lock { workMutex };
+            isDone = true;
+        }
+        workAvailable.notify_all();
+        for (std::thread& worker : workers)
+            worker.join();
+
+        return isValid;
+    }
+}
+#endif
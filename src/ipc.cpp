@@ -0,0 +1,282 @@
+#include <array>
+#include <atomic>
+#include <climits>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#if defined(__unix__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
+
+#include "rsa/concurrency.hpp"
+#include "rsa/ipc.hpp"
+#include "rsa/key.hpp"
+#include "rsa/keystore.hpp"
+#include "rsa/rsa.hpp"
+
+#if defined(__linux__)
+namespace IPC {
+    namespace Detail {
+        static_assert(sizeof(std::atomic<std::uint32_t>) == sizeof(std::uint32_t) && std::atomic<std::uint32_t>::is_always_lock_free,
+                      "Error: futex words must be plain 32-bit atomics");
+
+        // Shared futexes (no FUTEX_PRIVATE_FLAG, which std::atomic::wait uses), the waiter and the waker are different processes
+        void futexWait(std::atomic<std::uint32_t>& word, std::uint32_t expected) {
+            ::syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&word), FUTEX_WAIT, expected, nullptr, nullptr, 0);
+        }
+
+        void futexWake(std::atomic<std::uint32_t>& word) {
+            ::syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&word), FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+        }
+    }
+
+    // Lives in shared memory, so it only holds plain data and lock-free atomics. The head and tail indices are the futex words
+    template <typename T, std::uint32_t Capacity>
+    struct Ring {
+        static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "Error: the capacity must be a power of two");
+
+        alignas(Concurrency::cacheLineSize) std::atomic<std::uint32_t> head {};    // Next slot to read, moved by the consumer
+        alignas(Concurrency::cacheLineSize) std::atomic<std::uint32_t> tail {};    // Next slot to write, moved by the producer
+        alignas(Concurrency::cacheLineSize) std::atomic<std::uint32_t> isConsumerWaiting {};
+        std::atomic<std::uint32_t> isProducerWaiting {};
+        alignas(Concurrency::cacheLineSize) std::array<T, Capacity> slots {};
+
+        // Producer: the free slot to fill in place, or nullptr if the ring is full. publish() hands it over
+        T* claim() {
+            const std::uint32_t position { tail.load(std::memory_order_relaxed) };
+            if (position - head.load(std::memory_order_acquire) == Capacity)
+                return nullptr;
+            return &slots[position & (Capacity - 1)];
+        }
+
+        void publish() {
+            tail.store(tail.load(std::memory_order_relaxed) + 1, std::memory_order_seq_cst);
+            if (isConsumerWaiting.load(std::memory_order_seq_cst))
+                Detail::futexWake(tail);
+        }
+
+        // Consumer: the oldest published slot, or nullptr if the ring is empty. release() gives it back
+        const T* peek() const {
+            const std::uint32_t position { head.load(std::memory_order_relaxed) };
+            if (tail.load(std::memory_order_acquire) == position)
+                return nullptr;
+            return &slots[position & (Capacity - 1)];
+        }
+
+        void release() {
+            head.store(head.load(std::memory_order_relaxed) + 1, std::memory_order_seq_cst);
+            if (isProducerWaiting.load(std::memory_order_seq_cst))
+                Detail::futexWake(head);
+        }
+
+        // Consumer: sleeps until something is published or 'isClosed' is set, returns false in the second case
+        // The waiting flag is raised before the last check, and the producer reads it after publishing, so no wake-up is lost
+        bool waitForData(const std::atomic<std::uint32_t>& isClosed) {
+            while (true) {
+                const std::uint32_t position { tail.load(std::memory_order_seq_cst) };
+                if (position != head.load(std::memory_order_relaxed))
+                    return true;
+                if (isClosed.load(std::memory_order_seq_cst))
+                    return false;
+
+                isConsumerWaiting.store(1, std::memory_order_seq_cst);
+                if (tail.load(std::memory_order_seq_cst) == position && !isClosed.load(std::memory_order_seq_cst))
+                    Detail::futexWait(tail, position);
+                isConsumerWaiting.store(0, std::memory_order_relaxed);
+            }
+        }
+
+        // Producer: sleeps until a slot is free or 'isClosed' is set, returns false in the second case
+        bool waitForRoom(const std::atomic<std::uint32_t>& isClosed) {
+            while (true) {
+                const std::uint32_t position { head.load(std::memory_order_seq_cst) };
+                if (tail.load(std::memory_order_relaxed) - position != Capacity)
+                    return true;
+                if (isClosed.load(std::memory_order_seq_cst))
+                    return false;
+
+                isProducerWaiting.store(1, std::memory_order_seq_cst);
+                if (head.load(std::memory_order_seq_cst) == position && !isClosed.load(std::memory_order_seq_cst))
+                    Detail::futexWait(head, position);
+                isProducerWaiting.store(0, std::memory_order_relaxed);
+            }
+        }
+
+        // Wakes whoever sleeps on this ring, used when the connection closes
+        void wakeAll() {
+            Detail::futexWake(head);
+            Detail::futexWake(tail);
+        }
+    };
+
+    struct Request {
+        Operation operation {};
+        std::uint32_t tag {};       // Echoed in the response, the client's index of the request
+        long long int value {};
+    };
+
+    struct Response {
+        std::uint32_t tag {};
+        std::uint32_t isValid {};   // 0 if the value can't be processed with this key (c >= n) or the operation is unknown, else 1
+        long long int value {};
+    };
+
+    constexpr std::uint32_t ringCapacity { 256 };
+
+    // The whole shared segment of one connection
+    struct Channel {
+        Ring<Request, ringCapacity> requests {};
+        Ring<Response, ringCapacity> responses {};
+        alignas(Concurrency::cacheLineSize) std::atomic<std::uint32_t> isClosed {};
+    };
+
+    namespace Detail {
+        Channel* map(int descriptor) {
+            void* const mapped { ::mmap(nullptr, sizeof(Channel), PROT_READ | PROT_WRITE, MAP_SHARED, descriptor, 0) };
+            return mapped == MAP_FAILED ? nullptr : static_cast<Channel*>(mapped);
+        }
+
+        void close(Channel& channel) {
+            channel.isClosed.store(1, std::memory_order_seq_cst);
+            channel.requests.wakeAll();
+            channel.responses.wakeAll();
+        }
+    }
+
+    std::optional<Client> Client::create(const std::string& name) {
+        const int descriptor { ::shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, 0600) };
+        if (descriptor < 0)
+            return std::nullopt;
+
+        Channel* const channel { ::ftruncate(descriptor, sizeof(Channel)) == 0 ? Detail::map(descriptor) : nullptr };
+        ::close(descriptor);
+        if (!channel) {
+            ::shm_unlink(name.c_str());
+            return std::nullopt;
+        }
+        return Client { name, new (channel) Channel {} };
+    }
+
+    Client::Client(Client&& other) noexcept
+        : name { std::move(other.name) }, channel { std::exchange(other.channel, nullptr) } {
+    }
+
+    Client& Client::operator=(Client&& other) noexcept {
+        if (this != &other) {
+            release();
+            name = std::move(other.name);
+            channel = std::exchange(other.channel, nullptr);
+        }
+        return *this;
+    }
+
+    Client::~Client() {
+        release();
+    }
+
+    std::optional<std::vector<std::optional<long long int>>> Client::run(Operation operation, const std::vector<long long int>& values) {
+        if (values.size() > 0xffffffff)
+            return std::nullopt;
+
+        std::vector<std::optional<long long int>> results(values.size());
+        std::vector<bool> isAnswered(values.size(), false);
+        size_t sent { 0 }, received { 0 };
+
+        while (received < values.size()) {
+            for (Request* request { nullptr }; sent < values.size() && (request = channel->requests.claim()); ++sent) {
+                request->operation = operation;
+                request->tag = static_cast<std::uint32_t>(sent);
+                request->value = values[sent];
+                channel->requests.publish();
+            }
+
+            if (!channel->responses.waitForData(channel->isClosed))
+                return std::nullopt;
+            // The server writes the responses, a tag for a request that wasn't sent or was already answered means it can't be trusted
+            for (const Response* response { nullptr }; (response = channel->responses.peek()); ++received) {
+                const Response copy { *response };
+                channel->responses.release();
+                if (copy.tag >= sent || isAnswered[copy.tag] || copy.isValid > 1)
+                    return std::nullopt;
+
+                isAnswered[copy.tag] = true;
+                if (copy.isValid)
+                    results[copy.tag] = copy.value;
+            }
+        }
+        return results;
+    }
+
+    std::optional<long long int> Client::encode(long long int m) {
+        const std::optional<std::vector<std::optional<long long int>>> results { run(Operation::Encode, { m }) };
+        return results ? results->front() : std::nullopt;
+    }
+
+    std::optional<long long int> Client::decode(long long int c) {
+        const std::optional<std::vector<std::optional<long long int>>> results { run(Operation::Decode, { c }) };
+        return results ? results->front() : std::nullopt;
+    }
+
+    Client::Client(std::string name, Channel* channel)
+        : name { std::move(name) }, channel { channel } {
+    }
+
+    void Client::release() {
+        if (!channel)
+            return;
+        Detail::close(*channel);
+        ::munmap(channel, sizeof(Channel));
+        ::shm_unlink(name.c_str());
+        channel = nullptr;
+    }
+
+    bool serve(const std::string& name, const KeyStore::Store& store) {
+        const int descriptor { ::shm_open(name.c_str(), O_RDWR, 0) };
+        if (descriptor < 0)
+            return false;
+        struct stat status {};
+        Channel* const channel { ::fstat(descriptor, &status) == 0 && static_cast<size_t>(status.st_size) >= sizeof(Channel) ? Detail::map(descriptor) : nullptr };
+        ::close(descriptor);
+        if (!channel)
+            return false;
+
+        while (channel->requests.waitForData(channel->isClosed))
+            for (const Request* request { nullptr }; (request = channel->requests.peek());) {
+                if (!channel->responses.waitForRoom(channel->isClosed))
+                    break;
+
+                const KeyStore::Store::Reader keys { store.read() };
+                Response* const response { channel->responses.claim() };
+                response->tag = request->tag;
+                const bool isKnown { request->operation == Operation::Encode || request->operation == Operation::Decode };
+                response->isValid = isKnown && request->value >= 0 && request->value < keys->publicKey.n;
+                if (response->isValid)
+                    response->value = request->operation == Operation::Encode ? encode(keys->publicKey, request->value) : decode(keys->crtKey, request->value);
+
+                channel->requests.release();
+                channel->responses.publish();
+            }
+
+        ::munmap(channel, sizeof(Channel));
+        return true;
+    }
+
+    bool serve(const std::string& name, const Key::Public& publicKey, const Key::Private& privateKey) {
+        const std::unique_ptr<KeyStore::Store> store { KeyStore::Store::create(publicKey, privateKey) };
+        return store && serve(name, *store);
+    }
+}
+#endif
@@ -0,0 +1,182 @@
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#if defined(__unix__)
+#include <unistd.h>
+#endif
+
+#include "rsa/concurrency.hpp"
+#include "rsa/file.hpp"
+#include "rsa/generate.hpp"
+#include "rsa/key.hpp"
+#include "rsa/keystore.hpp"
+#include "rsa/rsa.hpp"
+
+namespace KeyStore {
+    namespace Detail {
+        // Every reading thread gets a slot holding the epoch it entered at (0 when it isn't reading). The writer frees an
+        // old key set only when every slot is 0 or newer than the swap. Threads beyond the slot count share a counter
+        // instead, which just delays reclamation while they read
+        constexpr size_t slotCount { 128 };
+
+        struct alignas(Concurrency::cacheLineSize) Slot {
+            std::atomic<unsigned long long int> epoch { 0 };
+            std::atomic<bool> isOwned { false };
+        };
+
+        struct Domain {
+            std::atomic<unsigned long long int> epoch { 1 };
+            std::array<Slot, slotCount> slots {};
+            alignas(Concurrency::cacheLineSize) std::atomic<size_t> overflowReaders { 0 };
+        };
+
+        Domain& domain() {
+            static Domain instance {};
+            return instance;
+        }
+
+        // The calling thread's slot, claimed on its first read and given back when the thread ends
+        struct Registration {
+            Slot* slot {};
+            size_t depth {};    // Nested reads on one thread only publish the outermost one
+
+            Registration() {
+                for (Slot& candidate : domain().slots) {
+                    bool isOwned { false };
+                    if (candidate.isOwned.compare_exchange_strong(isOwned, true)) {
+                        slot = &candidate;
+                        break;
+                    }
+                }
+            }
+
+            ~Registration() {
+                if (slot)
+                    slot->isOwned.store(false, std::memory_order_release);
+            }
+        };
+
+        Registration& registration() {
+            thread_local Registration instance {};
+            return instance;
+        }
+
+        void enter() {
+            Registration& self { registration() };
+            if (self.depth++ > 0)
+                return;
+            if (self.slot)
+                self.slot->epoch.store(domain().epoch.load(std::memory_order_seq_cst), std::memory_order_seq_cst);
+            else
+                domain().overflowReaders.fetch_add(1, std::memory_order_seq_cst);
+        }
+
+        void leave() {
+            Registration& self { registration() };
+            if (--self.depth > 0)
+                return;
+            if (self.slot)
+                self.slot->epoch.store(0, std::memory_order_release);
+            else
+                domain().overflowReaders.fetch_sub(1, std::memory_order_release);
+        }
+
+        // True once no reader can still hold a pointer retired at 'retiredEpoch'
+        bool isQuiescent(unsigned long long int retiredEpoch) {
+            if (domain().overflowReaders.load(std::memory_order_seq_cst) > 0)
+                return false;
+            for (const Slot& slot : domain().slots) {
+                const unsigned long long int epoch { slot.epoch.load(std::memory_order_seq_cst) };
+                if (epoch != 0 && epoch < retiredEpoch)
+                    return false;
+            }
+            return true;
+        }
+    }
+
+    Store::Reader::Reader(const std::atomic<const KeySet*>& current) {
+        Detail::enter();
+        keys = current.load(std::memory_order_seq_cst);
+    }
+
+    Store::Reader::~Reader() {
+        Detail::leave();
+    }
+
+    Store::Store(const KeySet* keys)
+        : current { keys } {
+    }
+
+    std::unique_ptr<Store> Store::create(const Key::Public& publicKey, const Key::Private& privateKey) {
+        const std::optional<Key::CRT> crtKey { Generate::crt(privateKey) };
+        if (!crtKey)
+            return nullptr;
+
+        return std::unique_ptr<Store> { new Store { new KeySet { publicKey, privateKey, *crtKey, 1 } } };
+    }
+
+    Store::~Store() {
+        delete current.load();
+        for (const auto& [keys, epoch] : retired)
+            delete keys;
+    }
+
+    Store::Reader Store::read() const {
+        return Reader { current };
+    }
+
+    std::optional<unsigned long long int> Store::publish(const Key::Public& publicKey, const Key::Private& privateKey) {
+        const std::optional<Key::CRT> crtKey { Generate::crt(privateKey) };
+        if (!crtKey)
+            return std::nullopt;
+
+        std::lock_guard lock { writerMutex };
+        const KeySet* const next { new KeySet { publicKey, privateKey, *crtKey, read()->version + 1 } };
+
+        const KeySet* const previous { current.exchange(next, std::memory_order_seq_cst) };
+        const unsigned long long int retiredEpoch { Detail::domain().epoch.fetch_add(1, std::memory_order_seq_cst) + 1 };
+        {
+            std::lock_guard retiredLock { retiredMutex };
+            retired.emplace_back(previous, retiredEpoch);
+        }
+
+        reclaim();
+        return next->version;
+    }
+
+    bool Store::reload(const std::string& publicKeyFilename, const std::string& privateKeyFilename) {
+        const std::optional<Key::Public> publicKey { Utility::File::loadPublic(publicKeyFilename) };
+        const std::optional<Key::Private> privateKey { Utility::File::loadPrivate(privateKeyFilename) };
+        if (!publicKey || !privateKey || privateKey->p * privateKey->q != publicKey->n)
+            return false;
+
+        return publish(*publicKey, *privateKey).has_value();
+    }
+
+    size_t Store::reclaim() {
+        std::lock_guard lock { retiredMutex };
+        const auto isFree { [](const std::pair<const KeySet*, unsigned long long int>& entry) {
+            if (!Detail::isQuiescent(entry.second))
+                return false;
+            delete entry.first;
+            return true;
+        } };
+        retired.erase(std::remove_if(retired.begin(), retired.end(), isFree), retired.end());
+        return retired.size();
+    }
+
+    long long int Store::encode(long long int m) const {
+        return ::encode(read()->publicKey, m);
+    }
+
+    long long int Store::decode(long long int c) const {
+        return ::decode(read()->crtKey, c);
+    }
+}
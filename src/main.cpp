@@ -0,0 +1,224 @@
+#include <charconv>
+#include <cstring>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "rsa/concurrency.hpp"
+#include "rsa/container.hpp"
+#include "rsa/filter.hpp"
+#include "rsa/rotation.hpp"
+#include "rsa/rsa.hpp"
+#include "rsa/tuning.hpp"
+
+namespace {
+    // A whole decimal number and nothing else, no sign, no spaces
+    template <typename T>
+    std::optional<T> parseNumber(const char* text) {
+        const char* const end { text + std::strlen(text) };
+        T value {};
+        const auto [rest, error] { std::from_chars(text, end, value) };
+        if (error != std::errc {} || rest != end || text == end)
+            return std::nullopt;
+        return value;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    // The library runs with default settings unless it's handed a profile, the command uses the one "rsa autotune" wrote
+    if (const std::optional<Tuning::Profile> profile { Tuning::load(Tuning::profileFilename()) })
+        Tuning::use(*profile);
+
+#if defined(__unix__)
+    // Filter mode: "rsa encrypt" / "rsa decrypt" read stdin and write stdout, using the keys saved in the current directory
+    // "rsa decrypt-file <container> <output> [processes]" decodes a container with forked worker processes
+    // "rsa encrypt-file <input> <container> [threads]" and "rsa decrypt-file-async <container> <output> [threads]" stream
+    // files bigger than the page cache through io_uring (Linux only)
+    // "rsa rotate <new public key> <checkpoint> <old container> <new container> ..." re-encodes containers for a new key,
+    // running it again after a crash resumes from the checkpoint
+    // "rsa autotune [profile]" benchmarks this machine and writes its tuning profile
+    // "rsa keygen <seed> <index>" saves key pair 'index' of 'seed', "rsa keyset <seed> <count> <file>" caches a whole set
+    if (argc > 1) {
+        // The command owns the machine, its workers stay on their CPUs
+        Concurrency::pinDefaultPool();
+
+        const std::string mode { argv[1] };
+        if (mode == "keygen") {
+            if (argc < 4) {
+                std::cerr << "Usage: " << argv[0] << " keygen <seed> <index>\n";
+                return 1;
+            }
+            const std::optional<unsigned long long int> index { parseNumber<unsigned long long int>(argv[3]) };
+            if (!index) {
+                std::cerr << "Usage: " << argv[0] << " keygen <seed> <index>, the index is a whole number\n";
+                return 1;
+            }
+            const std::optional<Generate::KeyPair> pair { Generate::fromSeed(argv[2], *index) };
+            if (!pair) {
+                std::cerr << "Error: couldn't generate the key pair\n";
+                return 1;
+            }
+            if (!Utility::File::saveTo("publickey.txt", pair->publicKey) || !Utility::File::saveTo("privatekey.txt", pair->privateKey)) {
+                std::cerr << "Error: couldn't write publickey.txt and privatekey.txt\n";
+                return 1;
+            }
+            return 0;
+        }
+        if (mode == "keyset") {
+            if (argc < 5) {
+                std::cerr << "Usage: " << argv[0] << " keyset <seed> <count> <file>\n";
+                return 1;
+            }
+            const std::optional<size_t> count { parseNumber<size_t>(argv[3]) };
+            if (!count) {
+                std::cerr << "Usage: " << argv[0] << " keyset <seed> <count> <file>, the count is a whole number\n";
+                return 1;
+            }
+            const std::optional<std::vector<Generate::KeyPair>> keys { Generate::cachedKeySet(argv[4], argv[2], *count) };
+            if (!keys) {
+                std::cerr << "Error: couldn't write " << argv[4] << '\n';
+                return 1;
+            }
+            std::cout << keys->size() << " keys in " << argv[4] << ", sha256: " << Generate::keySetDigest(*keys) << '\n';
+            return 0;
+        }
+        if (mode == "autotune") {
+            const std::string filename { argc > 2 ? argv[2] : Tuning::profileFilename() };
+            if (!Tuning::save(filename, Tuning::autotune(std::cout))) {
+                std::cerr << "Error: couldn't write " << filename << '\n';
+                return 1;
+            }
+            std::cout << "Tuning profile written to " << filename << '\n';
+            return 0;
+        }
+
+        if (mode == "rotate") {
+            if (argc < 6 || (argc - 4) % 2 != 0) {
+                std::cerr << "Usage: " << argv[0] << " rotate <new public key> <checkpoint> <old container> <new container> [<old container> <new container> ...]\n";
+                return 1;
+            }
+
+            const std::optional<Key::Public> publicKey { Utility::File::loadPublic("publickey.txt") };
+            const std::optional<Key::Private> privateKey { Utility::File::loadPrivate("privatekey.txt") };
+            const std::optional<Key::Public> newPublicKey { Utility::File::loadPublic(argv[2]) };
+            if (!publicKey || !privateKey || !newPublicKey) {
+                std::cerr << "Error: couldn't load the keys from publickey.txt/privatekey.txt/" << argv[2] << '\n';
+                return 1;
+            }
+
+            Rotation::Job job {};
+            job.checkpointFilename = argv[3];
+            for (int i { 4 }; i + 1 < argc; i += 2)
+                job.files.emplace_back(argv[i], argv[i + 1]);
+
+            if (!Rotation::reencrypt(*publicKey, *privateKey, *newPublicKey, job)) {
+                std::cerr << "Error: rotate failed, run the same command again to resume\n";
+                return 1;
+            }
+            return 0;
+        }
+
+        const bool isFileMode { mode == "decrypt-file" || mode == "encrypt-file" || mode == "decrypt-file-async" };
+        if (isFileMode && argc < 4) {
+            std::cerr << "Usage: " << argv[0] << " " << mode << (mode == "encrypt-file" ? " <input> <container>" : " <container> <output>")
+                      << (mode == "decrypt-file" ? " [processes]\n" : " [threads]\n");
+            return 1;
+        }
+        const int countArgument { isFileMode ? 4 : 2 };
+        const std::optional<size_t> threadCount { argc > countArgument ? parseNumber<size_t>(argv[countArgument]) : std::thread::hardware_concurrency() };
+        if (!threadCount) {
+            std::cerr << "Usage: " << argv[0] << " " << mode << " ... [" << (mode == "decrypt-file" ? "processes" : "threads") << "], the count is a whole number\n";
+            return 1;
+        }
+
+        const std::optional<Key::Public> publicKey { Utility::File::loadPublic("publickey.txt") };
+        const std::optional<Key::Private> privateKey { Utility::File::loadPrivate("privatekey.txt") };
+        if (!publicKey || (mode != "encrypt" && mode != "encrypt-file" && !privateKey)) {
+            std::cerr << "Error: couldn't load the keys from publickey.txt/privatekey.txt\n";
+            return 1;
+        }
+
+        bool isSuccessful { false };
+        if (mode == "encrypt")
+            isSuccessful = Filter::encrypt(*publicKey, *threadCount, Container::defaultBlockSize, true);
+        else if (mode == "decrypt")
+            isSuccessful = Filter::decrypt(*publicKey, *privateKey, *threadCount, true);
+        else if (mode == "decrypt-file")
+            isSuccessful = Container::decryptFileSharded(*publicKey, *privateKey, argv[2], argv[3], *threadCount);
+#if defined(__linux__)
+        else if (mode == "encrypt-file")
+            isSuccessful = Container::encryptFileAsync(*publicKey, argv[2], argv[3], Container::defaultBlockSize, 32, 256, true, *threadCount);
+        else if (mode == "decrypt-file-async")
+            isSuccessful = Container::decryptFileAsync(*publicKey, *privateKey, argv[2], argv[3], 32, 256, true, *threadCount);
+#endif
+        else {
+            std::cerr << "Usage: " << argv[0] << " [encrypt|decrypt [threads]] | [decrypt-file <container> <output> [processes]] | [autotune [profile]]"
+                      << " | [encrypt-file <input> <container> [threads]] | [decrypt-file-async <container> <output> [threads]]"
+                      << " | [rotate <new public key> <checkpoint> <old container> <new container> ...]"
+                      << " | [keygen <seed> <index>] | [keyset <seed> <count> <file>]\n";
+            return 1;
+        }
+
+        if (!isSuccessful)
+            std::cerr << "Error: " << mode << " failed\n";
+        return isSuccessful ? 0 : 1;
+    }
+#else
+    (void)argc;
+    (void)argv;
+#endif
+
+    long long int p {};
+    std::cout << "Insert p: ";
+    std::cin >> p;
+    
+    long long int q {};
+    std::cout << "Insert q: ";
+    std::cin >> q;
+
+    // p * q has to fit a long long int, and phi(n) must leave room for an 'e' bigger than 1
+    constexpr long long int maxFactor { 3037000499 };
+    if (!std::cin || !Utility::Math::millerRabin(p) || !Utility::Math::millerRabin(q) || p == q || p > maxFactor || q > maxFactor || (p - 1) * (q - 1) <= 2) {
+        std::cerr << "Error: p and q must be two different prime numbers, below " << maxFactor << ", other than 2 and 3\n";
+        return 1;
+    }
+
+    const std::string publicKey_filename    { "publickey.txt" };
+    const std::string privateKey_filename   { "privatekey.txt" };
+
+    const Key::Public publicKey     { Generate::publicKey(p, q)};
+    const Key::Private privateKey   { Generate::privateKey(p, q, publicKey) };
+
+    if (!Utility::File::saveTo(publicKey_filename, publicKey) || !Utility::File::saveTo(privateKey_filename, privateKey)) {
+        std::cerr << "Error: couldn't write " << publicKey_filename << " and " << privateKey_filename << '\n';
+        return 1;
+    }
+
+    // Get whole number 'm', to be encoded, from the user
+    long long int m {};
+    std::cout << "Insert m: ";
+    std::cin >> m;
+
+    if (!std::cin || m <= 0 || m >= publicKey.n) {
+        std::cerr << "Error: m isn't bigger than 0 and smaller than n (0<m<n)\n";
+        return 1;
+    }
+
+    const long long int c { encode(publicKey, m) };
+
+    std::cout << "Encoded number c: " << c << '\n';
+
+    const long long int m_decoded { decode(publicKey, privateKey, c) };
+
+    std::cout << "Decoded number m: " << m_decoded << '\n';
+
+    if (m == m_decoded)
+        std::cout << "Encoding/Decoding successful!\n";
+    else
+        std::cout << "Encoding/Decoding failed.\n";
+
+    return 0;
+
+}
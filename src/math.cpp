@@ -0,0 +1,150 @@
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <optional>
+#include <span>
+#include <utility>
+
+#include "rsa/math.hpp"
+#include "rsa/tuning.hpp"
+
+namespace Utility {
+    namespace Math {
+        long long int phi([[maybe_unused]] long long int n, long long int p, long long int q) {
+            assert(p * q == n && "Error: p * q != n");
+            assert(isPrime(p) && isPrime(q));
+            return (p - 1) * (q - 1);
+        }
+
+        long long int power(long long int x, long long int exponent) {
+            if (exponent == 0)
+                return 1;
+            
+            long long int result { x };
+
+            for (long long int i { 1 }; i < exponent; ++i)
+                result *= x;
+
+            return result;
+        }
+
+        long long int modPower(long long int x, long long int exponent, long long int modulus, size_t windowBits) {
+            assert(modulus > 0 && exponent >= 0 && "Error: modulus must be bigger than 0 and exponent can't be negative");
+            windowBits = std::clamp<size_t>(windowBits, 1, Tuning::maxWindowBits);
+
+            long long int result { 1 % modulus };
+            x %= modulus;
+            if (x < 0)
+                x += modulus;
+
+            if (windowBits == 1) {
+                while (exponent > 0) {
+                    if (exponent & 1)
+                        result = modMultiply(result, x, modulus);
+                    x = modMultiply(x, x, modulus);
+                    exponent >>= 1;
+                }
+                return result;
+            }
+
+            std::array<long long int, 1 << Tuning::maxWindowBits> powers {};
+            const size_t tableSize { size_t { 1 } << windowBits };
+            powers[0] = result;
+            for (size_t i { 1 }; i < tableSize; ++i)
+                powers[i] = modMultiply(powers[i - 1], x, modulus);
+
+            int topBit { 63 };
+            while (topBit >= 0 && !((exponent >> topBit) & 1))
+                --topBit;
+
+            const int width { static_cast<int>(windowBits) };
+            for (int shift { topBit < 0 ? -1 : topBit / width * width }; shift >= 0; shift -= width) {
+                // Squaring is skipped while the result is still 1
+                if (result != powers[0])
+                    for (int i { 0 }; i < width; ++i)
+                        result = modMultiply(result, result, modulus);
+
+                const long long int digit { (exponent >> shift) & static_cast<long long int>(tableSize - 1) };
+                if (digit != 0)
+                    result = modMultiply(result, powers[static_cast<size_t>(digit)], modulus);
+            }
+
+            return result;
+        }
+
+        long long int modPower(long long int x, long long int exponent, long long int modulus) {
+            return modPower(x, exponent, modulus, Tuning::current().windowBits);
+        }
+
+        bool millerRabin(long long int x, bool isTrialDivisionNeeded) {
+            if (x < 2)
+                return false;
+            if (isTrialDivisionNeeded)
+                for (const int prime : smallPrimes) {
+                    if (x == prime)
+                        return true;
+                    if (x % prime == 0)
+                        return false;
+                }
+            if (x < 1024LL * 1024LL)
+                return true;
+
+            // x - 1 = d * 2^s with d odd
+            long long int d { x - 1 };
+            int s { 0 };
+            while ((d & 1) == 0) {
+                d >>= 1;
+                ++s;
+            }
+
+            // Known sets of bases that make the answer exact: 2, 7 and 61 below 4759123141 (every 32 bit number),
+            // Sinclair's 7 bases for every 64 bit number
+            constexpr std::array<long long int, 3> smallBases { 2, 7, 61 };
+            constexpr std::array<long long int, 7> largeBases { 2, 325, 9375, 28178, 450775, 9780504, 1795265022 };
+            const bool isSmall { x < 4759123141LL };
+            const size_t windowBits { Tuning::current().windowBits };
+
+            for (const long long int base : isSmall ? std::span<const long long int> { smallBases } : std::span<const long long int> { largeBases }) {
+                if (base % x == 0)
+                    continue;
+
+                long long int y { modPower(base, d, x, windowBits) };
+                if (y == 1 || y == x - 1)
+                    continue;
+
+                bool isWitness { true };
+                for (int r { 1 }; r < s && isWitness; ++r) {
+                    y = modMultiply(y, y, x);
+                    isWitness = y != x - 1;
+                }
+                if (isWitness)
+                    return false;
+            }
+            return true;
+        }
+
+        std::optional<long long int> modInverse(long long int a, long long int modulus) {
+            if (modulus <= 0)
+                return std::nullopt;
+
+            long long int oldR { a % modulus }, r { modulus };
+            long long int oldS { 1 }, s { 0 };
+
+            if (oldR < 0)
+                oldR += modulus;
+
+            while (r != 0) {
+                const long long int quotient { oldR / r };
+                oldR -= quotient * r;
+                std::swap(oldR, r);
+                oldS -= quotient * s;
+                std::swap(oldS, s);
+            }
+
+            if (oldR != 1)
+                return std::nullopt;
+
+            return oldS < 0 ? oldS + modulus : oldS;
+        }
+    }
+}
@@ -0,0 +1,147 @@
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "rsa/convert.hpp"
+#include "rsa/hash.hpp"
+#include "rsa/key.hpp"
+#include "rsa/merkle.hpp"
+#include "rsa/padding.hpp"
+#include "rsa/rsa.hpp"
+
+namespace Merkle {
+    namespace Detail {
+        // Leaves and inner nodes are hashed with different prefixes, so a node can never be passed off as a leaf
+        constexpr unsigned char leafPrefix { 0x00 };
+        constexpr unsigned char nodePrefix { 0x01 };
+        constexpr unsigned char rootPrefix { 0x02 };
+
+        Utility::Bytes nodeInput(const Utility::Bytes& left, const Utility::Bytes& right) {
+            Utility::Bytes input {};
+            input.reserve(1 + left.size() + right.size());
+            input.push_back(nodePrefix);
+            input.insert(input.end(), left.begin(), left.end());
+            input.insert(input.end(), right.begin(), right.end());
+            return input;
+        }
+
+        // The signed digest binds the tree root to the number of leaves, so a path can't be replayed against a different shaped tree
+        Utility::Bytes rootDigest(const Utility::Bytes& root, size_t leafCount) {
+            Utility::Bytes input { rootPrefix };
+            for (int i { 7 }; i >= 0; --i)
+                input.push_back(static_cast<unsigned char>(static_cast<unsigned long long int>(leafCount) >> (8 * i)));
+            input.insert(input.end(), root.begin(), root.end());
+            return Hash::sha256(input);
+        }
+    }
+
+    Utility::Bytes leafHash(const Utility::Bytes& message) {
+        Utility::Bytes input { Detail::leafPrefix };
+        const Utility::Bytes digest { Hash::sha256(message) };
+        input.insert(input.end(), digest.begin(), digest.end());
+        return Hash::sha256(input);
+    }
+
+    Utility::Bytes nodeHash(const Utility::Bytes& left, const Utility::Bytes& right) {
+        return Hash::sha256(Detail::nodeInput(left, right));
+    }
+
+    // Each level is hashed in one Hash::sha256Batch call
+    std::vector<std::vector<Utility::Bytes>> buildLevels(const std::vector<Utility::Bytes>& messages) {
+        if (messages.empty())
+            return {};
+
+        const std::vector<Utility::Bytes> digests { Hash::sha256Batch(messages) };
+
+        std::vector<Utility::Bytes> leafInputs {};
+        leafInputs.reserve(digests.size());
+        for (const Utility::Bytes& digest : digests) {
+            Utility::Bytes input { Detail::leafPrefix };
+            input.insert(input.end(), digest.begin(), digest.end());
+            leafInputs.push_back(std::move(input));
+        }
+
+        std::vector<std::vector<Utility::Bytes>> levels { Hash::sha256Batch(leafInputs) };
+
+        while (levels.back().size() > 1) {
+            const std::vector<Utility::Bytes>& level { levels.back() };
+
+            std::vector<Utility::Bytes> inputs {};
+            inputs.reserve(level.size() / 2);
+            for (size_t i { 0 }; i + 1 < level.size(); i += 2)
+                inputs.push_back(Detail::nodeInput(level[i], level[i + 1]));
+
+            std::vector<Utility::Bytes> next { Hash::sha256Batch(inputs) };
+            if (level.size() % 2 == 1)
+                next.push_back(level.back());
+
+            levels.push_back(std::move(next));
+        }
+
+        return levels;
+    }
+
+    std::vector<Utility::Bytes> authenticationPath(const std::vector<std::vector<Utility::Bytes>>& levels, size_t index) {
+        std::vector<Utility::Bytes> path {};
+        size_t position { index };
+        for (size_t level { 0 }; level + 1 < levels.size(); ++level) {
+            const size_t sibling { position ^ 1 };
+            if (sibling < levels[level].size())
+                path.push_back(levels[level][sibling]);
+            position /= 2;
+        }
+        return path;
+    }
+
+    std::optional<Utility::Bytes> rootFromPath(const Utility::Bytes& message, const Proof& proof) {
+        if (proof.index >= proof.leafCount)
+            return std::nullopt;
+
+        Utility::Bytes node { leafHash(message) };
+        size_t position { proof.index };
+        size_t levelSize { proof.leafCount };
+        size_t used { 0 };
+
+        for (; levelSize > 1; levelSize = (levelSize + 1) / 2, position /= 2) {
+            const size_t sibling { position ^ 1 };
+            if (sibling >= levelSize)
+                continue; // Odd node at the end of the level, moved up unchanged
+
+            if (used == proof.path.size())
+                return std::nullopt;
+
+            const Utility::Bytes& siblingHash { proof.path[used++] };
+            node = position % 2 == 0 ? nodeHash(node, siblingHash) : nodeHash(siblingHash, node);
+        }
+
+        if (used != proof.path.size())
+            return std::nullopt;
+        return node;
+    }
+
+    std::optional<std::vector<Proof>> signBatch(const Key::Wide::Private& privateKey, const std::vector<Utility::Bytes>& messages, Padding::Signature::Scheme scheme) {
+        if (messages.empty())
+            return std::vector<Proof> {};
+
+        const std::vector<std::vector<Utility::Bytes>> levels { buildLevels(messages) };
+        const std::optional<Utility::Bytes> rootSignature { sign(privateKey, Detail::rootDigest(levels.back().front(), messages.size()), scheme) };
+        if (!rootSignature)
+            return std::nullopt;
+
+        std::vector<Proof> proofs(messages.size());
+        for (size_t i { 0 }; i < messages.size(); ++i) {
+            Proof& proof { proofs[i] };
+            proof.rootSignature = *rootSignature;
+            proof.index = i;
+            proof.leafCount = messages.size();
+            proof.path = authenticationPath(levels, i);
+        }
+
+        return proofs;
+    }
+
+    bool verify(const Key::Wide::Public& publicKey, const Utility::Bytes& message, const Proof& proof, Padding::Signature::Scheme scheme) {
+        const std::optional<Utility::Bytes> root { rootFromPath(message, proof) };
+        return root && ::verify(publicKey, Detail::rootDigest(*root, proof.leafCount), proof.rootSignature, scheme);
+    }
+}
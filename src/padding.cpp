@@ -0,0 +1,237 @@
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+
+#include "rsa/convert.hpp"
+#include "rsa/hash.hpp"
+#include "rsa/padding.hpp"
+#include "rsa/random.hpp"
+#include "rsa/rsa.hpp"
+
+// Padding schemes from PKCS#1 (RFC 8017), turn a short message into a block exactly as long as the modulus 'n' ('k' bytes)
+// Raw encode() is deterministic and leaks structure of 'm', padding adds randomness and an integrity check
+namespace Padding {
+    Utility::Bytes mgf1(const unsigned char* seed, size_t seedLength, size_t length) {
+        Utility::Bytes mask {};
+        mask.reserve(length + Hash::SHA256::digestSize);
+
+        for (std::uint32_t counter { 0 }; mask.size() < length; ++counter) {
+            const std::array<unsigned char, 4> counterBytes { static_cast<unsigned char>(counter >> 24), static_cast<unsigned char>(counter >> 16), static_cast<unsigned char>(counter >> 8), static_cast<unsigned char>(counter) };
+
+            Hash::SHA256 hash {};
+            hash.update(seed, seedLength);
+            hash.update(counterBytes.data(), counterBytes.size());
+            const Utility::Bytes block { hash.finish() };
+            mask.insert(mask.end(), block.begin(), block.end());
+        }
+
+        mask.resize(length);
+        return mask;
+    }
+
+    namespace OAEP {
+        std::optional<Utility::Bytes> encode(const Utility::Bytes& message, size_t k) {
+            if (k < 2 * hashLength + 2 || message.size() > maxMessageLength(k))
+                return std::nullopt;
+
+            const Utility::Bytes labelHash { Hash::sha256({}) };
+            const size_t dbLength { k - hashLength - 1 };
+
+            Utility::Bytes encoded(k, 0);
+            unsigned char* const seed { encoded.data() + 1 };
+            unsigned char* const db { encoded.data() + 1 + hashLength };
+
+            std::memcpy(db, labelHash.data(), hashLength);
+            db[dbLength - message.size() - 1] = 0x01;
+            std::copy(message.begin(), message.end(), db + dbLength - message.size());
+
+            Utility::Random::fill(seed, hashLength);
+
+            const Utility::Bytes dbMask { mgf1(seed, hashLength, dbLength) };
+            for (size_t i { 0 }; i < dbLength; ++i)
+                db[i] ^= dbMask[i];
+
+            const Utility::Bytes seedMask { mgf1(db, dbLength, hashLength) };
+            for (size_t i { 0 }; i < hashLength; ++i)
+                seed[i] ^= seedMask[i];
+
+            return encoded;
+        }
+
+        std::optional<Utility::Bytes> decode(Utility::Bytes encoded) {
+            const size_t k { encoded.size() };
+            if (k < 2 * hashLength + 2)
+                return std::nullopt;
+
+            const size_t dbLength { k - hashLength - 1 };
+            unsigned char* const seed { encoded.data() + 1 };
+            unsigned char* const db { encoded.data() + 1 + hashLength };
+
+            const Utility::Bytes seedMask { mgf1(db, dbLength, hashLength) };
+            for (size_t i { 0 }; i < hashLength; ++i)
+                seed[i] ^= seedMask[i];
+
+            const Utility::Bytes dbMask { mgf1(seed, hashLength, dbLength) };
+            for (size_t i { 0 }; i < dbLength; ++i)
+                db[i] ^= dbMask[i];
+
+            // Checks are accumulated instead of returning early, so the time taken doesn't point at the failing check
+            const Utility::Bytes labelHash { Hash::sha256({}) };
+            unsigned char invalid { encoded[0] };
+            for (size_t i { 0 }; i < hashLength; ++i)
+                invalid |= db[i] ^ labelHash[i];
+
+            size_t separator { 0 };
+            for (size_t i { hashLength }; i < dbLength; ++i) {
+                const bool isFirstOne { separator == 0 && db[i] == 0x01 };
+                const bool isPaddingByte { separator == 0 && db[i] == 0x00 };
+                if (isFirstOne)
+                    separator = i;
+                else if (separator == 0 && !isPaddingByte)
+                    invalid |= 1;
+            }
+
+            if (invalid != 0 || separator == 0)
+                return std::nullopt;
+
+            return Utility::Bytes(db + separator + 1, db + dbLength);
+        }
+    }
+
+    namespace PKCS1 {
+        std::optional<Utility::Bytes> encode(const Utility::Bytes& message, size_t k) {
+            if (k < minimumPaddingLength + 3 || message.size() > maxMessageLength(k))
+                return std::nullopt;
+
+            const size_t paddingLength { k - message.size() - 3 };
+
+            Utility::Bytes encoded(k, 0);
+            encoded[1] = 0x02;
+
+            unsigned char* const padding { encoded.data() + 2 };
+            Utility::Random::fill(padding, paddingLength);
+            for (size_t i { 0 }; i < paddingLength; ++i)
+                while (padding[i] == 0x00)
+                    Utility::Random::fill(padding + i, 1);
+
+            std::copy(message.begin(), message.end(), encoded.begin() + 3 + static_cast<std::ptrdiff_t>(paddingLength));
+            return encoded;
+        }
+
+        std::optional<Utility::Bytes> decode(const Utility::Bytes& encoded) {
+            const size_t k { encoded.size() };
+            if (k < minimumPaddingLength + 3 || encoded[0] != 0x00 || encoded[1] != 0x02)
+                return std::nullopt;
+
+            size_t separator { 0 };
+            for (size_t i { 2 }; i < k && separator == 0; ++i)
+                if (encoded[i] == 0x00)
+                    separator = i;
+
+            if (separator == 0 || separator - 2 < minimumPaddingLength)
+                return std::nullopt;
+
+            return Utility::Bytes(encoded.begin() + separator + 1, encoded.end());
+        }
+    }
+
+    std::optional<Utility::Bytes> encode(const Utility::Bytes& message, size_t k, Scheme scheme) {
+        return scheme == Scheme::OAEP ? OAEP::encode(message, k) : PKCS1::encode(message, k);
+    }
+
+    std::optional<Utility::Bytes> decode(const Utility::Bytes& encoded, Scheme scheme) {
+        return scheme == Scheme::OAEP ? OAEP::decode(encoded) : PKCS1::decode(encoded);
+    }
+
+    namespace Signature {
+        namespace PKCS1 {
+            std::optional<Utility::Bytes> encode(const Utility::Bytes& digest, size_t k) {
+                const size_t tLength { sha256DigestInfo.size() + digest.size() };
+                if (digest.size() != Hash::SHA256::digestSize || k < tLength + 11)
+                    return std::nullopt;
+
+                Utility::Bytes encoded(k, 0xff);
+                encoded[0] = 0x00;
+                encoded[1] = 0x01;
+                encoded[k - tLength - 1] = 0x00;
+                std::memcpy(encoded.data() + k - tLength, sha256DigestInfo.data(), sha256DigestInfo.size());
+                std::memcpy(encoded.data() + k - digest.size(), digest.data(), digest.size());
+                return encoded;
+            }
+
+            bool verify(const Utility::Bytes& digest, const Utility::Bytes& encoded) {
+                if (digest.size() != Hash::SHA256::digestSize || encoded.size() < sha256DigestInfo.size() + digest.size() + 11)
+                    return false;
+                return encode(digest, encoded.size()) == std::optional<Utility::Bytes> { encoded };
+            }
+        }
+
+        namespace PSS {
+            Utility::Bytes hashWithSalt(const Utility::Bytes& digest, const unsigned char* salt) {
+                const std::array<unsigned char, 8> zeros {};
+
+                Hash::SHA256 hash {};
+                hash.update(zeros.data(), zeros.size());
+                hash.update(digest);
+                hash.update(salt, saltLength);
+                return hash.finish();
+            }
+
+            std::optional<Utility::Bytes> encode(const Utility::Bytes& digest, size_t emBits) {
+                const size_t emLength { (emBits + 7) / 8 };
+                if (digest.size() != hashLength || emLength < hashLength + saltLength + 2)
+                    return std::nullopt;
+
+                const size_t dbLength { emLength - hashLength - 1 };
+
+                Utility::Bytes encoded(emLength, 0);
+                unsigned char* const db { encoded.data() };
+                unsigned char* const salt { db + dbLength - saltLength };
+                unsigned char* const h { db + dbLength };
+
+                Utility::Random::fill(salt, saltLength);
+                db[dbLength - saltLength - 1] = 0x01;
+
+                const Utility::Bytes hashed { hashWithSalt(digest, salt) };
+                std::memcpy(h, hashed.data(), hashLength);
+
+                const Utility::Bytes dbMask { mgf1(h, hashLength, dbLength) };
+                for (size_t i { 0 }; i < dbLength; ++i)
+                    db[i] ^= dbMask[i];
+
+                db[0] &= static_cast<unsigned char>(0xff >> (8 * emLength - emBits));
+                encoded[emLength - 1] = 0xbc;
+                return encoded;
+            }
+
+            bool verify(const Utility::Bytes& digest, Utility::Bytes encoded, size_t emBits) {
+                const size_t emLength { (emBits + 7) / 8 };
+                if (digest.size() != hashLength || encoded.size() != emLength || emLength < hashLength + saltLength + 2)
+                    return false;
+
+                const unsigned char topBitsMask { static_cast<unsigned char>(0xff << (8 - (8 * emLength - emBits))) };
+                if (encoded[emLength - 1] != 0xbc || (8 * emLength != emBits && (encoded[0] & topBitsMask) != 0))
+                    return false;
+
+                const size_t dbLength { emLength - hashLength - 1 };
+                unsigned char* const db { encoded.data() };
+                const unsigned char* const h { db + dbLength };
+
+                const Utility::Bytes dbMask { mgf1(h, hashLength, dbLength) };
+                for (size_t i { 0 }; i < dbLength; ++i)
+                    db[i] ^= dbMask[i];
+                db[0] &= static_cast<unsigned char>(0xff >> (8 * emLength - emBits));
+
+                for (size_t i { 0 }; i < dbLength - saltLength - 1; ++i)
+                    if (db[i] != 0x00)
+                        return false;
+                if (db[dbLength - saltLength - 1] != 0x01)
+                    return false;
+
+                return hashWithSalt(digest, db + dbLength - saltLength) == Utility::Bytes(h, h + hashLength);
+            }
+        }
+    }
+}
@@ -0,0 +1,159 @@
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <random>
+
+#if defined(__unix__)
+#include <pthread.h>
+#endif
+
+#if defined(__linux__)
+#include <sys/random.h>
+#endif
+
+#include "rsa/convert.hpp"
+#include "rsa/random.hpp"
+
+#include "detail/cipher.hpp"
+
+// Random bytes for padding seeds, salts and session keys: one ChaCha20 generator per thread, seeded by the kernel
+// Drawing from it takes no lock and no system call, the kernel is only asked again every reseedInterval bytes and after fork()
+namespace Utility {
+    namespace Random {
+        namespace Detail {
+            constexpr size_t bufferSize { Cipher::Detail::maxLanes * Cipher::ChaCha20::blockSize };
+            constexpr unsigned long long int reseedInterval { 1ULL << 20 };
+
+            // Bumped in the child after every fork(), a generator seeing a new value throws away its state before its next output,
+            // so parent and child never hand out the same bytes
+            std::atomic<unsigned int> forkGeneration { 0 };
+
+            // Bytes straight from the kernel (getrandom), or from std::random_device where there is no getrandom
+            void fromKernel(unsigned char* bytes, size_t length) {
+#if defined(__linux__)
+                while (length > 0) {
+                    const ssize_t count { getrandom(bytes, length, 0) };
+                    if (count < 0 && errno == EINTR)
+                        continue;
+                    if (count <= 0)
+                        break;
+                    bytes += count;
+                    length -= static_cast<size_t>(count);
+                }
+#endif
+                static thread_local std::random_device device {};
+                for (size_t i { 0 }; i < length; i += sizeof(unsigned int)) {
+                    const unsigned int value { device() };
+                    std::memcpy(bytes + i, &value, std::min(sizeof(unsigned int), length - i));
+                }
+            }
+
+            // Fast key erasure generator: every refill computes a buffer of keystream whose first 32 bytes become the next key
+            // and are wiped, so reading the generator's memory later can't give back bytes it already handed out
+            class Generator {
+            public:
+                void fill(unsigned char* bytes, size_t length) {
+                    const unsigned int generation { forkGeneration.load(std::memory_order_relaxed) };
+                    if (generation != seenGeneration) {
+                        seenGeneration = generation;
+                        position = bufferSize;
+                        isSeeded = false;
+                    }
+
+                    while (length > 0) {
+                        if (position == bufferSize)
+                            refill();
+
+                        const size_t taken { std::min(length, bufferSize - position) };
+                        std::memcpy(bytes, buffer.data() + position, taken);
+                        std::memset(buffer.data() + position, 0, taken);
+
+                        position += taken;
+                        bytes += taken;
+                        length -= taken;
+                    }
+                }
+
+            private:
+                void refill() {
+                    if (!isSeeded || generated >= reseedInterval)
+                        reseed();
+
+                    std::uint32_t input[16] { 0x61707865, 0x3320646e, 0x79622d32, 0x6b206574 };
+                    for (int i { 0 }; i < 8; ++i)
+                        input[4 + i] = Cipher::Detail::loadLittleEndian32(key.data() + 4 * i);
+
+                    const size_t step { generator.lanes * Cipher::ChaCha20::blockSize };
+                    for (size_t offset { 0 }; offset < bufferSize; offset += step)
+                        generator.generate(input, static_cast<std::uint32_t>(offset / Cipher::ChaCha20::blockSize), buffer.data() + offset);
+
+                    std::memcpy(key.data(), buffer.data(), key.size());
+                    std::memset(buffer.data(), 0, key.size());
+                    position = key.size();
+                    generated += bufferSize;
+                }
+
+                // Kernel bytes are mixed into the current key rather than replacing it
+                void reseed() {
+                    std::array<unsigned char, Cipher::ChaCha20::keySize> seed {};
+                    fromKernel(seed.data(), seed.size());
+                    for (size_t i { 0 }; i < key.size(); ++i)
+                        key[i] ^= seed[i];
+
+                    isSeeded = true;
+                    generated = 0;
+                }
+
+                const Cipher::Detail::BlockGenerator generator { Cipher::Detail::blockGenerator() };
+                std::array<unsigned char, Cipher::ChaCha20::keySize> key {};
+                alignas(64) std::array<unsigned char, bufferSize> buffer {};
+                size_t position { bufferSize };
+                unsigned long long int generated { 0 };
+                unsigned int seenGeneration { forkGeneration.load(std::memory_order_relaxed) };
+                bool isSeeded { false };
+            };
+
+            Generator& local() {
+#if defined(__unix__)
+                static const bool isForkHandled { pthread_atfork(nullptr, nullptr, [] { forkGeneration.fetch_add(1, std::memory_order_relaxed); }) == 0 };
+                (void)isForkHandled;
+#endif
+                thread_local Generator generator {};
+                return generator;
+            }
+        }
+
+        void fill(unsigned char* bytes, size_t length) {
+            Detail::local().fill(bytes, length);
+        }
+
+        void fill(Bytes& bytes) {
+            fill(bytes.data(), bytes.size());
+        }
+
+        std::uint64_t next() {
+            unsigned char bytes[sizeof(std::uint64_t)];
+            fill(bytes, sizeof(bytes));
+
+            std::uint64_t value {};
+            std::memcpy(&value, bytes, sizeof(value));
+            return value;
+        }
+
+        std::uint64_t below(std::uint64_t bound) {
+            assert(bound > 0 && "Error: empty range");
+
+            // Values under 'threshold' would make the smallest remainders a little more likely, they are drawn again
+            const std::uint64_t threshold { (0 - bound) % bound };
+            while (true) {
+                const std::uint64_t value { next() };
+                if (value >= threshold)
+                    return value % bound;
+            }
+        }
+    }
+}
@@ -0,0 +1,271 @@
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <thread>
+
+#if defined(__unix__)
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include "rsa/concurrency.hpp"
+#include "rsa/container.hpp"
+#include "rsa/convert.hpp"
+#include "rsa/generate.hpp"
+#include "rsa/hash.hpp"
+#include "rsa/key.hpp"
+#include "rsa/rotation.hpp"
+
+#include "detail/container.hpp"
+
+#if defined(__unix__)
+namespace Rotation {
+    // Where a job stopped: every block before 'block' of file 'file' is done, and so is every earlier file
+    struct Checkpoint {
+        std::string jobId {};
+        size_t file {};
+        unsigned long long int block {};
+    };
+
+    namespace Detail {
+        // Identifies a job by its keys and files, a checkpoint written by a different job is never resumed
+        std::string jobId(const Key::Public& oldPublicKey, const Key::Public& newPublicKey, const Job& job) {
+            Hash::SHA256 hash {};
+            hash.update(Hash::fingerprint(oldPublicKey));
+            hash.update(Hash::fingerprint(newPublicKey));
+            for (const auto& [input, output] : job.files) {
+                hash.update(reinterpret_cast<const unsigned char*>(input.data()), input.size() + 1);
+                hash.update(reinterpret_cast<const unsigned char*>(output.data()), output.size() + 1);
+            }
+            return Utility::Convert::toHex(hash.finish());
+        }
+
+        std::optional<Checkpoint> loadCheckpoint(const std::string& filename) {
+            std::ifstream fs { filename };
+
+            Checkpoint checkpoint {};
+            std::string label_job {}, label_file {}, label_block {};
+            if (!(fs >> label_job >> checkpoint.jobId >> label_file >> checkpoint.file >> label_block >> checkpoint.block) || label_job != "job:" || label_file != "file:" || label_block != "block:")
+                return std::nullopt;
+
+            return checkpoint;
+        }
+
+        // Sleeps as needed so that, on average, no more than 'bytesPerSecond' bytes are read
+        class Throttle {
+        public:
+            explicit Throttle(unsigned long long int bytesPerSecond)
+                : bytesPerSecond { bytesPerSecond } {}
+
+            void consume(unsigned long long int bytes) {
+                if (bytesPerSecond == 0)
+                    return;
+
+                consumed += bytes;
+                const std::chrono::duration<double> allowed { static_cast<double>(consumed) / static_cast<double>(bytesPerSecond) };
+                const auto due { start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(allowed) };
+                if (due > std::chrono::steady_clock::now())
+                    std::this_thread::sleep_until(due);
+            }
+
+        private:
+            const unsigned long long int bytesPerSecond;
+            const std::chrono::steady_clock::time_point start { std::chrono::steady_clock::now() };
+            unsigned long long int consumed { 0 };
+        };
+
+        bool readAt(int descriptor, unsigned char* data, size_t length, unsigned long long int offset) {
+            while (length > 0) {
+                const ssize_t result { ::pread(descriptor, data, length, static_cast<off_t>(offset)) };
+                if (result < 0 && errno == EINTR)
+                    continue;
+                if (result <= 0)
+                    return false;
+                data += result;
+                length -= static_cast<size_t>(result);
+                offset += static_cast<unsigned long long int>(result);
+            }
+            return true;
+        }
+
+        bool writeAt(int descriptor, const unsigned char* data, size_t length, unsigned long long int offset) {
+            while (length > 0) {
+                const ssize_t result { ::pwrite(descriptor, data, length, static_cast<off_t>(offset)) };
+                if (result < 0 && errno == EINTR)
+                    continue;
+                if (result <= 0)
+                    return false;
+                data += result;
+                length -= static_cast<size_t>(result);
+                offset += static_cast<unsigned long long int>(result);
+            }
+            return true;
+        }
+
+        // Written to a temporary file, synced, and renamed over the old one, so a crash never leaves a half written
+        // checkpoint. The directory is synced too, so the rename itself survives a power loss
+        bool saveCheckpoint(const std::string& filename, const Checkpoint& checkpoint) {
+            const std::string temporary { filename + ".tmp" };
+            const std::string contents { "job: " + checkpoint.jobId + "\nfile: " + std::to_string(checkpoint.file) + "\nblock: " + std::to_string(checkpoint.block) };
+
+            const int descriptor { ::open(temporary.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644) };
+            if (descriptor < 0)
+                return false;
+            const bool isWritten { writeAt(descriptor, reinterpret_cast<const unsigned char*>(contents.data()), contents.size(), 0) && ::fsync(descriptor) == 0 };
+            if (::close(descriptor) != 0 || !isWritten || std::rename(temporary.c_str(), filename.c_str()) != 0)
+                return false;
+
+            const std::string::size_type slash { filename.find_last_of('/') };
+            const std::string directoryName { slash == std::string::npos ? "." : slash == 0 ? "/" : filename.substr(0, slash) };
+            const int directory { ::open(directoryName.c_str(), O_RDONLY | O_DIRECTORY) };
+            if (directory < 0)
+                return false;
+            const bool isSynced { ::fsync(directory) == 0 };
+            ::close(directory);
+            return isSynced;
+        }
+    }
+
+    // Re-encodes one container starting at block 'firstBlock', saving a checkpoint for 'file' after every round
+    bool reencryptFile(const Key::Public& oldPublicKey, const Key::CRT& oldCrtKey, const Key::Public& newPublicKey, const Job& job,
+                       Checkpoint checkpoint, Detail::Throttle& throttle) {
+        const auto& [inputFilename, outputFilename] { job.files[checkpoint.file] };
+
+        std::optional<Container::Layout> layout {};
+        {
+            std::ifstream in { inputFilename, std::ios::binary };
+            layout = Container::readLayout(in);
+        }
+        if (!layout || layout->header.fingerprint != Hash::fingerprint(oldPublicKey))
+            return false;
+
+        const Container::Header& oldHeader { layout->header };
+        Container::Header newHeader { oldHeader };
+        newHeader.fingerprint = Hash::fingerprint(newPublicKey);
+        newHeader.k = Utility::Convert::byteLength(newPublicKey.n);
+        if (newHeader.k < 2)
+            return false;
+
+        // A resumed file keeps the blocks already written, a new one starts empty
+        const int input { ::open(inputFilename.c_str(), O_RDONLY) };
+        const int output { ::open(outputFilename.c_str(), checkpoint.block == 0 ? O_WRONLY | O_CREAT | O_TRUNC : O_WRONLY, 0644) };
+        const auto closeFiles { [input, output] {
+            if (input >= 0)
+                ::close(input);
+            if (output >= 0)
+                ::close(output);
+        } };
+        if (input < 0 || output < 0) {
+            closeFiles();
+            return false;
+        }
+
+        const size_t threadCount { std::max<size_t>(1, job.threadCount) };
+        const size_t segmentBlocks { std::max<size_t>(1, job.segmentBlocks) };
+        std::atomic<bool> isValid { true };
+
+        while (checkpoint.block < oldHeader.blockCount && isValid) {
+            const unsigned long long int roundBegin { checkpoint.block };
+            const unsigned long long int roundEnd { std::min<unsigned long long int>(oldHeader.blockCount, roundBegin + threadCount * segmentBlocks) };
+            throttle.consume((roundEnd - roundBegin) * oldHeader.ciphertextBlockSize());
+
+            // Every worker reads, decodes, encodes and writes its own segment of the round
+            const auto work { [&](size_t worker) {
+                const unsigned long long int first { roundBegin + worker * segmentBlocks };
+                const unsigned long long int last { std::min<unsigned long long int>(roundEnd, first + segmentBlocks) };
+                if (first >= last)
+                    return;
+
+                Utility::Bytes ciphertext(static_cast<size_t>(last - first) * oldHeader.ciphertextBlockSize());
+                Utility::Bytes reencoded(static_cast<size_t>(last - first) * newHeader.ciphertextBlockSize());
+                Utility::Bytes plaintext(oldHeader.blockSize);
+
+                if (!Detail::readAt(input, ciphertext.data(), ciphertext.size(), oldHeader.blockOffset(first))) {
+                    isValid = false;
+                    return;
+                }
+
+                for (unsigned long long int i { first }; i < last; ++i) {
+                    const size_t length { layout->index[i].plaintextLength };
+                    const unsigned char* const oldBlock { ciphertext.data() + (i - first) * oldHeader.ciphertextBlockSize() };
+                    unsigned char* const newBlock { reencoded.data() + (i - first) * newHeader.ciphertextBlockSize() };
+
+                    if (!Container::decryptBlock(oldCrtKey, oldHeader, oldBlock, length, plaintext.data())) {
+                        isValid = false;
+                        return;
+                    }
+                    Container::encryptBlock(newPublicKey, newHeader, plaintext.data(), length, newBlock);
+                    Concurrency::defaultPool().yield();
+                }
+
+                if (!Detail::writeAt(output, reencoded.data(), reencoded.size(), newHeader.blockOffset(first)))
+                    isValid = false;
+            } };
+
+            // Rotation is background work: it runs as bulk work on the shared pool, so interactive operations in the same
+            // process keep their latency
+            Concurrency::defaultPool().parallelFor(threadCount, work, Concurrency::Priority::Bulk);
+
+            // The checkpoint only moves once the round's blocks are durable
+            if (!isValid || ::fdatasync(output) != 0) {
+                closeFiles();
+                return false;
+            }
+            checkpoint.block = roundEnd;
+            if (!Detail::saveCheckpoint(job.checkpointFilename, checkpoint)) {
+                closeFiles();
+                return false;
+            }
+        }
+
+        Utility::Bytes index {};
+        for (unsigned long long int i { 0 }; i < newHeader.blockCount; ++i) {
+            Container::Detail::append(index, newHeader.blockOffset(i), 8);
+            Container::Detail::append(index, layout->index[i].plaintextLength, 4);
+        }
+        Container::Detail::append(index, newHeader.blockOffset(newHeader.blockCount), 8);
+        index.insert(index.end(), Container::indexMagic.begin(), Container::indexMagic.end());
+        const Utility::Bytes headerBytes { Container::Detail::serialize(newHeader) };
+
+        const bool isWritten { isValid
+            && Detail::writeAt(output, index.data(), index.size(), newHeader.blockOffset(newHeader.blockCount))
+            && Detail::writeAt(output, headerBytes.data(), headerBytes.size(), 0)
+            && ::ftruncate(output, static_cast<off_t>(newHeader.blockOffset(newHeader.blockCount) + index.size())) == 0
+            && ::fdatasync(output) == 0 };
+        closeFiles();
+        return isWritten;
+    }
+
+    bool reencrypt(const Key::Public& oldPublicKey, const Key::Private& oldPrivateKey, const Key::Public& newPublicKey, const Job& job) {
+        const std::string jobId { Detail::jobId(oldPublicKey, newPublicKey, job) };
+
+        Checkpoint checkpoint { jobId, 0, 0 };
+        if (const std::optional<Checkpoint> saved { Detail::loadCheckpoint(job.checkpointFilename) }; saved && saved->jobId == jobId)
+            checkpoint = *saved;
+
+        const std::optional<Key::CRT> oldCrtKey { Generate::crt(oldPrivateKey) };
+        if (!oldCrtKey)
+            return false;
+
+        Detail::Throttle throttle { job.bytesPerSecond };
+
+        for (; checkpoint.file < job.files.size(); ++checkpoint.file, checkpoint.block = 0) {
+            if (!reencryptFile(oldPublicKey, *oldCrtKey, newPublicKey, job, checkpoint, throttle))
+                return false;
+
+            // The finished file is recorded before moving on, a resumed job doesn't redo it
+            if (!Detail::saveCheckpoint(job.checkpointFilename, Checkpoint { jobId, checkpoint.file + 1, 0 }))
+                return false;
+        }
+
+        std::remove(job.checkpointFilename.c_str());
+        return true;
+    }
+}
+#endif
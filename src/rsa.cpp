@@ -0,0 +1,175 @@
+#include <algorithm>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "rsa/bignum.hpp"
+#include "rsa/concurrency.hpp"
+#include "rsa/convert.hpp"
+#include "rsa/generate.hpp"
+#include "rsa/hash.hpp"
+#include "rsa/key.hpp"
+#include "rsa/math.hpp"
+#include "rsa/padding.hpp"
+#include "rsa/rsa.hpp"
+#include "rsa/tuning.hpp"
+
+long long int encode(const Key::Public& publicKey, const long long int m) {
+    const long long int c { Utility::Math::modPower(m, publicKey.e, publicKey.n, Tuning::current().windowBits) };
+
+    return c;
+}
+
+long long int decode(const Key::Public& publicKey, const Key::Private& privateKey, const long long int c) {
+    const long long int m { Utility::Math::modPower(c, privateKey.d, publicKey.n, Tuning::current().windowBits) };
+
+    return m;
+}
+
+long long int decode(const Key::CRT& crtKey, const long long int c) {
+    const size_t windowBits { Tuning::current().windowBits };
+    const long long int m1 { Utility::Math::modPower(c, crtKey.dP, crtKey.p, windowBits) };
+    const long long int m2 { Utility::Math::modPower(c, crtKey.dQ, crtKey.q, windowBits) };
+
+    long long int difference { (m1 - m2 % crtKey.p) % crtKey.p };
+    if (difference < 0)
+        difference += crtKey.p;
+
+    const long long int h { Utility::Math::modMultiply(crtKey.qInv, difference, crtKey.p) };
+
+    return m2 + h * crtKey.q;
+}
+
+BigNum::Integer encode(const Key::Wide::Public& publicKey, const BigNum::Integer& m) {
+    return BigNum::modPower(m, publicKey.e, publicKey.n);
+}
+
+BigNum::Integer decode(const Key::Wide::CRT& crtKey, const BigNum::Integer& c) {
+    const BigNum::Integer m1 { BigNum::modPower(c, crtKey.dP, crtKey.p) };
+    const BigNum::Integer m2 { BigNum::modPower(c, crtKey.dQ, crtKey.q) };
+
+    // Garner: m = m2 + q * (qInv * (m1 - m2) mod p), with m1 - m2 brought into [0, p) first
+    const BigNum::Integer m2ModP { m2 % crtKey.p };
+    const BigNum::Integer difference { m1 >= m2ModP ? m1 - m2ModP : m1 + crtKey.p - m2ModP };
+    const BigNum::Integer h { (crtKey.qInv * difference) % crtKey.p };
+
+    return m2 + h * crtKey.q;
+}
+
+std::optional<Utility::Bytes> encrypt(const Key::Wide::Public& publicKey, const Utility::Bytes& message, Padding::Scheme scheme) {
+    const size_t k { publicKey.n.byteLength() };
+
+    const std::optional<Utility::Bytes> encoded { Padding::encode(message, k, scheme) };
+    if (!encoded)
+        return std::nullopt;
+
+    const BigNum::Integer m { BigNum::Integer::fromBytes(*encoded) };
+    if (m >= publicKey.n)
+        return std::nullopt;
+
+    return encode(publicKey, m).toBytes(k);
+}
+
+std::optional<Utility::Bytes> decrypt(const Key::Wide::CRT& crtKey, const Utility::Bytes& ciphertext, Padding::Scheme scheme) {
+    const BigNum::Integer n { crtKey.p * crtKey.q };
+    const size_t k { n.byteLength() };
+    if (ciphertext.size() != k)
+        return std::nullopt;
+
+    const BigNum::Integer c { BigNum::Integer::fromBytes(ciphertext) };
+    if (c >= n)
+        return std::nullopt;
+
+    const std::optional<Utility::Bytes> encoded { decode(crtKey, c).toBytes(k) };
+    if (!encoded)
+        return std::nullopt;
+
+    return Padding::decode(*encoded, scheme);
+}
+
+std::optional<Utility::Bytes> decrypt(const Key::Wide::Private& privateKey, const Utility::Bytes& ciphertext, Padding::Scheme scheme) {
+    const std::optional<Key::Wide::CRT> crtKey { Generate::crt(privateKey) };
+    if (!crtKey)
+        return std::nullopt;
+
+    return decrypt(*crtKey, ciphertext, scheme);
+}
+
+std::optional<Utility::Bytes> sign(const Key::Wide::CRT& crtKey, const Utility::Bytes& digest, Padding::Signature::Scheme scheme) {
+    const BigNum::Integer n { crtKey.p * crtKey.q };
+    const size_t k { n.byteLength() };
+
+    const std::optional<Utility::Bytes> encoded { scheme == Padding::Signature::Scheme::PKCS1 ? Padding::Signature::PKCS1::encode(digest, k) : Padding::Signature::PSS::encode(digest, n.bitLength() - 1) };
+    if (!encoded)
+        return std::nullopt;
+
+    const BigNum::Integer m { BigNum::Integer::fromBytes(*encoded) };
+    if (m >= n)
+        return std::nullopt;
+
+    return decode(crtKey, m).toBytes(k);
+}
+
+std::optional<Utility::Bytes> sign(const Key::Wide::Private& privateKey, const Utility::Bytes& digest, Padding::Signature::Scheme scheme) {
+    const std::optional<Key::Wide::CRT> crtKey { Generate::crt(privateKey) };
+    if (!crtKey)
+        return std::nullopt;
+
+    return sign(*crtKey, digest, scheme);
+}
+
+bool verify(const Key::Wide::Public& publicKey, const Utility::Bytes& digest, const Utility::Bytes& signature, Padding::Signature::Scheme scheme) {
+    const size_t k { publicKey.n.byteLength() };
+    if (signature.size() != k)
+        return false;
+
+    const BigNum::Integer s { BigNum::Integer::fromBytes(signature) };
+    if (s >= publicKey.n)
+        return false;
+
+    const BigNum::Integer m { encode(publicKey, s) };
+
+    if (scheme == Padding::Signature::Scheme::PKCS1) {
+        const std::optional<Utility::Bytes> encoded { m.toBytes(k) };
+        return encoded && Padding::Signature::PKCS1::verify(digest, *encoded);
+    }
+
+    const size_t emBits { publicKey.n.bitLength() - 1 };
+    const std::optional<Utility::Bytes> encoded { m.toBytes((emBits + 7) / 8) };
+    return encoded && Padding::Signature::PSS::verify(digest, *encoded, emBits);
+}
+
+std::vector<std::optional<Utility::Bytes>> signBatch(const Key::Wide::Private& privateKey, const std::vector<Utility::Bytes>& digests, Padding::Signature::Scheme scheme) {
+    std::vector<std::optional<Utility::Bytes>> signatures(digests.size());
+
+    std::optional<Key::Wide::CRT> crtKey { Generate::crt(privateKey) };
+    if (!crtKey)
+        return signatures;
+
+    Concurrency::NodeLocal<Key::Wide::CRT> crtKeys { std::move(*crtKey) };
+
+    Concurrency::defaultPool().parallelFor(digests.size(), [&](size_t i) {
+        signatures[i] = sign(crtKeys.local(), digests[i], scheme);
+    });
+
+    return signatures;
+}
+
+std::vector<std::optional<Utility::Bytes>> signMessages(const Key::Wide::Private& privateKey, const std::vector<Utility::Bytes>& messages, Padding::Signature::Scheme scheme) {
+    return signBatch(privateKey, Hash::sha256Batch(messages), scheme);
+}
+
+std::vector<bool> verifyBatch(const Key::Wide::Public& publicKey, const std::vector<Utility::Bytes>& digests, const std::vector<Utility::Bytes>& signatures, Padding::Signature::Scheme scheme) {
+    // std::vector<bool> packs results into shared bytes, so threads write to one byte each first
+    std::vector<unsigned char> isValid(digests.size());
+
+    Concurrency::defaultPool().parallelFor(std::min(digests.size(), signatures.size()), [&](size_t i) {
+        isValid[i] = verify(publicKey, digests[i], signatures[i], scheme);
+    });
+
+    return std::vector<bool>(isValid.begin(), isValid.end());
+}
+
+std::vector<bool> verifyMessages(const Key::Wide::Public& publicKey, const std::vector<Utility::Bytes>& messages, const std::vector<Utility::Bytes>& signatures, Padding::Signature::Scheme scheme) {
+    return verifyBatch(publicKey, Hash::sha256Batch(messages), signatures, scheme);
+}
@@ -0,0 +1,83 @@
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstdio>
+#include <functional>
+#include <iostream>
+#include <new>
+#include <vector>
+
+#if defined(__unix__)
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+#include "detail/sharding.hpp"
+
+#if defined(__unix__)
+namespace Sharding {
+    // Work handed out to the workers: each one claims the next chunk of items with a single atomic add
+    struct Board {
+        std::atomic<unsigned long long int> next {};
+        std::atomic<bool> hasFailed {};
+    };
+    static_assert(std::atomic<unsigned long long int>::is_always_lock_free && std::atomic<bool>::is_always_lock_free,
+                  "Error: atomics shared between processes must be lock-free");
+
+    bool run(size_t processCount, unsigned long long int itemCount, unsigned long long int chunkSize,
+             const std::function<bool(unsigned long long int, unsigned long long int)>& work) {
+        processCount = std::max<size_t>(1, processCount);
+        chunkSize = std::max<unsigned long long int>(1, chunkSize);
+
+        void* const mapped { ::mmap(nullptr, sizeof(Board), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0) };
+        if (mapped == MAP_FAILED)
+            return false;
+        Board* const board { new (mapped) Board {} };
+
+        // Buffered output would otherwise be written once per process
+        std::cout.flush();
+        std::cerr.flush();
+        std::fflush(nullptr);
+
+        std::vector<pid_t> workers {};
+        for (size_t i { 0 }; i < processCount; ++i) {
+            const pid_t pid { ::fork() };
+            if (pid < 0) {
+                board->hasFailed = true;
+                break;
+            }
+
+            if (pid == 0) {
+                while (!board->hasFailed.load(std::memory_order_relaxed)) {
+                    const unsigned long long int first { board->next.fetch_add(chunkSize, std::memory_order_relaxed) };
+                    if (first >= itemCount)
+                        break;
+                    if (!work(first, std::min(itemCount, first + chunkSize))) {
+                        board->hasFailed = true;
+                        ::_exit(1);
+                    }
+                }
+                ::_exit(0);
+            }
+            workers.push_back(pid);
+        }
+
+        bool isSuccessful { true };
+        for (const pid_t pid : workers) {
+            int status {};
+            while (::waitpid(pid, &status, 0) < 0)
+                if (errno != EINTR) {
+                    status = 1;
+                    break;
+                }
+            isSuccessful = isSuccessful && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+        }
+        isSuccessful = isSuccessful && !board->hasFailed;
+
+        board->~Board();
+        ::munmap(mapped, sizeof(Board));
+        return isSuccessful;
+    }
+}
+#endif
@@ -0,0 +1,49 @@
+#include <algorithm>
+#include <optional>
+
+#include "rsa/concurrency.hpp"
+#include "rsa/generate.hpp"
+#include "rsa/key.hpp"
+#include "rsa/rsa.hpp"
+#include "rsa/table.hpp"
+
+// Lookup tables for toy keys: when 'n' is small, encode() and decode() are precomputed for every number below 'n'
+// and each operation becomes a single array read. Handy for classroom exercises and fuzzers running millions of operations
+namespace Table {
+    std::optional<Tables> build(const Key::Public& publicKey, const Key::Private& privateKey) {
+        const long long int n { publicKey.n };
+        if (n <= 0 || n > maxModulus)
+            return std::nullopt;
+
+        const std::optional<Key::CRT> crtKey { Generate::crt(privateKey) };
+        if (!crtKey)
+            return std::nullopt;
+
+        Tables tables { n, PackedArray { static_cast<size_t>(n), n - 1 }, PackedArray { static_cast<size_t>(n), n - 1 } };
+
+        constexpr size_t rangeSize { 64 * 64 };
+        const size_t rangeCount { (static_cast<size_t>(n) + rangeSize - 1) / rangeSize };
+
+        Concurrency::defaultPool().parallelFor(rangeCount, [&](size_t range) {
+            const size_t last { std::min(static_cast<size_t>(n), (range + 1) * rangeSize) };
+            for (size_t x { range * rangeSize }; x < last; ++x) {
+                tables.encoded.set(x, ::encode(publicKey, static_cast<long long int>(x)));
+                tables.decoded.set(x, ::decode(*crtKey, static_cast<long long int>(x)));
+            }
+        }, Concurrency::Priority::Bulk);
+
+        return tables;
+    }
+
+    std::optional<long long int> encode(const Tables& tables, const long long int m) {
+        if (m < 0 || m >= tables.n)
+            return std::nullopt;
+        return tables.encoded.get(static_cast<size_t>(m));
+    }
+
+    std::optional<long long int> decode(const Tables& tables, const long long int c) {
+        if (c < 0 || c >= tables.n)
+            return std::nullopt;
+        return tables.decoded.get(static_cast<size_t>(c));
+    }
+}
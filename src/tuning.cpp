@@ -0,0 +1,182 @@
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <optional>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "rsa/async.hpp"
+#include "rsa/concurrency.hpp"
+#include "rsa/convert.hpp"
+#include "rsa/generate.hpp"
+#include "rsa/hash.hpp"
+#include "rsa/key.hpp"
+#include "rsa/math.hpp"
+#include "rsa/random.hpp"
+#include "rsa/tuning.hpp"
+
+namespace Tuning {
+    std::string profileFilename() {
+        const char* const fromEnvironment { std::getenv("RSA_TUNING_PROFILE") };
+        return fromEnvironment && *fromEnvironment ? fromEnvironment : "tuning.txt";
+    }
+
+    namespace Detail {
+        // A whole token as a number, nothing is returned for signs, trailing characters or values that don't fit
+        std::optional<size_t> parseSize(const std::string& text) {
+            size_t value {};
+            const auto [rest, error] { std::from_chars(text.data(), text.data() + text.size(), value) };
+            if (error != std::errc {} || rest != text.data() + text.size() || text.empty())
+                return std::nullopt;
+            return value;
+        }
+    }
+
+    std::optional<Profile> load(const std::string& filename) {
+        std::ifstream fs { filename };
+        if (!fs)
+            return std::nullopt;
+
+        Profile profile {};
+        std::string label {}, value {};
+        while (fs >> label >> value) {
+            if (label == "windowBits:") {
+                const std::optional<size_t> windowBits { Detail::parseSize(value) };
+                if (!windowBits)
+                    return std::nullopt;
+                profile.windowBits = std::clamp<size_t>(*windowBits, 1, maxWindowBits);
+            }
+            else if (label == "hashBatch:") {
+                if (value != "serial" && value != "lanes" && value != "auto")
+                    return std::nullopt;
+                profile.hashBatch = value == "serial" ? HashBatch::Serial : value == "lanes" ? HashBatch::Lanes : HashBatch::Auto;
+            }
+            else if (label == "asyncBatchSize:") {
+                const std::optional<size_t> asyncBatchSize { Detail::parseSize(value) };
+                if (!asyncBatchSize)
+                    return std::nullopt;
+                profile.asyncBatchSize = std::max<size_t>(1, *asyncBatchSize);
+            }
+        }
+        return profile;
+    }
+
+    bool save(const std::string& filename, const Profile& profile) {
+        std::ofstream fs { filename, std::ios::trunc };
+        const char* const hashBatch { profile.hashBatch == HashBatch::Serial ? "serial" : profile.hashBatch == HashBatch::Lanes ? "lanes" : "auto" };
+        fs << "windowBits: " << profile.windowBits << '\n'
+           << "hashBatch: " << hashBatch << '\n'
+           << "asyncBatchSize: " << profile.asyncBatchSize << '\n';
+        return static_cast<bool>(fs);
+    }
+
+    namespace Detail {
+        std::atomic<size_t> windowBits { Profile {}.windowBits };
+        std::atomic<HashBatch> hashBatch { Profile {}.hashBatch };
+        std::atomic<size_t> asyncBatchSize { Profile {}.asyncBatchSize };
+    }
+
+    Profile current() {
+        Profile profile {};
+        profile.windowBits = Detail::windowBits.load(std::memory_order_relaxed);
+        profile.hashBatch = Detail::hashBatch.load(std::memory_order_relaxed);
+        profile.asyncBatchSize = Detail::asyncBatchSize.load(std::memory_order_relaxed);
+        return profile;
+    }
+
+    void use(const Profile& profile) {
+        Detail::windowBits.store(std::clamp<size_t>(profile.windowBits, 1, maxWindowBits), std::memory_order_relaxed);
+        Detail::hashBatch.store(profile.hashBatch, std::memory_order_relaxed);
+        Detail::asyncBatchSize.store(std::max<size_t>(1, profile.asyncBatchSize), std::memory_order_relaxed);
+    }
+}
+
+// The benchmarks behind "rsa autotune", they run the real kernels
+namespace Tuning {
+    namespace Detail {
+        // Best of 'rounds' runs, in seconds
+        template <typename Work>
+        double bestTime(Work&& work, size_t rounds = 5) {
+            double best { std::numeric_limits<double>::max() };
+            for (size_t round { 0 }; round < rounds; ++round) {
+                const auto start { std::chrono::steady_clock::now() };
+                work();
+                best = std::min(best, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+            }
+            return best;
+        }
+
+        Async::Task<long long int> decodeOn(Async::Batcher& batcher, const Key::CRT& crtKey, long long int c) {
+            co_return co_await Async::asyncDecode(crtKey, c, batcher);
+        }
+    }
+
+    Profile autotune(std::ostream& log) {
+        Profile profile {};
+        std::mt19937_64 random { 2024 };
+        volatile long long int sink {};
+
+        // Window width: exponents and moduli of the sizes decode() sees, 31 bits with CRT keys and 62 bits without
+        std::vector<std::array<long long int, 3>> powers(4000);
+        for (size_t i { 0 }; i < powers.size(); ++i) {
+            const int bits { i % 2 == 0 ? 31 : 62 };
+            const long long int top { 1LL << (bits - 1) };
+            const long long int modulus { (top | static_cast<long long int>(random() % static_cast<unsigned long long int>(top))) | 1 };
+            powers[i] = { static_cast<long long int>(random() % static_cast<unsigned long long int>(modulus)), top | static_cast<long long int>(random() % static_cast<unsigned long long int>(top)), modulus };
+        }
+
+        double bestWindow { std::numeric_limits<double>::max() };
+        for (size_t windowBits { 1 }; windowBits <= maxWindowBits; ++windowBits) {
+            const double seconds { Detail::bestTime([&] {
+                for (const auto& [x, exponent, modulus] : powers)
+                    sink = sink + Utility::Math::modPower(x, exponent, modulus, windowBits);
+            }) };
+            log << "windowBits " << windowBits << ": " << seconds * 1e9 / static_cast<double>(powers.size()) << " ns per modPower\n";
+            if (seconds < bestWindow) {
+                bestWindow = seconds;
+                profile.windowBits = windowBits;
+            }
+        }
+
+        // Batch hashing: one message at a time against SIMD lanes, on a burst of short messages
+        std::vector<Utility::Bytes> messages(256, Utility::Bytes(64));
+        for (Utility::Bytes& message : messages)
+            Utility::Random::fill(message);
+
+        const double serial { Detail::bestTime([&] { sink = sink + Hash::sha256Batch(messages, HashBatch::Serial)[0][0]; }) };
+        const double lanes { Detail::bestTime([&] { sink = sink + Hash::sha256Batch(messages, HashBatch::Lanes)[0][0]; }) };
+        log << "hashBatch serial: " << serial * 1e9 / static_cast<double>(messages.size()) << " ns per message, lanes: "
+            << lanes * 1e9 / static_cast<double>(messages.size()) << " ns per message\n";
+        profile.hashBatch = serial <= lanes ? HashBatch::Serial : HashBatch::Lanes;
+
+        // Async batch size: many coroutines awaiting a decode at once
+        const long long int p { 1000003 }, q { 1000033 };
+        const Key::CRT crtKey { *Generate::crt(Key::Private { p, q, *Utility::Math::modInverse(65537, (p - 1) * (q - 1)) }) };
+
+        double bestBatch { std::numeric_limits<double>::max() };
+        for (const size_t batchSize : { 16, 64, 256, 1024 }) {
+            Async::Batcher batcher { Concurrency::defaultPool(), batchSize };
+            const double seconds { Detail::bestTime([&] {
+                std::vector<Async::Task<long long int>> tasks {};
+                for (long long int c { 1 }; c <= 8192; ++c)
+                    tasks.push_back(Detail::decodeOn(batcher, crtKey, c));
+                sink = sink + Async::waitAll(std::move(tasks)).back();
+            }) };
+            log << "asyncBatchSize " << batchSize << ": " << seconds * 1e9 / 8192 << " ns per operation\n";
+            if (seconds < bestBatch) {
+                bestBatch = seconds;
+                profile.asyncBatchSize = batchSize;
+            }
+        }
+
+        return profile;
+    }
+}
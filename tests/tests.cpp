@@ -0,0 +1,1224 @@
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <optional>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined(__unix__)
+#include <fcntl.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+#include "rsa/async.hpp"
+#include "rsa/cache.hpp"
+#include "rsa/concurrency.hpp"
+#include "rsa/container.hpp"
+#include "rsa/filter.hpp"
+#include "rsa/hash.hpp"
+#include "rsa/hybrid.hpp"
+#include "rsa/ipc.hpp"
+#include "rsa/keystore.hpp"
+#include "rsa/merkle.hpp"
+#include "rsa/padding.hpp"
+#include "rsa/random.hpp"
+#include "rsa/rotation.hpp"
+#include "rsa/rsa.h"
+#include "rsa/rsa.hpp"
+#include "rsa/table.hpp"
+#include "rsa/tuning.hpp"
+
+// Checks of the library's public API, run by ctest. Every failed check is printed and the exit code is the failure count
+
+namespace {
+    int failures { 0 };
+
+    void check(bool condition, const char* expression, int line) {
+        if (condition)
+            return;
+        std::cerr << "tests.cpp:" << line << ": check failed: " << expression << '\n';
+        ++failures;
+    }
+
+    struct KeyPair {
+        Key::Public publicKey {};
+        Key::Private privateKey {};
+    };
+
+    KeyPair makeKeys(long long int p, long long int q, long long int e = 65537) {
+        const long long int d { Utility::Math::modInverse(e, (p - 1) * (q - 1)).value() };
+        return KeyPair { Key::Public { p * q, e }, Key::Private { p, q, d } };
+    }
+
+    // One 1024 bit key pair for the checks that need a modulus wide enough for the paddings, generated on first use
+    const Generate::WideKeyPair& wideKeys() {
+        static const Generate::WideKeyPair pair { Generate::randomWideKeyPair(1024).value() };
+        return pair;
+    }
+
+    // A fresh directory for the files a test writes, removed at the end of the run
+    const std::filesystem::path& scratchDirectory() {
+        static const std::filesystem::path directory { [] {
+            std::filesystem::path path { std::filesystem::temp_directory_path() / ("rsa-tests-" + std::to_string(std::random_device {}())) };
+            std::filesystem::create_directories(path);
+            return path;
+        }() };
+        return directory;
+    }
+}
+
+#define CHECK(condition) check((condition), #condition, __LINE__)
+
+// Counts the allocations made by any thread while 'isCountingAllocations' is set, for the checks of code that must not allocate
+namespace {
+    std::atomic<bool> isCountingAllocations { false };
+    std::atomic<size_t> allocations { 0 };
+}
+
+void* operator new(std::size_t size) {
+    if (isCountingAllocations.load(std::memory_order_relaxed))
+        allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* memory { std::malloc(size == 0 ? 1 : size) })
+        return memory;
+    throw std::bad_alloc {};
+}
+
+// Not inlined, or GCC takes the free() for a mismatch with the new expressions it is called for
+[[gnu::noinline]] void operator delete(void* memory) noexcept {
+    std::free(memory);
+}
+
+[[gnu::noinline]] void operator delete(void* memory, std::size_t) noexcept {
+    std::free(memory);
+}
+
+void testMath() {
+    CHECK(Utility::Math::isPrime(1019));
+    CHECK(!Utility::Math::isPrime(1021 * 1019));
+    CHECK(Utility::Math::power(3, 4) == 81);
+    CHECK(Utility::Math::power(7, 0) == 1);
+    CHECK(Utility::Math::areCoprimes(7, 3120) && !Utility::Math::areCoprimes(3, 3120) && !Utility::Math::areCoprimes(4, 6));
+
+    // Products above 64 bits
+    const long long int big { 4611686018427387847 };
+    CHECK(Utility::Math::modMultiply(big - 1, big - 1, big) == 1);
+
+    CHECK(Utility::Math::modPower(4, 13, 497) == 445);
+    CHECK(Utility::Math::modPower(5, 0, 1) == 0);
+    CHECK(Utility::Math::modInverse(17, 3120) == 2753);
+    CHECK(!Utility::Math::modInverse(2, 4) && !Utility::Math::modInverse(3, 0));
+
+    std::mt19937_64 random { 7 };
+    for (int i { 0 }; i < 2000; ++i) {
+        const long long int modulus { static_cast<long long int>(random() >> (1 + random() % 62)) | 1 };
+        const long long int x { static_cast<long long int>(random() >> 1) };
+        const long long int exponent { static_cast<long long int>(random() >> (1 + random() % 63)) };
+        const long long int expected { Utility::Math::modPower(x, exponent, modulus, 1) };
+        for (size_t windowBits { 2 }; windowBits <= Tuning::maxWindowBits; ++windowBits)
+            CHECK(Utility::Math::modPower(x, exponent, modulus, windowBits) == expected);
+    }
+}
+
+void testBigNum() {
+    using BigNum::Integer;
+
+    const Utility::Bytes bytes { 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b };
+    const Integer x { Integer::fromBytes(bytes) };
+    CHECK(x.bitLength() == 81 && x.byteLength() == 11 && x.limbs().size() == 2);
+    CHECK(x.toBytes(11) == bytes && !x.toBytes(10) && !x.toInteger());
+    CHECK(x.toBytes(13) == Utility::Bytes({ 0, 0, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b }));
+    CHECK(Integer::fromBytes({ 0, 0, 0xff }) == Integer { 255 } && Integer { 255 }.toInteger() == 255);
+    CHECK(Integer::fromBytes({}).isZero() && Integer {}.toBytes(2) == Utility::Bytes(2, 0));
+
+    // Multi-limb arithmetic checked against itself: (a * b + r) / b == a and % b == r for any r < b
+    std::mt19937_64 random { 11 };
+    const auto draw = [&](size_t limbs) {
+        Integer n {};
+        for (size_t i { 0 }; i < limbs; ++i)
+            n = (n << 64) + Integer { random() >> (random() % 64) };
+        return n;
+    };
+    for (int i { 0 }; i < 300; ++i) {
+        const Integer a { draw(1 + random() % 8) };
+        Integer b { draw(1 + random() % 6) };
+        if (b.isZero())
+            b = Integer { 1 };
+        const Integer r { draw(1 + random() % 6) % b };
+        const auto [quotient, rest] { BigNum::divide(a * b + r, b) };
+        CHECK(quotient == a && rest == r);
+        CHECK((a + b) - b == a && ((a << 77) >> 77) == a);
+    }
+
+    // Modular powers against the long long int ones, odd (Montgomery) and even moduli
+    for (int i { 0 }; i < 500; ++i) {
+        const long long int modulus { std::max(static_cast<long long int>(random() >> (1 + random() % 62)), 2LL) };
+        const long long int base { static_cast<long long int>(random() >> 1) };
+        const long long int exponent { static_cast<long long int>(random() >> (1 + random() % 63)) };
+        const Integer power { BigNum::modPower(Integer { static_cast<unsigned long long int>(base) }, Integer { static_cast<unsigned long long int>(exponent) }, Integer { static_cast<unsigned long long int>(modulus) }) };
+        CHECK(power.toInteger() == Utility::Math::modPower(base, exponent, modulus));
+    }
+
+    // 2^127 - 1 is prime, multiplied by 2^61 - 1 it isn't; 561 is a Carmichael number
+    const Integer m127 { (Integer { 1 } << 127) - Integer { 1 } };
+    const Integer m61 { (Integer { 1 } << 61) - Integer { 1 } };
+    CHECK(BigNum::millerRabin(m127, 8) && BigNum::millerRabin(m61, 8) && BigNum::millerRabin(Integer { 2 }, 1));
+    CHECK(!BigNum::millerRabin(m127 * m61, 8) && !BigNum::millerRabin(Integer { 561 }, 8) && !BigNum::millerRabin(Integer { 1 }, 1));
+    // Fermat's little theorem with a Montgomery modulus of two limbs
+    CHECK(BigNum::modPower(x, m127 - Integer { 1 }, m127) == Integer { 1 });
+
+    const Integer inverse { BigNum::modInverse(x, m127).value_or(Integer {}) };
+    CHECK((x * inverse) % m127 == Integer { 1 });
+    CHECK(BigNum::modInverse(Integer { 17 }, Integer { 3120 }) == Integer { 2753 });
+    CHECK(!BigNum::modInverse(Integer { 6 }, Integer { 9 }) && !BigNum::modInverse(Integer { 3 }, Integer { 1 }));
+
+    CHECK(BigNum::random(100).bitLength() <= 100 && BigNum::remainder(x, 1000) == BigNum::divide(x, Integer { 1000 }).second.toInteger());
+}
+
+void testEncodeDecode() {
+    for (const KeyPair& pair : { makeKeys(61, 53, 17), makeKeys(1021, 1019), makeKeys(2147483647, 2147483629) }) {
+        const Key::CRT crtKey { Generate::crt(pair.privateKey).value() };
+        CHECK(crtKey.p * crtKey.q == pair.publicKey.n);
+
+        std::mt19937_64 random { static_cast<unsigned long long int>(pair.publicKey.n) };
+        for (int i { 0 }; i < 500; ++i) {
+            const long long int m { static_cast<long long int>(random() % static_cast<unsigned long long int>(pair.publicKey.n)) };
+            const long long int c { encode(pair.publicKey, m) };
+            CHECK(c < pair.publicKey.n);
+            CHECK(decode(pair.publicKey, pair.privateKey, c) == m);
+            CHECK(decode(crtKey, c) == m);
+        }
+    }
+
+    // The textbook example
+    CHECK(encode(Key::Public { 3233, 17 }, 65) == 2790);
+    CHECK(decode(Key::Public { 3233, 17 }, Key::Private { 61, 53, 2753 }, 2790) == 65);
+
+    // q has no inverse modulo p when they are equal, or when a factor is below 2
+    CHECK(!Generate::crt(Key::Private { 61, 61, 17 }) && !Generate::crt(Key::Private { 1, 53, 17 }) && !Generate::crt(Key::Private { 6, 9, 5 }));
+}
+
+void testTable() {
+    const KeyPair pair { makeKeys(1021, 1019) };
+    const std::optional<Table::Tables> tables { Table::build(pair.publicKey, pair.privateKey) };
+    CHECK(tables.has_value());
+    if (tables) {
+        bool isConsistent { true };
+        for (long long int m { 0 }; m < pair.publicKey.n; ++m) {
+            const std::optional<long long int> c { Table::encode(*tables, m) };
+            isConsistent = isConsistent && c == encode(pair.publicKey, m) && Table::decode(*tables, *c) == m;
+        }
+        CHECK(isConsistent);
+        CHECK(!Table::encode(*tables, -1) && !Table::encode(*tables, pair.publicKey.n) && !Table::decode(*tables, pair.publicKey.n));
+    }
+
+    // Past maxModulus the tables would take too much memory
+    const KeyPair big { makeKeys(1000003, 1000033) };
+    CHECK(!Table::build(big.publicKey, big.privateKey));
+}
+
+void testFiles() {
+    const KeyPair pair { makeKeys(1021, 1019) };
+    const std::string publicFilename { (scratchDirectory() / "publickey.txt").string() };
+    const std::string privateFilename { (scratchDirectory() / "privatekey.txt").string() };
+
+    CHECK(Utility::File::saveTo(publicFilename, pair.publicKey));
+    CHECK(Utility::File::saveTo(privateFilename, pair.privateKey));
+
+    const std::optional<Key::Public> publicKey { Utility::File::loadPublic(publicFilename) };
+    const std::optional<Key::Private> privateKey { Utility::File::loadPrivate(privateFilename) };
+    CHECK(publicKey && publicKey->n == pair.publicKey.n && publicKey->e == pair.publicKey.e);
+    CHECK(privateKey && privateKey->p == pair.privateKey.p && privateKey->q == pair.privateKey.q && privateKey->d == pair.privateKey.d);
+
+    CHECK(!Utility::File::loadPublic((scratchDirectory() / "missing.txt").string()));
+    CHECK(!Utility::File::loadPublic(privateFilename));
+
+    const std::string unwritableFilename { (scratchDirectory() / "missing" / "publickey.txt").string() };
+    CHECK(!Utility::File::saveTo(unwritableFilename, pair.publicKey) && !Utility::File::saveTo(unwritableFilename, pair.privateKey));
+}
+
+void testTuning() {
+    const std::string filename { (scratchDirectory() / "tuning.txt").string() };
+
+    Tuning::Profile profile {};
+    profile.windowBits = 4;
+    profile.hashBatch = Tuning::HashBatch::Lanes;
+    profile.asyncBatchSize = 64;
+    CHECK(Tuning::save(filename, profile));
+
+    const std::optional<Tuning::Profile> loaded { Tuning::load(filename) };
+    CHECK(loaded && loaded->windowBits == 4 && loaded->hashBatch == Tuning::HashBatch::Lanes && loaded->asyncBatchSize == 64);
+    CHECK(!Tuning::load((scratchDirectory() / "missing.txt").string()));
+
+    // Negative numbers and trailing characters are refused instead of wrapping around or being cut short
+    for (const char* const setting : { "windowBits: -1", "windowBits: 12abc", "asyncBatchSize: -1", "asyncBatchSize: 99999999999999999999999", "hashBatch: wide" }) {
+        const std::string malformedFilename { (scratchDirectory() / "malformed.txt").string() };
+        {
+            std::ofstream file { malformedFilename };
+            file << setting << '\n';
+        }
+        CHECK(!Tuning::load(malformedFilename));
+    }
+
+    // Nothing is read from the current directory, the defaults stay until a profile is handed over
+    CHECK(Tuning::current().windowBits == Tuning::Profile {}.windowBits && Tuning::current().asyncBatchSize == Tuning::Profile {}.asyncBatchSize);
+    Tuning::use(loaded.value_or(profile));
+    CHECK(Tuning::current().windowBits == 4 && Tuning::current().hashBatch == Tuning::HashBatch::Lanes);
+    CHECK(encode(Key::Public { 3233, 17 }, 65) == 2790);
+    Tuning::use(Tuning::Profile {});
+    CHECK(Tuning::current().windowBits == Tuning::Profile {}.windowBits);
+}
+
+void testContainer() {
+    const KeyPair pair { makeKeys(1000003, 1000033) };
+    const KeyPair otherPair { makeKeys(1021, 1019) };
+
+    std::string plaintext(100000, '\0');
+    std::mt19937_64 random { 3 };
+    for (char& byte : plaintext)
+        byte = static_cast<char>(random());
+
+    std::stringstream encrypted {};
+    {
+        std::istringstream in { plaintext };
+        CHECK(Container::write(pair.publicKey, in, encrypted, 1000));
+    }
+
+    std::ostringstream decrypted {};
+    encrypted.seekg(0);
+    CHECK(Container::read(pair.publicKey, pair.privateKey, encrypted, decrypted));
+    CHECK(decrypted.str() == plaintext);
+
+    std::ostringstream wrongKey {};
+    encrypted.seekg(0);
+    CHECK(!Container::read(otherPair.publicKey, otherPair.privateKey, encrypted, wrongKey));
+
+    // Block counts whose offsets overflow, or whose index can't fit in the stream, are refused before allocating the index
+    for (const char* const blockCount : { "\xff\xff\xff\xff\xff\xff\xff\xff", "\x00\x00\xff\xff\xff\xff\xff\xff" }) {
+        std::string damaged { encrypted.str() };
+        damaged.replace(44, 8, blockCount, 8);
+        std::istringstream damagedIn { damaged };
+        std::ostringstream ignored {};
+        CHECK(!Container::read(pair.publicKey, pair.privateKey, damagedIn, ignored));
+    }
+
+    // An empty container reads back as nothing, and a block size past maxBlockSize is refused even when no block follows
+    std::stringstream empty {};
+    {
+        std::istringstream in {};
+        CHECK(Container::write(pair.publicKey, in, empty));
+        CHECK(!Container::write(pair.publicKey, in, empty, Container::maxBlockSize + 1));
+    }
+    std::ostringstream emptyDecrypted {};
+    empty.seekg(0);
+    CHECK(Container::read(pair.publicKey, pair.privateKey, empty, emptyDecrypted));
+    CHECK(emptyDecrypted.str().empty());
+
+    std::string hugeBlocks { empty.str() };
+    hugeBlocks.replace(40, 4, "\xff\xff\xff\xff", 4);
+    std::istringstream hugeBlocksIn { hugeBlocks };
+    std::ostringstream ignored {};
+    CHECK(!Container::read(pair.publicKey, pair.privateKey, hugeBlocksIn, ignored));
+
+#if defined(__unix__)
+    const std::string containerFilename { (scratchDirectory() / "data.rsac").string() };
+    {
+        std::ofstream file { containerFilename, std::ios::binary };
+        file << encrypted.str();
+    }
+
+    const auto readFile { [](const std::string& filename) {
+        std::ifstream file { filename, std::ios::binary };
+        return std::string { std::istreambuf_iterator<char> { file }, std::istreambuf_iterator<char> {} };
+    } };
+
+    const std::string threadedFilename { (scratchDirectory() / "threaded.bin").string() };
+    CHECK(Container::decryptFile(pair.publicKey, pair.privateKey, containerFilename, threadedFilename, 3));
+    CHECK(readFile(threadedFilename) == plaintext);
+
+    const std::string rangeFilename { (scratchDirectory() / "range.bin").string() };
+    CHECK(Container::decryptFile(pair.publicKey, pair.privateKey, containerFilename, rangeFilename, 2, std::pair { 1234ULL, 56789ULL }));
+    CHECK(readFile(rangeFilename) == plaintext.substr(1234, 56789 - 1234));
+
+    const std::string shardedFilename { (scratchDirectory() / "sharded.bin").string() };
+    CHECK(Container::decryptFileSharded(pair.publicKey, pair.privateKey, containerFilename, shardedFilename, 3));
+    CHECK(readFile(shardedFilename) == plaintext);
+#endif
+
+#if defined(__linux__)
+    // Segments of 3 blocks of 1000 bytes never start on an aligned offset, so every write is split into direct and buffered parts
+    const std::string plaintextFilename { (scratchDirectory() / "plain.bin").string() };
+    {
+        std::ofstream file { plaintextFilename, std::ios::binary };
+        file << plaintext;
+    }
+    const std::string asyncContainerFilename { (scratchDirectory() / "async.rsac").string() };
+    CHECK(Container::encryptFileAsync(pair.publicKey, plaintextFilename, asyncContainerFilename, 1000, 4, 3));
+    std::istringstream asyncContainer { readFile(asyncContainerFilename) };
+    std::ostringstream asyncDecrypted {};
+    CHECK(Container::read(pair.publicKey, pair.privateKey, asyncContainer, asyncDecrypted));
+    CHECK(asyncDecrypted.str() == plaintext);
+
+    for (const bool useDirectIO : { true, false }) {
+        const std::string asyncFilename { (scratchDirectory() / "async.bin").string() };
+        CHECK(Container::decryptFileAsync(pair.publicKey, pair.privateKey, asyncContainerFilename, asyncFilename, 4, 5, useDirectIO, 2));
+        CHECK(readFile(asyncFilename) == plaintext);
+    }
+
+    CHECK(!Container::encryptFileAsync(pair.publicKey, plaintextFilename, asyncContainerFilename, 0));
+    CHECK(!Container::decryptFileAsync(otherPair.publicKey, otherPair.privateKey, asyncContainerFilename, (scratchDirectory() / "wrong.bin").string()));
+#endif
+}
+
+void testFilter() {
+#if defined(__unix__)
+    // Runs 'filter' with 'input' on stdin, returns what it wrote to stdout and whether it succeeded
+    const auto runFiltered { [](const std::string& input, const auto& filter) {
+        const std::string inputFilename { (scratchDirectory() / "filter-in.bin").string() };
+        const std::string outputFilename { (scratchDirectory() / "filter-out.bin").string() };
+        std::ofstream { inputFilename, std::ios::binary } << input;
+
+        std::cout.flush();
+        const int savedIn { ::dup(STDIN_FILENO) }, savedOut { ::dup(STDOUT_FILENO) };
+        const int in { ::open(inputFilename.c_str(), O_RDONLY) };
+        const int out { ::open(outputFilename.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644) };
+        ::dup2(in, STDIN_FILENO);
+        ::dup2(out, STDOUT_FILENO);
+        ::close(in);
+        ::close(out);
+
+        const bool isSuccessful { filter() };
+
+        ::dup2(savedIn, STDIN_FILENO);
+        ::dup2(savedOut, STDOUT_FILENO);
+        ::close(savedIn);
+        ::close(savedOut);
+
+        std::ifstream file { outputFilename, std::ios::binary };
+        return std::pair { isSuccessful, std::string { std::istreambuf_iterator<char> { file }, std::istreambuf_iterator<char> {} } };
+    } };
+
+    const KeyPair pair { makeKeys(1000003, 1000033) };
+    std::string plaintext(300000, '\0');
+    std::mt19937_64 random { 9 };
+    for (char& byte : plaintext)
+        byte = static_cast<char>(random());
+
+    const auto [isEncrypted, frames] { runFiltered(plaintext, [&] { return Filter::encrypt(pair.publicKey, 3, 1000); }) };
+    CHECK(isEncrypted);
+    const auto [isDecrypted, decrypted] { runFiltered(frames, [&] { return Filter::decrypt(pair.publicKey, pair.privateKey, 3); }) };
+    CHECK(isDecrypted && decrypted == plaintext);
+
+    // A one byte modulus has no room for a chunk, and block sizes above the cap are refused before any frame is allocated
+    const KeyPair tiny { makeKeys(13, 11, 7) };
+    CHECK(!runFiltered(plaintext, [&] { return Filter::encrypt(tiny.publicKey, 1); }).first);
+    CHECK(!runFiltered(std::string { "RSAF\x01\x00\x00\x10\x00", 9 }, [&] { return Filter::decrypt(tiny.publicKey, tiny.privateKey, 1); }).first);
+    CHECK(!runFiltered(plaintext, [&] { return Filter::encrypt(pair.publicKey, 1, Filter::maxBlockSize + 1); }).first);
+    std::string oversized { frames.substr(0, 9) };
+    oversized.replace(5, 4, "\xff\xff\xff\xff");
+    CHECK(!runFiltered(oversized, [&] { return Filter::decrypt(pair.publicKey, pair.privateKey, 1); }).first);
+#endif
+}
+
+void testRotation() {
+#if defined(__unix__)
+    const KeyPair oldPair { makeKeys(1000003, 1000033) };
+    const KeyPair newPair { makeKeys(2147483647, 2147483629) };
+    const auto path { [](const char* name) { return (scratchDirectory() / name).string(); } };
+    const auto readFile { [](const std::string& filename) {
+        std::ifstream file { filename, std::ios::binary };
+        return std::string { std::istreambuf_iterator<char> { file }, std::istreambuf_iterator<char> {} };
+    } };
+
+    std::string plaintext(50000, '\0');
+    std::mt19937_64 random { 11 };
+    for (char& byte : plaintext)
+        byte = static_cast<char>(random());
+    const auto writeContainer { [&](const std::string& filename) {
+        std::istringstream in { plaintext };
+        std::ofstream out { filename, std::ios::binary };
+        return Container::write(oldPair.publicKey, in, out, 1000);
+    } };
+
+    Rotation::Job job {};
+    job.files = { { path("rotate-a.rsac"), path("rotate-a2.rsac") }, { path("rotate-b.rsac"), path("rotate-b2.rsac") } };
+    job.checkpointFilename = path("rotate.checkpoint");
+    job.threadCount = 2;
+    job.segmentBlocks = 7;
+    CHECK(writeContainer(job.files[0].first));
+
+    // The second container is missing: the job stops after the first one and its checkpoint stays behind
+    CHECK(!Rotation::reencrypt(oldPair.publicKey, oldPair.privateKey, newPair.publicKey, job));
+    CHECK(std::filesystem::exists(job.checkpointFilename));
+
+    // Resumed: the first container isn't read again, so removing it doesn't matter
+    std::filesystem::remove(job.files[0].first);
+    CHECK(writeContainer(job.files[1].first));
+    CHECK(Rotation::reencrypt(oldPair.publicKey, oldPair.privateKey, newPair.publicKey, job));
+    CHECK(!std::filesystem::exists(job.checkpointFilename));
+
+    for (const auto& [input, output] : job.files) {
+        std::istringstream rotated { readFile(output) };
+        std::ostringstream decrypted {};
+        CHECK(Container::read(newPair.publicKey, newPair.privateKey, rotated, decrypted));
+        CHECK(decrypted.str() == plaintext);
+    }
+
+    // A new key too short for containers, or the wrong old key, is refused
+    Rotation::Job tinyJob { job };
+    tinyJob.files = { { job.files[1].first, path("rotate-tiny.rsac") } };
+    CHECK(!Rotation::reencrypt(oldPair.publicKey, oldPair.privateKey, Key::Public { 143, 7 }, tinyJob));
+    CHECK(!Rotation::reencrypt(newPair.publicKey, newPair.privateKey, oldPair.publicKey, tinyJob));
+#endif
+}
+
+void testCInterface() {
+    const KeyPair pair { makeKeys(1000003, 1000033) };
+
+    rsa_public_key* publicKey { nullptr };
+    rsa_private_key* privateKey { nullptr };
+    CHECK(rsa_public_key_create(pair.publicKey.n, pair.publicKey.e, &publicKey) == RSA_OK);
+    CHECK(rsa_private_key_create(pair.privateKey.p, pair.privateKey.q, pair.privateKey.d, &privateKey) == RSA_OK);
+    CHECK(rsa_public_key_size(publicKey) == 5);
+
+    // Long enough to go through the thread pool, then again on the calling thread
+    std::vector<int64_t> messages(1000), ciphertexts(1000), decoded(1000);
+    for (size_t i { 0 }; i < messages.size(); ++i)
+        messages[i] = static_cast<int64_t>(i * 7919 + 2);
+
+    for (const size_t threadCount : { 2, 0 }) {
+        CHECK(rsa_thread_pool_configure(threadCount, 0) == RSA_OK);
+        CHECK(rsa_thread_pool_size() == threadCount);
+
+        // Textbook batches allocate nothing, whether they are split over the pool or not
+        allocations = 0;
+        isCountingAllocations = true;
+        const rsa_status encoded { rsa_encode_batch(publicKey, messages.data(), ciphertexts.data(), messages.size()) };
+        const rsa_status decodedStatus { rsa_decode_batch(privateKey, ciphertexts.data(), decoded.data(), ciphertexts.size()) };
+        isCountingAllocations = false;
+        CHECK(encoded == RSA_OK && decodedStatus == RSA_OK && allocations == 0);
+
+        CHECK(decoded == messages);
+        CHECK(ciphertexts[1] == encode(pair.publicKey, messages[1]));
+    }
+    CHECK(rsa_thread_pool_configure(1, 1) == RSA_OK && rsa_thread_pool_size() == 1);
+    CHECK(rsa_encode_batch(publicKey, messages.data(), ciphertexts.data(), messages.size()) == RSA_OK);
+    CHECK(rsa_thread_pool_configure(2, 0) == RSA_OK);
+
+    const int64_t tooLarge { pair.publicKey.n };
+    int64_t output {};
+    CHECK(rsa_encode_batch(publicKey, &tooLarge, &output, 1) == RSA_ERROR_INVALID_INPUT);
+    CHECK(rsa_encode_batch(nullptr, messages.data(), ciphertexts.data(), 1) == RSA_ERROR_INVALID_ARGUMENT);
+
+    // The padding schemes need a modulus of at least 11 bytes, refused instead of asserting
+    const uint8_t digests[RSA_DIGEST_SIZE] {};
+    uint8_t signature[8] {};
+    const size_t length { 1 };
+    CHECK(rsa_sign_batch(privateKey, RSA_SIGNATURE_PKCS1, digests, 1, signature) == RSA_ERROR_KEY_TOO_SMALL);
+    CHECK(rsa_encrypt_batch(publicKey, RSA_PADDING_PKCS1, digests, 1, &length, 1, signature) == RSA_ERROR_KEY_TOO_SMALL);
+    CHECK(rsa_private_key_size(privateKey) == 5);
+
+    rsa_public_key_free(publicKey);
+    rsa_private_key_free(privateKey);
+
+    const std::string publicFilename { (scratchDirectory() / "c-publickey.txt").string() };
+    CHECK(Utility::File::saveTo(publicFilename, pair.publicKey));
+    CHECK(rsa_public_key_load(publicFilename.c_str(), &publicKey) == RSA_OK);
+    CHECK(rsa_public_key_size(publicKey) == 5);
+    rsa_public_key_free(publicKey);
+    CHECK(rsa_private_key_load((scratchDirectory() / "missing.txt").c_str(), &privateKey) == RSA_ERROR_IO);
+    CHECK(rsa_private_key_create(1000003, 1000003, 3, &privateKey) == RSA_ERROR_INVALID_ARGUMENT);
+
+    // Composite factors and a d sharing a factor with (p - 1) * (q - 1) are refused before the CRT values are computed
+    CHECK(rsa_private_key_create(6, 35, 5, &privateKey) == RSA_ERROR_INVALID_ARGUMENT);
+    CHECK(rsa_private_key_create(1000003, 1000001, pair.privateKey.d, &privateKey) == RSA_ERROR_INVALID_ARGUMENT);
+    CHECK(rsa_private_key_create(pair.privateKey.p, pair.privateKey.q, 2, &privateKey) == RSA_ERROR_INVALID_ARGUMENT);
+
+    // Wide keys, generated or from big-endian numbers, encrypt and sign through the pool
+    rsa_public_key* widePublic { nullptr };
+    rsa_private_key* widePrivate { nullptr };
+    CHECK(rsa_key_pair_generate(1000, &widePublic, &widePrivate) == RSA_ERROR_INVALID_ARGUMENT);
+    CHECK(rsa_key_pair_generate(1024, &widePublic, &widePrivate) == RSA_OK);
+    CHECK(rsa_public_key_size(widePublic) == 128 && rsa_private_key_size(widePrivate) == 128);
+
+    constexpr size_t count { 100 }, stride { 40 };
+    std::vector<uint8_t> plaintexts(count * stride), ciphertextBytes(count * 128), decrypted(count * stride), valid(count);
+    std::vector<size_t> lengths(count), decryptedLengths(count);
+    for (size_t i { 0 }; i < count; ++i) {
+        lengths[i] = i % (stride + 1);
+        for (size_t j { 0 }; j < lengths[i]; ++j)
+            plaintexts[i * stride + j] = static_cast<uint8_t>(i + j);
+    }
+    for (const rsa_padding padding : { RSA_PADDING_OAEP, RSA_PADDING_PKCS1 }) {
+        CHECK(rsa_encrypt_batch(widePublic, padding, plaintexts.data(), stride, lengths.data(), count, ciphertextBytes.data()) == RSA_OK);
+        ciphertextBytes[5 * 128 + 60] ^= 1;
+        CHECK(rsa_decrypt_batch(widePrivate, padding, ciphertextBytes.data(), count, decrypted.data(), stride, decryptedLengths.data(), valid.data()) == RSA_OK);
+        bool isDecrypted { true };
+        for (size_t i { 0 }; i < count; ++i)
+            if (i != 5)
+                isDecrypted = isDecrypted && valid[i] == 1 && decryptedLengths[i] == lengths[i]
+                              && std::equal(plaintexts.begin() + static_cast<std::ptrdiff_t>(i * stride), plaintexts.begin() + static_cast<std::ptrdiff_t>(i * stride + lengths[i]), decrypted.begin() + static_cast<std::ptrdiff_t>(i * stride));
+        CHECK(isDecrypted);
+        CHECK(valid[5] == 0 || decryptedLengths[5] != lengths[5] || !std::equal(plaintexts.begin() + 5 * stride, plaintexts.begin() + 5 * stride + static_cast<std::ptrdiff_t>(lengths[5]), decrypted.begin() + 5 * stride));
+    }
+
+    std::vector<uint8_t> wideDigests(count * RSA_DIGEST_SIZE), wideSignatures(count * 128), results(count);
+    for (size_t i { 0 }; i < wideDigests.size(); ++i)
+        wideDigests[i] = static_cast<uint8_t>(i * 31);
+    for (const rsa_signature_scheme scheme : { RSA_SIGNATURE_PKCS1, RSA_SIGNATURE_PSS }) {
+        CHECK(rsa_sign_batch(widePrivate, scheme, wideDigests.data(), count, wideSignatures.data()) == RSA_OK);
+        wideSignatures[7 * 128 + 3] ^= 0x80;
+        CHECK(rsa_verify_batch(widePublic, scheme, wideDigests.data(), wideSignatures.data(), count, results.data()) == RSA_OK);
+        CHECK(std::count(results.begin(), results.end(), 1) == count - 1 && results[7] == 0);
+    }
+    int64_t narrow { 5 };
+    CHECK(rsa_encode_batch(widePublic, &narrow, &narrow, 1) == RSA_ERROR_KEY_TOO_LARGE && rsa_decode_batch(widePrivate, &narrow, &narrow, 1) == RSA_ERROR_KEY_TOO_LARGE);
+    rsa_public_key_free(widePublic);
+    rsa_private_key_free(widePrivate);
+
+    // The handles built from bytes agree with the C++ API
+    const Generate::WideKeyPair& wide { wideKeys() };
+    const Utility::Bytes n { *wide.publicKey.n.toBytes(wide.publicKey.n.byteLength()) }, e { *wide.publicKey.e.toBytes(3) };
+    const Utility::Bytes p { *wide.privateKey.p.toBytes(64) }, q { *wide.privateKey.q.toBytes(64) }, d { *wide.privateKey.d.toBytes(128) };
+    CHECK(rsa_public_key_create_from_bytes(n.data(), n.size(), e.data(), e.size(), &widePublic) == RSA_OK);
+    CHECK(rsa_private_key_create_from_bytes(p.data(), p.size(), q.data(), q.size(), d.data(), d.size(), &widePrivate) == RSA_OK);
+    CHECK(rsa_sign_batch(widePrivate, RSA_SIGNATURE_PKCS1, wideDigests.data(), 1, wideSignatures.data()) == RSA_OK);
+    CHECK(verify(wide.publicKey, Utility::Bytes(wideDigests.begin(), wideDigests.begin() + RSA_DIGEST_SIZE), Utility::Bytes(wideSignatures.begin(), wideSignatures.begin() + 128)));
+    rsa_public_key_free(widePublic);
+    rsa_private_key_free(widePrivate);
+
+    // p * q instead of a prime, p twice, and a missing modulus are refused
+    const Utility::Bytes composite { *(wide.privateKey.p * wide.privateKey.q).toBytes(128) };
+    CHECK(rsa_private_key_create_from_bytes(composite.data(), composite.size(), q.data(), q.size(), d.data(), d.size(), &widePrivate) == RSA_ERROR_INVALID_ARGUMENT);
+    CHECK(rsa_private_key_create_from_bytes(p.data(), p.size(), p.data(), p.size(), d.data(), d.size(), &widePrivate) == RSA_ERROR_INVALID_ARGUMENT);
+    CHECK(rsa_public_key_create_from_bytes(nullptr, 0, e.data(), e.size(), &widePublic) == RSA_ERROR_INVALID_ARGUMENT);
+    CHECK(rsa_public_key_create_from_bytes(nullptr, 4, e.data(), e.size(), &widePublic) == RSA_ERROR_INVALID_ARGUMENT);
+}
+
+void testRandom() {
+    std::vector<unsigned char> first(1000), second(1000);
+    Utility::Random::fill(first.data(), first.size());
+    Utility::Random::fill(second.data(), second.size());
+    CHECK(first != second);
+    CHECK(first != std::vector<unsigned char>(1000, 0));
+
+    // Another thread has its own generator, seeded on its own
+    std::vector<unsigned char> other(1000);
+    std::thread { [&] { Utility::Random::fill(other.data(), other.size()); } }.join();
+    CHECK(other != first && other != second);
+
+    bool isInRange { true };
+    for (int i { 0 }; i < 1000; ++i)
+        isInRange = isInRange && Utility::Random::below(7) < 7;
+    CHECK(isInRange);
+    CHECK(Utility::Random::below(1) == 0);
+
+#if defined(__unix__)
+    // A forked child must not hand out what its parent hands out next, buffered bytes included
+    int descriptors[2] {};
+    CHECK(pipe(descriptors) == 0);
+    const pid_t child { fork() };
+    if (child == 0) {
+        std::uint64_t value { Utility::Random::next() };
+        _exit(write(descriptors[1], &value, sizeof(value)) == sizeof(value) ? 0 : 1);
+    }
+    close(descriptors[1]);
+    std::uint64_t childValue {};
+    const bool isRead { read(descriptors[0], &childValue, sizeof(childValue)) == sizeof(childValue) };
+    close(descriptors[0]);
+    waitpid(child, nullptr, 0);
+    CHECK(isRead && childValue != Utility::Random::next());
+#endif
+}
+
+void testSeededKeys() {
+    bool isSame { true };
+    for (long long int x { 0 }; x < 5000; ++x)
+        isSame = isSame && Utility::Math::millerRabin(x) == (x >= 2 && Utility::Math::isPrime(x));
+    CHECK(isSame);
+    CHECK(!Utility::Math::millerRabin(3215031751));     // Strong pseudoprime to bases 2, 3, 5 and 7
+    CHECK(Utility::Math::millerRabin(2147483647));
+    CHECK(!Utility::Math::millerRabin(2147483647LL * 2147483629LL));
+
+    // The same seed and index give the same key on every machine, pinned here
+    const Generate::KeyPair pair { Generate::fromSeed("fleet seed", 3).value() };
+    CHECK(pair.privateKey.p == 2124864473 && pair.privateKey.q == 2004189119 && pair.privateKey.d == 2486350753506448177);
+    CHECK(pair.publicKey.n == pair.privateKey.p * pair.privateKey.q && pair.publicKey.e == 65537);
+    CHECK(decode(pair.publicKey, pair.privateKey, encode(pair.publicKey, 123456789)) == 123456789);
+    CHECK(Generate::fromSeed("fleet seed", 4).value().publicKey.n != pair.publicKey.n);
+    CHECK(Generate::fromSeed("other seed", 3).value().publicKey.n != pair.publicKey.n);
+
+    const Generate::KeyPair small { Generate::fromSeed("fleet seed", 0, 16).value() };
+    CHECK(Utility::Math::millerRabin(small.privateKey.p) && small.privateKey.p >> 15 == 1);
+
+    // Sizes outside [minPrimeBits, maxPrimeBits] are refused, not generated
+    CHECK(!Generate::fromSeed("fleet seed", 0, Generate::minPrimeBits - 1) && !Generate::fromSeed("fleet seed", 0, Generate::maxPrimeBits + 1));
+    CHECK(Generate::keySetFromSeed("fleet seed", 0, 4, 40).empty());
+
+    const std::vector<Generate::KeyPair> keys { Generate::keySetFromSeed("fleet seed", 0, 200) };
+    CHECK(keys[3].publicKey.n == pair.publicKey.n);
+
+    // The cache is written once, then read back. A damaged file is noticed through its digest and rewritten
+    const std::string filename { (scratchDirectory() / "keyset.txt").string() };
+    const std::string digest { Generate::keySetDigest(keys) };
+    CHECK(Generate::keySetDigest(Generate::cachedKeySet(filename, "fleet seed", 200).value()) == digest);
+    CHECK(Generate::keySetDigest(Generate::cachedKeySet(filename, "fleet seed", 200).value()) == digest);
+
+    const auto readAll = [&] { return (std::ostringstream {} << std::ifstream { filename }.rdbuf()).str(); };
+    const std::string contents { readAll() };
+    std::string damaged { contents };
+    char& digit { damaged[damaged.find("key: ") + 5] };
+    digit = digit == '9' ? '8' : '9';
+    std::ofstream { filename } << damaged;
+    CHECK(Generate::keySetDigest(Generate::cachedKeySet(filename, "fleet seed", 200).value()) == digest);
+    CHECK(readAll() == contents);
+
+    // A cache that can't be written is an error, not a silently lost set
+    CHECK(!Generate::cachedKeySet((scratchDirectory() / "missing" / "keyset.txt").string(), "fleet seed", 2));
+}
+
+namespace {
+    // Largest prime factor of 'x', by trial division
+    long long int largestPrimeFactor(long long int x) {
+        long long int largest { 1 };
+        for (long long int factor { 2 }; factor * factor <= x; ++factor)
+            while (x % factor == 0) {
+                largest = factor;
+                x /= factor;
+            }
+        return x > 1 ? x : largest;
+    }
+}
+
+void testPrimeKinds() {
+    for (const size_t bits : { Generate::minRandomPrimeBits, Generate::maxPrimeBits }) {
+        const long long int prime { Generate::randomPrime(bits).value() };
+        CHECK(Utility::Math::millerRabin(prime) && prime >> (bits - 2) == 3);
+
+        const long long int safe { Generate::randomPrime(bits, Generate::PrimeKind::Safe).value() };
+        CHECK(Utility::Math::millerRabin(safe) && Utility::Math::millerRabin((safe - 1) / 2) && safe >> (bits - 2) == 3);
+
+    }
+
+    // Gordon's structure: r | p - 1, s | p + 1, t | r - 1, with s and t of the promised sizes
+    for (const size_t bits : { Generate::minStrongPrimeBits, Generate::maxPrimeBits }) {
+        const Generate::StrongPrime strong { Generate::randomStrongPrime(bits).value() };
+        CHECK(Utility::Math::millerRabin(strong.p) && strong.p >> (bits - 2) == 3);
+        CHECK(Utility::Math::millerRabin(strong.r) && Utility::Math::millerRabin(strong.s) && Utility::Math::millerRabin(strong.t));
+        CHECK((strong.p - 1) % strong.r == 0 && (strong.p + 1) % strong.s == 0 && (strong.r - 1) % strong.t == 0);
+        CHECK(Utility::Convert::bitLength(strong.s) == bits / 2 - 2 && Utility::Convert::bitLength(strong.t) == bits / 2 - 6);
+
+        const long long int prime { Generate::randomPrime(bits, Generate::PrimeKind::Strong).value() };
+        CHECK(Utility::Math::millerRabin(prime) && largestPrimeFactor(prime - 1) >> (bits / 2 - 6) > 0);
+    }
+
+    CHECK(!Generate::randomPrime(Generate::minRandomPrimeBits - 1) && !Generate::randomPrime(Generate::maxPrimeBits + 1, Generate::PrimeKind::Strong));
+    CHECK(!Generate::randomPrime(Generate::minStrongPrimeBits - 1, Generate::PrimeKind::Strong) && !Generate::randomStrongPrime(Generate::minRandomPrimeBits));
+    CHECK(!Generate::randomKeyPair(Generate::maxPrimeBits + 1) && !Generate::randomKeyPair(Generate::minStrongPrimeBits - 1, Generate::PrimeKind::Strong));
+
+    const Generate::KeyPair pair { Generate::randomKeyPair(Generate::maxPrimeBits, Generate::PrimeKind::Safe).value() };
+    CHECK(Utility::Math::millerRabin((pair.privateKey.p - 1) / 2) && Utility::Math::millerRabin((pair.privateKey.q - 1) / 2));
+    CHECK(decode(pair.publicKey, pair.privateKey, encode(pair.publicKey, 987654321)) == 987654321);
+}
+
+void testHash() {
+    const auto bytes { [](const std::string& text) { return Utility::Bytes(text.begin(), text.end()); } };
+
+    // FIPS 180-2 examples
+    CHECK(Utility::Convert::toHex(Hash::sha256({})) == "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855");
+    CHECK(Utility::Convert::toHex(Hash::sha256(bytes("abc"))) == "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad");
+    CHECK(Utility::Convert::toHex(Hash::sha256(bytes("abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq")))
+          == "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1");
+
+    std::vector<Utility::Bytes> messages {};
+    std::mt19937_64 random { 11 };
+    for (size_t length { 0 }; length < 300; length += 7) {
+        Utility::Bytes message(length);
+        for (unsigned char& byte : message)
+            byte = static_cast<unsigned char>(random());
+        messages.push_back(std::move(message));
+    }
+
+    // Pieces of every size give the digest of the whole message
+    const Utility::Bytes& longest { messages.back() };
+    Hash::SHA256 hash {};
+    for (size_t done { 0 }, piece { 1 }; done < longest.size(); done += piece, ++piece)
+        hash.update(longest.data() + done, std::min(piece, longest.size() - done));
+    CHECK(hash.finish() == Hash::sha256(longest));
+
+    // Every path of the batch hash, the SIMD lanes forced even where SHA-NI is faster, against one message at a time
+    // Empty messages, and lengths around the 55/56 and 64 byte padding boundaries, end up in the same groups as long ones
+    for (const size_t length : { 0, 0, 1, 55, 56, 63, 64, 65, 119, 120, 128 })
+        messages.push_back(Utility::Bytes(length, static_cast<unsigned char>(length)));
+    for (const Tuning::HashBatch hashBatch : { Tuning::HashBatch::Auto, Tuning::HashBatch::Serial, Tuning::HashBatch::Lanes }) {
+        const std::vector<Utility::Bytes> digests { Hash::sha256Batch(messages, hashBatch) };
+        bool isSame { digests.size() == messages.size() };
+        for (size_t i { 0 }; isSame && i < messages.size(); ++i)
+            isSame = digests[i] == Hash::sha256(messages[i]);
+        CHECK(isSame);
+    }
+    CHECK(Hash::sha256Batch(std::vector<Utility::Bytes>(9), Tuning::HashBatch::Lanes) == std::vector<Utility::Bytes>(9, Hash::sha256({})));
+
+    const KeyPair pair { makeKeys(1021, 1019) };
+    CHECK(Hash::fingerprint(pair.publicKey).size() == Hash::SHA256::digestSize);
+    CHECK(Hash::fingerprint(pair.publicKey) != Hash::fingerprint(makeKeys(1031, 1033).publicKey));
+}
+
+void testPadding() {
+    // The keys of this library are at most 8 bytes long, too short for any padding, so the encodings are checked on their own
+    const Utility::Bytes message { 'p', 'a', 'd', 'd', 'e', 'd' };
+
+    CHECK(Utility::Convert::toInteger({ 0x00, 0x7f, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff }) == 0x7fffffffffffffff);
+    CHECK(!Utility::Convert::toInteger({ 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 }));
+    CHECK(!Utility::Convert::toInteger({ 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 }));
+    CHECK(Utility::Convert::toInteger({}) == 0);
+
+    const Utility::Bytes oaep { Padding::OAEP::encode(message, 128).value_or(Utility::Bytes {}) };
+    CHECK(oaep.size() == 128 && oaep[0] == 0x00);
+    CHECK(Padding::OAEP::decode(oaep) == message);
+    Utility::Bytes damaged { oaep };
+    damaged[40] ^= 1;
+    CHECK(!Padding::OAEP::decode(damaged));
+
+    const Utility::Bytes pkcs1 { Padding::PKCS1::encode(message, 64).value_or(Utility::Bytes {}) };
+    CHECK(pkcs1.size() == 64 && pkcs1[0] == 0x00 && pkcs1[1] == 0x02);
+    CHECK(Padding::PKCS1::decode(pkcs1) == message);
+    CHECK(Padding::PKCS1::encode({}, 11) && Padding::OAEP::encode({}, 66));
+
+    // Blocks too short for the padding, or messages too long for the block, are refused
+    CHECK(!Padding::OAEP::encode(message, 65) && !Padding::OAEP::encode(Utility::Bytes(63), 128));
+    CHECK(!Padding::PKCS1::encode({}, 10) && !Padding::PKCS1::encode(Utility::Bytes(54), 64));
+
+    // Padded encryption end to end with a wide key, OAEP and PKCS1
+    const Generate::WideKeyPair& wide { wideKeys() };
+    const Key::Wide::CRT wideCrt { Generate::crt(wide.privateKey).value() };
+    CHECK(wide.publicKey.n.bitLength() == 1024 && wideCrt.p * wideCrt.q == wide.publicKey.n);
+    for (const Padding::Scheme scheme : { Padding::Scheme::OAEP, Padding::Scheme::PKCS1 }) {
+        const Utility::Bytes ciphertext { encrypt(wide.publicKey, message, scheme).value_or(Utility::Bytes {}) };
+        CHECK(ciphertext.size() == 128);
+        CHECK(decrypt(wideCrt, ciphertext, scheme) == message && decrypt(wide.privateKey, ciphertext, scheme) == message);
+        CHECK(encrypt(wide.publicKey, {}, scheme) && decrypt(wideCrt, *encrypt(wide.publicKey, {}, scheme), scheme) == Utility::Bytes {});
+
+        Utility::Bytes tampered { ciphertext };
+        tampered[64] ^= 1;
+        CHECK(decrypt(wideCrt, tampered, scheme) != message);
+        CHECK(!decrypt(wideCrt, Utility::Bytes(127, 1), scheme) && !decrypt(wideCrt, Utility::Bytes(128, 0xff), scheme));
+        CHECK(!encrypt(wide.publicKey, Utility::Bytes(Padding::maxMessageLength(128, scheme) + 1), scheme));
+    }
+    // Two encryptions of a message differ, the padding is random
+    CHECK(encrypt(wide.publicKey, message) != encrypt(wide.publicKey, message));
+    CHECK(Padding::maxMessageLength(128, Padding::Scheme::OAEP) == 62 && Padding::maxMessageLength(64, Padding::Scheme::PKCS1) == 53);
+
+    const Utility::Bytes digest { Hash::sha256(message) };
+    const Utility::Bytes signature { Padding::Signature::PKCS1::encode(digest, 256).value_or(Utility::Bytes {}) };
+    CHECK(Padding::Signature::PKCS1::verify(digest, signature));
+    CHECK(!Padding::Signature::PKCS1::verify(Hash::sha256({}), signature));
+
+    const Utility::Bytes pss { Padding::Signature::PSS::encode(digest, 2047).value_or(Utility::Bytes {}) };
+    CHECK(Padding::Signature::PSS::verify(digest, pss, 2047));
+    CHECK(!Padding::Signature::PSS::verify(Hash::sha256({}), pss, 2047));
+    CHECK(pss != Padding::Signature::PSS::encode(digest, 2047));
+
+    // Moduli too short for the encoding (8 bytes and less are what this library's keys have) and digests of the wrong size
+    CHECK(Padding::Signature::PKCS1::encode(digest, 62) && !Padding::Signature::PKCS1::encode(digest, 61));
+    CHECK(!Padding::Signature::PKCS1::encode(digest, 8) && !Padding::Signature::PKCS1::encode(digest, 0));
+    CHECK(!Padding::Signature::PKCS1::encode(message, 256));
+    CHECK(Padding::Signature::PSS::encode(digest, 528) && !Padding::Signature::PSS::encode(digest, 520));
+    CHECK(!Padding::Signature::PSS::encode(digest, 63) && !Padding::Signature::PSS::encode(message, 2047));
+
+    // Signatures end to end with the wide key, both schemes
+    for (const Padding::Signature::Scheme scheme : { Padding::Signature::Scheme::PKCS1, Padding::Signature::Scheme::PSS }) {
+        const Utility::Bytes wideSignature { sign(wideCrt, digest, scheme).value_or(Utility::Bytes {}) };
+        CHECK(wideSignature.size() == 128);
+        CHECK(verify(wide.publicKey, digest, wideSignature, scheme));
+        CHECK(sign(wide.privateKey, digest, scheme) && verify(wide.publicKey, digest, *sign(wide.privateKey, digest, scheme), scheme));
+
+        // A flipped bit, another digest, the other scheme or a truncated wideSignature are all refused
+        Utility::Bytes tampered { wideSignature };
+        tampered[100] ^= 0x10;
+        CHECK(!verify(wide.publicKey, digest, tampered, scheme));
+        CHECK(!verify(wide.publicKey, Hash::sha256({}), wideSignature, scheme));
+        CHECK(!verify(wide.publicKey, digest, wideSignature, scheme == Padding::Signature::Scheme::PKCS1 ? Padding::Signature::Scheme::PSS : Padding::Signature::Scheme::PKCS1));
+        CHECK(!verify(wide.publicKey, digest, Utility::Bytes(wideSignature.begin() + 1, wideSignature.end()), scheme));
+        CHECK(!sign(wideCrt, message, scheme));
+
+        const std::vector<std::optional<Utility::Bytes>> signatures { signBatch(wide.privateKey, { digest, message, Hash::sha256({}) }, scheme) };
+        CHECK(signatures.size() == 3 && signatures[0] && !signatures[1] && signatures[2]);
+        const std::vector<Utility::Bytes> batchSignatures { signatures[0].value_or(Utility::Bytes {}), tampered, signatures[2].value_or(Utility::Bytes {}) };
+        CHECK((verifyBatch(wide.publicKey, { digest, digest, Hash::sha256({}) }, batchSignatures, scheme) == std::vector<bool> { true, false, true }));
+
+        const std::vector<std::optional<Utility::Bytes>> messageSignatures { signMessages(wide.privateKey, { message, {} }, scheme) };
+        CHECK(messageSignatures.size() == 2 && messageSignatures[0] && messageSignatures[1]);
+        const std::vector<Utility::Bytes> signedMessages { messageSignatures[0].value_or(Utility::Bytes {}), messageSignatures[1].value_or(Utility::Bytes {}) };
+        CHECK((verifyMessages(wide.publicKey, { message, {} }, signedMessages, scheme) == std::vector<bool> { true, true }));
+        CHECK((verifyMessages(wide.publicKey, { {}, message }, signedMessages, scheme) == std::vector<bool> { false, false }));
+    }
+    // PKCS1 signatures are deterministic, PSS ones carry a random salt
+    CHECK(sign(wideCrt, digest) == sign(wideCrt, digest));
+    CHECK(sign(wideCrt, digest, Padding::Signature::Scheme::PSS) != sign(wideCrt, digest, Padding::Signature::Scheme::PSS));
+
+    // The textbook key is far too short for either encoding
+    const Key::Wide::Private tiny { BigNum::Integer { 61 }, BigNum::Integer { 53 }, BigNum::Integer { 2753 } };
+    CHECK(!sign(tiny, digest) && !sign(tiny, digest, Padding::Signature::Scheme::PSS));
+    CHECK(Merkle::signBatch(wide.privateKey, {}) && Merkle::signBatch(wide.privateKey, {})->empty());
+    CHECK(!Merkle::verify(wide.publicKey, message, Merkle::Proof { Utility::Bytes(128), 0, 1, {} }));
+
+}
+
+void testMerkle() {
+    std::vector<Utility::Bytes> messages {};
+    for (unsigned char i { 0 }; i < 5; ++i)
+        messages.push_back(Utility::Bytes(i, i));
+
+    CHECK(Merkle::buildLevels({}).empty());
+    const std::vector<std::vector<Utility::Bytes>> single { Merkle::buildLevels({ messages[0] }) };
+    CHECK(single.size() == 1 && single[0].size() == 1 && single[0][0] == Merkle::leafHash(messages[0]));
+    CHECK(Merkle::authenticationPath(single, 0).empty());
+
+    // 5 leaves: 5 -> 3 -> 2 -> 1, the fifth leaf is moved up unchanged twice
+    const std::vector<std::vector<Utility::Bytes>> levels { Merkle::buildLevels(messages) };
+    CHECK(levels.size() == 4 && levels[0].size() == 5 && levels[1].size() == 3 && levels[2].size() == 2 && levels[3].size() == 1);
+    for (size_t i { 0 }; i < messages.size(); ++i)
+        CHECK(levels[0][i] == Merkle::leafHash(messages[i]));
+    CHECK(levels[1][0] == Merkle::nodeHash(levels[0][0], levels[0][1]) && levels[1][1] == Merkle::nodeHash(levels[0][2], levels[0][3]));
+    CHECK(levels[1][2] == levels[0][4] && levels[2][1] == levels[0][4]);
+    CHECK(levels[3][0] == Merkle::nodeHash(Merkle::nodeHash(levels[1][0], levels[1][1]), levels[0][4]));
+    // A leaf is never mistaken for the node of its two halves
+    CHECK(Merkle::leafHash(messages[1]) != Merkle::nodeHash(Utility::Bytes {}, messages[1]));
+
+    // Every path leads back to the root, the odd leaf's path only holds the one sibling it meets
+    CHECK((Merkle::authenticationPath(levels, 4) == std::vector<Utility::Bytes> { levels[2][0] }));
+    CHECK((Merkle::authenticationPath(levels, 2) == std::vector<Utility::Bytes> { levels[0][3], levels[1][0], levels[0][4] }));
+    for (size_t i { 0 }; i < messages.size(); ++i) {
+        const Merkle::Proof proof { {}, i, messages.size(), Merkle::authenticationPath(levels, i) };
+        CHECK(Merkle::rootFromPath(messages[i], proof) == levels.back().front());
+        CHECK(Merkle::rootFromPath(messages[(i + 1) % messages.size()], proof) != levels.back().front());
+    }
+
+    // Paths of the wrong length, out of range indices and swapped siblings
+    const std::vector<Utility::Bytes> path { Merkle::authenticationPath(levels, 1) };
+    CHECK(path.size() == 3);
+    CHECK(!Merkle::rootFromPath(messages[1], Merkle::Proof { {}, 1, 5, { path[0], path[1] } }));
+    CHECK(!Merkle::rootFromPath(messages[1], Merkle::Proof { {}, 1, 5, { path[0], path[1], path[2], path[2] } }));
+    CHECK(!Merkle::rootFromPath(messages[1], Merkle::Proof { {}, 5, 5, path }));
+    CHECK(Merkle::rootFromPath(messages[1], Merkle::Proof { {}, 0, 5, path }) != levels.back().front());
+
+    // The whole batch with one signature, for both schemes
+    const Generate::WideKeyPair& wide { wideKeys() };
+    for (const Padding::Signature::Scheme scheme : { Padding::Signature::Scheme::PKCS1, Padding::Signature::Scheme::PSS }) {
+        const std::vector<Merkle::Proof> proofs { Merkle::signBatch(wide.privateKey, messages, scheme).value_or(std::vector<Merkle::Proof> {}) };
+        CHECK(proofs.size() == messages.size());
+        for (size_t i { 0 }; i < proofs.size(); ++i) {
+            CHECK(proofs[i].index == i && proofs[i].leafCount == 5 && proofs[i].rootSignature == proofs[0].rootSignature);
+            CHECK(Merkle::verify(wide.publicKey, messages[i], proofs[i], scheme));
+            CHECK(!Merkle::verify(wide.publicKey, messages[(i + 1) % messages.size()], proofs[i], scheme));
+        }
+
+        // The signed root is bound to the leaf count, a path can't be replayed against a tree of another shape
+        Merkle::Proof reshaped { proofs[4] };
+        reshaped.leafCount = 6;
+        CHECK(!Merkle::verify(wide.publicKey, messages[4], reshaped, scheme));
+        Merkle::Proof tampered { proofs[2] };
+        tampered.rootSignature[50] ^= 1;
+        CHECK(!Merkle::verify(wide.publicKey, messages[2], tampered, scheme));
+    }
+
+    const std::vector<Merkle::Proof> alone { Merkle::signBatch(wide.privateKey, { messages[3] }).value_or(std::vector<Merkle::Proof> {}) };
+    CHECK(alone.size() == 1 && alone[0].path.empty() && Merkle::verify(wide.publicKey, messages[3], alone[0]));
+    const Key::Wide::Private tiny { BigNum::Integer { 61 }, BigNum::Integer { 53 }, BigNum::Integer { 2753 } };
+    CHECK(!Merkle::signBatch(tiny, messages));
+}
+
+void testCache() {
+    Cache::LRU<int> cache { 4, 1 };
+    const Cache::Id first { Cache::makeId(Utility::Bytes { 1 }) };
+    CHECK(!cache.find(first));
+    cache.insert(first, 10);
+    CHECK(cache.find(first) == 10);
+    CHECK(cache.statistics().hits == 1 && cache.statistics().misses == 1);
+
+    // Length prefixes keep ("ab", "c") and ("a", "bc") apart
+    CHECK(Cache::makeId(Utility::Bytes { 'a', 'b' }, Utility::Bytes { 'c' }) != Cache::makeId(Utility::Bytes { 'a' }, Utility::Bytes { 'b', 'c' }));
+
+    // Only 4 entries fit, the first one was used since the last sweep so it survives the next insertions
+    for (unsigned char i { 2 }; i <= 5; ++i)
+        cache.insert(Cache::makeId(Utility::Bytes { i }), i * 10);
+    CHECK(cache.find(first) == 10);
+
+    const Generate::WideKeyPair& pair { wideKeys() };
+    const Utility::Bytes digest { Hash::sha256({}) };
+    const Utility::Bytes signature { sign(pair.privateKey, digest).value_or(Utility::Bytes {}) };
+
+    // A miss signs and stores the signature
+    Cache::Signatures signatures { 16 };
+    const Cache::Id id { Cache::signatureId(pair.privateKey, digest, Padding::Signature::Scheme::PKCS1) };
+    CHECK(signCached(pair.privateKey, digest, signatures) == signature);
+    CHECK(signatures.statistics().hits == 0 && signatures.statistics().misses == 1);
+    CHECK(signatures.find(id) == signature);
+
+    // A hit hands out whatever is stored without signing: a planted value comes back as is
+    const Utility::Bytes planted { 1, 2, 3 };
+    const Utility::Bytes otherDigest { Hash::sha256(Utility::Bytes { 'x' }) };
+    signatures.insert(Cache::signatureId(pair.privateKey, otherDigest, Padding::Signature::Scheme::PKCS1), planted);
+    CHECK(signCached(pair.privateKey, otherDigest, signatures) == planted);
+    CHECK(signatures.statistics().hits == 2 && signatures.statistics().misses == 1);
+
+    // Another key misses and a failed signature isn't stored. PSS signatures are randomized, the cache isn't even looked at for them
+    const Key::Wide::Private tiny { BigNum::Integer { 61 }, BigNum::Integer { 53 }, BigNum::Integer { 2753 } };
+    CHECK(!signCached(tiny, digest, signatures) && !signCached(tiny, digest, signatures));
+    CHECK(!signatures.find(Cache::signatureId(tiny, digest, Padding::Signature::Scheme::PKCS1)));
+    CHECK(signCached(pair.privateKey, digest, signatures, Padding::Signature::Scheme::PSS) != signature);
+    CHECK(signatures.statistics().hits == 2 && signatures.statistics().misses == 4);
+
+    Cache::Verifications verifications { 16 };
+    CHECK(verifyCached(pair.publicKey, digest, signature, verifications) && verifyCached(pair.publicKey, digest, signature, verifications));
+    CHECK(!verifyCached(pair.publicKey, digest, Utility::Bytes(5), verifications) && !verifyCached(pair.publicKey, digest, Utility::Bytes(5), verifications));
+    CHECK(verifications.statistics().hits == 2 && verifications.statistics().misses == 2);
+}
+
+void testHybrid() {
+    const KeyPair pair { makeKeys(1000003, 1000033) };
+
+    std::string plaintext(10000, '\0');
+    std::mt19937_64 random { 5 };
+    for (char& byte : plaintext)
+        byte = static_cast<char>(random());
+
+    std::stringstream encrypted {};
+    {
+        std::istringstream in { plaintext };
+        CHECK(Hybrid::encrypt(pair.publicKey, in, encrypted, 1000));
+    }
+
+    std::ostringstream decrypted {};
+    CHECK(Hybrid::decrypt(pair.publicKey, pair.privateKey, encrypted, decrypted));
+    CHECK(decrypted.str() == plaintext);
+
+    std::string tampered { encrypted.str() };
+    tampered[tampered.size() / 2] ^= 1;
+    std::istringstream tamperedIn { tampered };
+    std::ostringstream ignored {};
+    CHECK(!Hybrid::decrypt(pair.publicKey, pair.privateKey, tamperedIn, ignored));
+
+    // Dropping the last segment is noticed, the one before it wasn't sealed as the last
+    std::istringstream truncated { encrypted.str().substr(0, encrypted.str().size() - 1000 - 16) };
+    CHECK(!Hybrid::decrypt(pair.publicKey, pair.privateKey, truncated, ignored));
+
+    // Segment sizes above the cap are refused on both sides, before anything is allocated for them
+    std::ostringstream refused {};
+    std::istringstream empty {};
+    CHECK(!Hybrid::encrypt(pair.publicKey, empty, refused, 0) && !Hybrid::encrypt(pair.publicKey, empty, refused, Hybrid::maxSegmentSize + 1));
+    std::string oversized { encrypted.str() };
+    const size_t segmentSizeOffset { 6 + Utility::Convert::byteLength(pair.publicKey.n) };
+    oversized.replace(segmentSizeOffset, 4, "\xff\xff\xff\xff");
+    std::istringstream oversizedIn { oversized };
+    CHECK(!Hybrid::decrypt(pair.publicKey, pair.privateKey, oversizedIn, ignored));
+
+    // A failed output stream stops decryption at the first segment
+    std::istringstream encryptedIn { encrypted.str() };
+    std::ostringstream broken {};
+    broken.setstate(std::ios::badbit);
+    CHECK(!Hybrid::decrypt(pair.publicKey, pair.privateKey, encryptedIn, broken));
+}
+
+void testConcurrency() {
+    Concurrency::Queue<int> queue { 3 };
+    int value { 1 };
+    size_t enqueued { 0 };
+    while (queue.tryEnqueue(value))
+        value = static_cast<int>(++enqueued) + 1;
+    CHECK(enqueued == 4);
+    CHECK(queue.tryDequeue(value) && value == 1);
+    CHECK(!queue.isEmpty());
+
+    CHECK((Concurrency::Topology::parseList("0-3,8,10-11") == std::vector<int> { 0, 1, 2, 3, 8, 10, 11 }));
+    CHECK(Concurrency::Topology::nodeCount() >= 1);
+
+    Concurrency::WorkerPool pool { 3, 64 };
+    std::vector<int> squares(1000);
+    pool.parallelFor(squares.size(), [&](size_t i) { squares[i] = static_cast<int>(i * i); });
+    pool.parallelFor(squares.size(), [&](size_t i) { squares[i] -= static_cast<int>(i * i); }, Concurrency::Priority::Bulk);
+    CHECK(squares == std::vector<int>(1000, 0));
+
+    std::atomic<int> ran { 0 };
+    for (int i { 0 }; i < 100; ++i)
+        pool.submit([&ran] { ran.fetch_add(1); });
+    pool.parallelFor(1, [](size_t) {});
+    while (ran.load() < 100)
+        std::this_thread::yield();
+    CHECK(ran.load() == 100);
+
+    Concurrency::NodeLocal<std::vector<int>> local { std::vector<int> { 1, 2, 3 } };
+    CHECK((local.local() == std::vector<int> { 1, 2, 3 }));
+
+    // Pinning can only be chosen before the shared pool starts its threads
+    CHECK(Concurrency::defaultPool().size() >= 1 && !Concurrency::pinDefaultPool());
+}
+
+namespace {
+    Async::Task<long long int> roundTrip(Async::Batcher& batcher, const KeyPair& pair, const Key::CRT& crtKey, long long int m) {
+        const long long int c { co_await Async::asyncEncode(pair.publicKey, m, batcher) };
+        co_return co_await Async::asyncDecode(crtKey, c, batcher);
+    }
+
+    Async::Task<std::optional<Utility::Bytes>> signOn(Async::Batcher& batcher, const Key::Wide::CRT& crtKey, const Utility::Bytes& digest) {
+        co_return co_await Async::asyncSign(crtKey, digest, Padding::Signature::Scheme::PKCS1, batcher);
+    }
+
+    Async::Task<long long int> failing(Async::Batcher& batcher, const KeyPair& pair) {
+        co_await Async::asyncEncode(pair.publicKey, 2, batcher);
+        throw std::runtime_error { "failed after resuming on the pool" };
+    }
+}
+
+void testAsync() {
+    const KeyPair pair { makeKeys(1000003, 1000033) };
+    const Key::CRT crtKey { Generate::crt(pair.privateKey).value() };
+    Concurrency::WorkerPool pool { 3, 64 };
+    Async::Batcher batcher { pool, 8 };
+
+    std::vector<Async::Task<long long int>> tasks {};
+    for (long long int m { 0 }; m < 100; ++m)
+        tasks.push_back(roundTrip(batcher, pair, crtKey, m * 7919));
+    const std::vector<long long int> results { Async::waitAll(std::move(tasks)) };
+    bool isConsistent { results.size() == 100 };
+    for (size_t i { 0 }; isConsistent && i < results.size(); ++i)
+        isConsistent = results[i] == static_cast<long long int>(i) * 7919;
+    CHECK(isConsistent);
+
+    // Signatures awaited together run in batches on the pool and match sign(), a modulus too short for the encoding gives nothing
+    const Key::Wide::CRT wideCrt { Generate::crt(wideKeys().privateKey).value() };
+    std::vector<Utility::Bytes> digests {};
+    for (unsigned char i { 0 }; i < 40; ++i)
+        digests.push_back(Hash::sha256(Utility::Bytes { i }));
+
+    Async::Batcher signer { pool, 8 };
+    std::vector<Async::Task<std::optional<Utility::Bytes>>> signing {};
+    for (const Utility::Bytes& digest : digests)
+        signing.push_back(signOn(signer, wideCrt, digest));
+    const std::vector<std::optional<Utility::Bytes>> signatures { Async::waitAll(std::move(signing)) };
+    bool isSigned { signatures.size() == digests.size() };
+    for (size_t i { 0 }; isSigned && i < signatures.size(); ++i)
+        isSigned = signatures[i] == sign(wideCrt, digests[i]) && verify(wideKeys().publicKey, digests[i], *signatures[i]);
+    CHECK(isSigned);
+    CHECK(signer.statistics().operations == digests.size() && signer.statistics().batches < digests.size());
+
+    const Key::Wide::CRT tiny { Generate::crt(Key::Wide::Private { BigNum::Integer { 61 }, BigNum::Integer { 53 }, BigNum::Integer { 2753 } }).value() };
+    CHECK(!Async::wait(signOn(signer, tiny, digests[0])));
+    CHECK(signer.statistics().operations == digests.size() + 1);
+
+    // An exception thrown after resuming on a pool thread reaches the waiting thread instead of ending the process
+    bool isThrown { false };
+    try {
+        Async::wait(failing(batcher, pair));
+    }
+    catch (const std::runtime_error&) {
+        isThrown = true;
+    }
+    CHECK(isThrown);
+}
+
+void testKeyStore() {
+    const KeyPair first { makeKeys(1021, 1019) };
+    const KeyPair second { makeKeys(1000003, 1000033) };
+
+    CHECK(!KeyStore::Store::create(first.publicKey, Key::Private { 1021, 1021, 1 }));
+    const std::unique_ptr<KeyStore::Store> created { KeyStore::Store::create(first.publicKey, first.privateKey) };
+    CHECK(created != nullptr);
+    if (!created)
+        return;
+
+    KeyStore::Store& store { *created };
+    CHECK(store.decode(store.encode(1234)) == 1234);
+    {
+        const KeyStore::Store::Reader old { store.read() };
+        CHECK(old->version == 1);
+        CHECK(store.publish(second.publicKey, second.privateKey) == 2);
+        CHECK(!store.publish(second.publicKey, Key::Private { 0, 1000033, 1 }));
+
+        // The old key set is kept for the reader that still holds it
+        CHECK(old->publicKey.n == first.publicKey.n);
+        CHECK(store.read()->publicKey.n == second.publicKey.n);
+        CHECK(store.reclaim() == 1);
+    }
+    CHECK(store.reclaim() == 0);
+    CHECK(store.decode(store.encode(999999)) == 999999);
+
+    CHECK(!store.reload((scratchDirectory() / "missing.txt").string(), (scratchDirectory() / "missing.txt").string()));
+    CHECK(store.read()->version == 2);
+}
+
+void testIPC() {
+#if defined(__linux__)
+    const KeyPair pair { makeKeys(1000003, 1000033) };
+    const std::string name { "/rsa-tests-" + std::to_string(getpid()) };
+
+    std::optional<IPC::Client> client { IPC::Client::create(name) };
+    CHECK(client.has_value());
+    if (!client)
+        return;
+
+    bool isServed { false };
+    std::thread server { [&] { isServed = IPC::serve(name, pair.publicKey, pair.privateKey); } };
+
+    std::vector<long long int> values(1000);
+    for (size_t i { 0 }; i < values.size(); ++i)
+        values[i] = static_cast<long long int>(i * 997);
+    values.push_back(pair.publicKey.n);
+
+    const std::optional<std::vector<std::optional<long long int>>> encoded { client->run(IPC::Operation::Encode, values) };
+    CHECK(encoded && encoded->size() == values.size() && !encoded->back());
+    CHECK(encoded && encoded->front() == encode(pair.publicKey, values.front()));
+    if (encoded && (*encoded)[1])
+        CHECK(client->decode(*(*encoded)[1]) == values[1]);
+
+    const std::optional<std::vector<std::optional<long long int>>> unknown { client->run(static_cast<IPC::Operation>(7), { 1 }) };
+    CHECK(unknown && unknown->size() == 1 && !unknown->front());
+
+    client.reset();
+    server.join();
+    CHECK(isServed);
+#endif
+}
+
+int main() {
+    testMath();
+    testBigNum();
+    testEncodeDecode();
+    testTable();
+    testFiles();
+    testTuning();
+    testContainer();
+    testFilter();
+    testRotation();
+    testCInterface();
+    testRandom();
+    testSeededKeys();
+    testPrimeKinds();
+    testHash();
+    testPadding();
+    testMerkle();
+    testCache();
+    testHybrid();
+    testConcurrency();
+    testAsync();
+    testKeyStore();
+    testIPC();
+
+    std::filesystem::remove_all(scratchDirectory());
+
+    if (failures == 0)
+        std::cout << "All tests passed\n";
+    return failures;
+}